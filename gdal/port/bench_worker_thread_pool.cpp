@@ -0,0 +1,160 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Microbenchmark of CPLWorkerThreadPool job throughput.
+ *
+ **********************************************************************
+ * Copyright (c) 2021, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+// Measures the number of jobs per second that CPLWorkerThreadPool can run,
+// for 1 to 64 worker threads, with jobs submitted one at a time with
+// SubmitJob(), as a batch with SubmitJobs(), and from within running jobs.
+//
+// Usage: bench_worker_thread_pool [-jobs N] [-work N] [-max_threads N]
+//
+// -work is the number of loop iterations done by each job: 0 measures the
+// pure scheduling overhead.
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+CPL_CVSID("$Id$")
+
+namespace
+{
+int nWorkPerJob = 0;
+std::atomic<int> nJobsDone{0};
+
+struct NestedJob
+{
+    CPLWorkerThreadPool* poPool;
+    int                  nChildren;
+};
+
+void JobFunc( void* /* pData */ )
+{
+    volatile unsigned nAcc = 0;
+    for( int i = 0; i < nWorkPerJob; i++ )
+        nAcc = nAcc * 31 + static_cast<unsigned>(i);
+    nJobsDone++;
+}
+
+void NestedJobFunc( void* pData )
+{
+    const NestedJob* psJob = static_cast<const NestedJob*>(pData);
+    for( int i = 0; i < psJob->nChildren; i++ )
+        psJob->poPool->SubmitJob(JobFunc, nullptr);
+    nJobsDone++;
+}
+
+double Now()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Usage()
+{
+    printf("Usage: bench_worker_thread_pool [-jobs N] [-work N] "
+           "[-max_threads N]\n");
+    exit(1);
+}
+} // namespace
+
+int main( int argc, char **argv )
+
+{
+    int nJobs = 1000000;
+    int nMaxThreads = 64;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-jobs") && i + 1 < argc )
+            nJobs = std::max(1, atoi(argv[++i]));
+        else if( EQUAL(argv[i], "-work") && i + 1 < argc )
+            nWorkPerJob = std::max(0, atoi(argv[++i]));
+        else if( EQUAL(argv[i], "-max_threads") && i + 1 < argc )
+            nMaxThreads = std::max(1, atoi(argv[++i]));
+        else
+            Usage();
+    }
+
+    printf("%d jobs of %d iterations each\n", nJobs, nWorkPerJob);
+    printf("threads  SubmitJob (jobs/s)  SubmitJobs (jobs/s)  "
+           "nested (jobs/s)\n");
+
+    const std::vector<void*> apData(static_cast<size_t>(nJobs), nullptr);
+    for( int nThreads = 1; nThreads <= nMaxThreads; nThreads *= 2 )
+    {
+        CPLWorkerThreadPool oPool;
+        if( !oPool.Setup(nThreads, nullptr, nullptr) )
+        {
+            fprintf(stderr, "Cannot create pool of %d threads\n", nThreads);
+            return 1;
+        }
+
+        nJobsDone = 0;
+        double dfStart = Now();
+        for( int i = 0; i < nJobs; i++ )
+            oPool.SubmitJob(JobFunc, nullptr);
+        oPool.WaitCompletion();
+        const double dfSubmitJob = nJobs / (Now() - dfStart);
+
+        dfStart = Now();
+        oPool.SubmitJobs(JobFunc, apData);
+        oPool.WaitCompletion();
+        const double dfSubmitJobs = nJobs / (Now() - dfStart);
+
+        // Each top-level job submits its children from a worker thread.
+        constexpr int knChildren = 99;
+        const int nTopLevelJobs = std::max(1, nJobs / (knChildren + 1));
+        NestedJob sNestedJob;
+        sNestedJob.poPool = &oPool;
+        sNestedJob.nChildren = knChildren;
+        dfStart = Now();
+        for( int i = 0; i < nTopLevelJobs; i++ )
+            oPool.SubmitJob(NestedJobFunc, &sNestedJob);
+        oPool.WaitCompletion();
+        const double dfNested =
+            nTopLevelJobs * (knChildren + 1) / (Now() - dfStart);
+
+        const int nExpected = 2 * nJobs + nTopLevelJobs * (knChildren + 1);
+        if( nJobsDone != nExpected )
+        {
+            fprintf(stderr, "%d jobs run instead of %d\n",
+                    nJobsDone.load(), nExpected);
+            return 1;
+        }
+
+        printf("%7d  %18.0f  %19.0f  %15.0f\n",
+               nThreads, dfSubmitJob, dfSubmitJobs, dfNested);
+    }
+
+    return 0;
+}
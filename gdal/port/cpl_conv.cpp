@@ -54,6 +54,7 @@
 #include "cpl_conv.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
 #include <climits>
@@ -69,10 +70,12 @@
 #include <unistd.h>
 #endif
 
+#include <memory>
 #ifdef DEBUG_CONFIG_OPTIONS
 #include <set>
 #endif
 #include <string>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_multiproc.h"
@@ -83,6 +86,21 @@
 #ifdef DEBUG
 #define OGRAPISPY_ENABLED
 #endif
+
+// Used to detect modifications of the environment
+#if !defined(_WIN32)
+    #define CPL_CONFIG_HAS_ENVIRON
+    #ifdef __APPLE__
+        #include <TargetConditionals.h>
+    #endif
+    #if defined(__APPLE__) && (!defined(TARGET_OS_IPHONE) || TARGET_OS_IPHONE==0)
+        #include <crt_externs.h>
+        #define environ (*_NSGetEnviron())
+    #else
+        extern char** environ;
+    #endif
+#endif
+
 #ifdef OGRAPISPY_ENABLED
 // Keep in sync with ograpispy.cpp
 void OGRAPISPYCPLSetConfigOption(const char*, const char*);
@@ -1654,6 +1672,470 @@ static void CPLAccessConfigOption( const char *pszKey, bool bGet )
 }
 #endif
 
+/************************************************************************/
+/*                       CPLConfigOptionsSnapshot                       */
+/************************************************************************/
+
+// CPLGetConfigOption() is called in hot paths from many threads, so the
+// options set with CPLSetConfigOption() are read from an immutable
+// snapshot that is replaced, under hConfigMutex, on each modification.
+// Readers do not lock: they only register in a reader stripe, under the
+// current reader epoch. Publishing a snapshot switches the epoch, and the
+// replaced snapshot is freed once the readers registered under the
+// previous epoch have left. Readers arriving meanwhile use the new epoch,
+// so they cannot delay the writer.
+//
+// Entries are shared between successive snapshots, so that the value
+// returned for a key remains valid until that key is modified, as with
+// the previous CSL based implementation.
+//
+// The snapshot also records keys that were found neither in the options
+// nor in the environment, to avoid getenv() calls. Those entries are
+// ignored as soon as the environment looks modified.
+
+namespace {
+
+struct CPLConfigOptionEntry
+{
+    size_t nHash = 0;
+    CPLString osKey{};
+    CPLString osValue{};
+    bool bIsSet = true;  // false if absent from the environment
+};
+
+struct CPLConfigOptionsSnapshot
+{
+    std::vector<std::shared_ptr<const CPLConfigOptionEntry>> apoEntries{};
+    std::vector<int> anBuckets{};  // indices in apoEntries, or -1
+    size_t nAbsentEntries = 0;
+
+#ifdef CPL_CONFIG_HAS_ENVIRON
+    // State of the environment when the absent entries were checked
+    char **papszEnviron = nullptr;
+    size_t nEnvironCount = 0;
+    const char *pszEnvironLast = nullptr;
+#endif
+
+    int FindIndex( const char *pszKey, size_t nHash ) const;
+    const CPLConfigOptionEntry *Find( const char *pszKey,
+                                      size_t nHash ) const;
+    void Insert( const std::shared_ptr<const CPLConfigOptionEntry>& poEntry );
+    void Rehash( size_t nSize );
+    void SaveEnvironState();
+    bool IsEnvironUnchanged() const;
+};
+
+struct alignas(64) CPLConfigReaderStripe
+{
+    // Indexed by the parity of the reader epoch
+    std::atomic<int> anReaders[2] = {{0}, {0}};
+};
+
+}  // namespace
+
+// Maximum number of keys remembered as absent from the environment
+constexpr size_t MAX_CONFIG_ABSENT_ENTRIES = 1024;
+
+constexpr size_t CONFIG_READER_STRIPES = 64;
+
+static std::atomic<const CPLConfigOptionsSnapshot*>
+                                        g_poConfigSnapshot{nullptr};
+static CPLConfigReaderStripe g_asConfigReaders[CONFIG_READER_STRIPES];
+static std::atomic<unsigned> g_nConfigReaderEpoch{0};
+
+/************************************************************************/
+/*                       CPLConfigOptionHash()                          */
+/************************************************************************/
+
+// Case insensitive, consistently with EQUAL() used for key comparison.
+static size_t CPLConfigOptionHash( const char *pszKey )
+{
+    size_t nHash = 5381;
+    for( ; *pszKey; ++pszKey )
+    {
+        unsigned char ch = static_cast<unsigned char>(*pszKey);
+        if( ch >= 'a' && ch <= 'z' )
+            ch = static_cast<unsigned char>(ch - 'a' + 'A');
+        nHash = nHash * 33 + ch;
+    }
+    return nHash;
+}
+
+/************************************************************************/
+/*                CPLConfigOptionsSnapshot::FindIndex()                 */
+/************************************************************************/
+
+int CPLConfigOptionsSnapshot::FindIndex( const char *pszKey,
+                                         size_t nHash ) const
+{
+    if( anBuckets.empty() )
+        return -1;
+    const size_t nMask = anBuckets.size() - 1;
+    for( size_t i = nHash & nMask; ; i = (i + 1) & nMask )
+    {
+        const int nIdx = anBuckets[i];
+        if( nIdx < 0 )
+            return -1;
+        const CPLConfigOptionEntry *psEntry = apoEntries[nIdx].get();
+        if( psEntry->nHash == nHash && EQUAL(psEntry->osKey, pszKey) )
+            return nIdx;
+    }
+}
+
+/************************************************************************/
+/*                   CPLConfigOptionsSnapshot::Find()                   */
+/************************************************************************/
+
+const CPLConfigOptionEntry *
+CPLConfigOptionsSnapshot::Find( const char *pszKey, size_t nHash ) const
+{
+    const int nIdx = FindIndex(pszKey, nHash);
+    return nIdx < 0 ? nullptr : apoEntries[nIdx].get();
+}
+
+/************************************************************************/
+/*                  CPLConfigOptionsSnapshot::Insert()                  */
+/************************************************************************/
+
+// The key must not be already present.
+void CPLConfigOptionsSnapshot::Insert(
+                const std::shared_ptr<const CPLConfigOptionEntry>& poEntry )
+{
+    apoEntries.push_back(poEntry);
+    if( !poEntry->bIsSet )
+        nAbsentEntries++;
+
+    // Keep the load factor below 1/2
+    if( 2 * apoEntries.size() > anBuckets.size() )
+    {
+        Rehash(std::max(static_cast<size_t>(16), 2 * anBuckets.size()));
+        return;
+    }
+    const size_t nMask = anBuckets.size() - 1;
+    size_t i = poEntry->nHash & nMask;
+    while( anBuckets[i] >= 0 )
+        i = (i + 1) & nMask;
+    anBuckets[i] = static_cast<int>(apoEntries.size() - 1);
+}
+
+/************************************************************************/
+/*                  CPLConfigOptionsSnapshot::Rehash()                  */
+/************************************************************************/
+
+void CPLConfigOptionsSnapshot::Rehash( size_t nSize )
+{
+    anBuckets.assign(nSize, -1);
+    const size_t nMask = nSize - 1;
+    for( size_t iEntry = 0; iEntry < apoEntries.size(); iEntry++ )
+    {
+        size_t i = apoEntries[iEntry]->nHash & nMask;
+        while( anBuckets[i] >= 0 )
+            i = (i + 1) & nMask;
+        anBuckets[i] = static_cast<int>(iEntry);
+    }
+}
+
+/************************************************************************/
+/*            CPLConfigOptionsSnapshot::SaveEnvironState()              */
+/************************************************************************/
+
+void CPLConfigOptionsSnapshot::SaveEnvironState()
+{
+#ifdef CPL_CONFIG_HAS_ENVIRON
+    papszEnviron = environ;
+    nEnvironCount = 0;
+    pszEnvironLast = nullptr;
+    if( papszEnviron != nullptr )
+    {
+        while( papszEnviron[nEnvironCount] != nullptr )
+            nEnvironCount++;
+        if( nEnvironCount > 0 )
+            pszEnvironLast = papszEnviron[nEnvironCount - 1];
+    }
+#endif
+}
+
+/************************************************************************/
+/*           CPLConfigOptionsSnapshot::IsEnvironUnchanged()             */
+/************************************************************************/
+
+// Cheap check that no variable was added to the environment since
+// SaveEnvironState(): setenv() and putenv() either reallocate the array
+// or append the new variable at its end.
+bool CPLConfigOptionsSnapshot::IsEnvironUnchanged() const
+{
+#ifdef CPL_CONFIG_HAS_ENVIRON
+    char **papszCurEnviron = environ;
+    if( papszCurEnviron != papszEnviron )
+        return false;
+    if( papszCurEnviron == nullptr )
+        return true;
+    return papszCurEnviron[nEnvironCount] == nullptr &&
+           (nEnvironCount == 0 ||
+            papszCurEnviron[nEnvironCount - 1] == pszEnvironLast);
+#else
+    return false;
+#endif
+}
+
+/************************************************************************/
+/*                       CPLConfigReaderGuard                           */
+/************************************************************************/
+
+namespace {
+
+class CPLConfigReaderGuard
+{
+    std::atomic<int> *m_pnReaders = nullptr;
+
+    static CPLConfigReaderStripe &GetStripe()
+    {
+        const GUIntBig nPID = static_cast<GUIntBig>(CPLGetPID());
+        return g_asConfigReaders[
+            static_cast<size_t>((nPID * 0x9E3779B97F4A7C15ULL) >> 58) %
+                CONFIG_READER_STRIPES];
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(CPLConfigReaderGuard)
+
+  public:
+    CPLConfigReaderGuard()
+    {
+        // Register under the current epoch, and check that it is still
+        // current once registered, as a publisher that has moved past it
+        // no longer waits for its readers.
+        CPLConfigReaderStripe &sStripe = GetStripe();
+        while( true )
+        {
+            const unsigned nEpoch = g_nConfigReaderEpoch.load();
+            m_pnReaders = &sStripe.anReaders[nEpoch & 1];
+            ++(*m_pnReaders);
+            if( g_nConfigReaderEpoch.load() == nEpoch )
+                break;
+            --(*m_pnReaders);
+        }
+    }
+
+    ~CPLConfigReaderGuard()
+    {
+        m_pnReaders->fetch_sub(1, std::memory_order_release);
+    }
+};
+
+}  // namespace
+
+/************************************************************************/
+/*                    CPLPublishConfigSnapshot()                        */
+/************************************************************************/
+
+// Must be called with hConfigMutex held.
+static void CPLPublishConfigSnapshot( const CPLConfigOptionsSnapshot *poNew )
+{
+    const CPLConfigOptionsSnapshot *poOld = g_poConfigSnapshot.exchange(poNew);
+    if( poOld == nullptr )
+        return;
+
+    // Only readers registered under the previous epoch might still use
+    // the old snapshot: the guard only keeps a registration made under
+    // the current epoch, so a reader registering after the epoch change
+    // loads the new snapshot. Wait for the others to leave. This is bounded by
+    // the duration of a lookup, as new readers use the new epoch.
+    const unsigned nOldParity = g_nConfigReaderEpoch.fetch_add(1) & 1;
+    for( auto& sStripe: g_asConfigReaders )
+    {
+        while( sStripe.anReaders[nOldParity].load() != 0 )
+            CPLSleep(0);
+    }
+    delete poOld;
+}
+
+/************************************************************************/
+/*                     CPLUpdateConfigSnapshot()                        */
+/************************************************************************/
+
+// Build a new snapshot from g_papszConfigOptions. Must be called with
+// hConfigMutex held.
+static void CPLUpdateConfigSnapshot()
+{
+    const CPLConfigOptionsSnapshot *poOld = g_poConfigSnapshot.load();
+    std::unique_ptr<CPLConfigOptionsSnapshot> poNew;
+    try
+    {
+        poNew.reset(new CPLConfigOptionsSnapshot());
+        char **papszOptions = const_cast<char **>(g_papszConfigOptions);
+        for( int i = 0; papszOptions && papszOptions[i]; i++ )
+        {
+            char *pszKey = nullptr;
+            const char *pszValue = CPLParseNameValue(papszOptions[i], &pszKey);
+            if( pszKey == nullptr || pszValue == nullptr )
+            {
+                CPLFree(pszKey);
+                continue;
+            }
+            const size_t nHash = CPLConfigOptionHash(pszKey);
+            // Only the first occurrence is visible, as with
+            // CSLFetchNameValue()
+            if( poNew->FindIndex(pszKey, nHash) >= 0 )
+            {
+                CPLFree(pszKey);
+                continue;
+            }
+
+            // Reuse the entry of the previous snapshot if the value did not
+            // change, so that pointers to it remain valid.
+            const int nOldIdx = poOld ? poOld->FindIndex(pszKey, nHash) : -1;
+            if( nOldIdx >= 0 && poOld->apoEntries[nOldIdx]->bIsSet &&
+                poOld->apoEntries[nOldIdx]->osValue == pszValue )
+            {
+                poNew->Insert(poOld->apoEntries[nOldIdx]);
+            }
+            else
+            {
+                auto poEntry = std::make_shared<CPLConfigOptionEntry>();
+                poEntry->nHash = nHash;
+                poEntry->osKey = pszKey;
+                poEntry->osValue = pszValue;
+                poNew->Insert(poEntry);
+            }
+            CPLFree(pszKey);
+        }
+
+        // Keep entries absent from the environment, unless the environment
+        // changed or they are now set.
+        const bool bKeepAbsent = poOld && poOld->IsEnvironUnchanged();
+        poNew->SaveEnvironState();
+        if( bKeepAbsent )
+        {
+            for( const auto& poEntry: poOld->apoEntries )
+            {
+                if( !poEntry->bIsSet &&
+                    poNew->FindIndex(poEntry->osKey, poEntry->nHash) < 0 )
+                {
+                    poNew->Insert(poEntry);
+                }
+            }
+        }
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Fatal, CPLE_OutOfMemory,
+                 "Cannot update configuration options");
+        return;
+    }
+
+    CPLPublishConfigSnapshot(poNew.release());
+}
+
+/************************************************************************/
+/*                    CPLCanRecordAbsentConfigOption()                  */
+/************************************************************************/
+
+// Whether a key absent from the options and the environment would be added
+// to poSnapshot by CPLRecordAbsentConfigOption().
+static bool CPLCanRecordAbsentConfigOption(
+                                const CPLConfigOptionsSnapshot *poSnapshot )
+{
+    return poSnapshot == nullptr ||
+           poSnapshot->nAbsentEntries < MAX_CONFIG_ABSENT_ENTRIES ||
+           !poSnapshot->IsEnvironUnchanged();
+}
+
+/************************************************************************/
+/*                    CPLRecordAbsentConfigOption()                     */
+/************************************************************************/
+
+// Publish a copy of the current snapshot in which pszKey is recorded as
+// absent from the environment. Unlike CPLUpdateConfigSnapshot(), the
+// options are not parsed again. Must be called with hConfigMutex held.
+static void CPLRecordAbsentConfigOption( const char *pszKey, size_t nHash )
+{
+    const CPLConfigOptionsSnapshot *poOld = g_poConfigSnapshot.load();
+    // Another thread may have set the key, recorded it, or reached the
+    // limit.
+    if( !CPLCanRecordAbsentConfigOption(poOld) )
+        return;
+    if( poOld != nullptr )
+    {
+        const CPLConfigOptionEntry *psEntry = poOld->Find(pszKey, nHash);
+        if( psEntry != nullptr &&
+            (psEntry->bIsSet || poOld->IsEnvironUnchanged()) )
+        {
+            return;
+        }
+    }
+
+    std::unique_ptr<CPLConfigOptionsSnapshot> poNew;
+    try
+    {
+        poNew.reset(new CPLConfigOptionsSnapshot());
+        if( poOld != nullptr )
+        {
+            // Absent entries are only valid for the environment they were
+            // checked against. This also drops a stale entry for pszKey.
+            const bool bKeepAbsent = poOld->IsEnvironUnchanged();
+            for( const auto& poEntry: poOld->apoEntries )
+            {
+                if( poEntry->bIsSet || bKeepAbsent )
+                    poNew->Insert(poEntry);
+            }
+        }
+        poNew->SaveEnvironState();
+
+        auto poEntry = std::make_shared<CPLConfigOptionEntry>();
+        poEntry->nHash = nHash;
+        poEntry->osKey = pszKey;
+        poEntry->bIsSet = false;
+        poNew->Insert(poEntry);
+    }
+    catch( const std::bad_alloc& )
+    {
+        // Not caching the key is harmless.
+        return;
+    }
+
+    CPLPublishConfigSnapshot(poNew.release());
+}
+
+/************************************************************************/
+/*                       CPLFindGlobalConfigOption()                    */
+/************************************************************************/
+
+// Look up an option set with CPLSetConfigOption(), and if it is not set,
+// in the environment.
+static const char *CPLFindGlobalConfigOption( const char *pszKey )
+{
+    const size_t nHash = CPLConfigOptionHash(pszKey);
+    bool bCanRecordAbsent;
+    {
+        CPLConfigReaderGuard oGuard;
+        const CPLConfigOptionsSnapshot *poSnapshot = g_poConfigSnapshot.load();
+        const CPLConfigOptionEntry *psEntry =
+            poSnapshot ? poSnapshot->Find(pszKey, nHash) : nullptr;
+        if( psEntry != nullptr )
+        {
+            // The entry remains referenced by newer snapshots until the key
+            // is modified.
+            if( psEntry->bIsSet )
+                return psEntry->osValue.c_str();
+            if( poSnapshot->IsEnvironUnchanged() )
+                return nullptr;
+        }
+        bCanRecordAbsent = CPLCanRecordAbsentConfigOption(poSnapshot);
+    }
+
+    const char *pszResult = getenv(pszKey);
+#ifdef CPL_CONFIG_HAS_ENVIRON
+    if( pszResult == nullptr && bCanRecordAbsent )
+    {
+        CPLMutexHolderD(&hConfigMutex);
+        CPLRecordAbsentConfigOption(pszKey, nHash);
+    }
+#else
+    CPL_IGNORE_RET_VAL(bCanRecordAbsent);
+#endif
+    return pszResult;
+}
+
 /************************************************************************/
 /*                         CPLGetConfigOption()                         */
 /************************************************************************/
@@ -1708,15 +2190,7 @@ CPLGetConfigOption( const char *pszKey, const char *pszDefault )
         pszResult = CSLFetchNameValue(papszTLConfigOptions, pszKey);
 
     if( pszResult == nullptr )
-    {
-        CPLMutexHolderD(&hConfigMutex);
-
-        pszResult =
-            CSLFetchNameValue(const_cast<char **>(g_papszConfigOptions), pszKey);
-    }
-
-    if( pszResult == nullptr )
-        pszResult = getenv(pszKey);
+        pszResult = CPLFindGlobalConfigOption(pszKey);
 
     if( pszResult == nullptr )
         return pszDefault;
@@ -1771,6 +2245,7 @@ void CPLSetConfigOptions(const char* const * papszConfigOptions)
     CSLDestroy(const_cast<char**>(g_papszConfigOptions));
     g_papszConfigOptions = const_cast<volatile char**>(
             CSLDuplicate(const_cast<char**>(papszConfigOptions)));
+    CPLUpdateConfigSnapshot();
 }
 
 /************************************************************************/
@@ -1861,6 +2336,7 @@ CPLSetConfigOption( const char *pszKey, const char *pszValue )
     g_papszConfigOptions = const_cast<volatile char **>(
         CSLSetNameValue(
             const_cast<char **>(g_papszConfigOptions), pszKey, pszValue));
+    CPLUpdateConfigSnapshot();
 }
 
 /************************************************************************/
@@ -1993,6 +2469,7 @@ void CPL_STDCALL CPLFreeConfig()
 
         CSLDestroy(const_cast<char **>(g_papszConfigOptions));
         g_papszConfigOptions = nullptr;
+        CPLPublishConfigSnapshot(nullptr);
 
         int bMemoryError = FALSE;
         char **papszTLConfigOptions = reinterpret_cast<char **>(
@@ -135,7 +135,8 @@ static CSVTable *CSVAccess( const char * pszFilename )
 /* -------------------------------------------------------------------- */
 /*      If not, try to open it.                                         */
 /* -------------------------------------------------------------------- */
-    VSILFILE *fp = VSIFOpenL( pszFilename, "rb" );
+    const char* const apszOptions[] = { "ACCESS_PATTERN=SEQUENTIAL", nullptr };
+    VSILFILE *fp = VSIFOpenEx2L( pszFilename, "rb", FALSE, apszOptions );
     if( fp == nullptr )
         return nullptr;
 
@@ -42,6 +42,7 @@
 #include "cpl_port.h"
 #include "cpl_minizip_zip.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
@@ -55,6 +56,7 @@
 #include "cpl_minizip_unzip.h"
 #include "cpl_string.h"
 #include "cpl_vsi_virtual.h"
+#include "cpl_worker_thread_pool.h"
 
 #ifdef NO_ERRNO_H
     extern int errno;
@@ -190,6 +192,9 @@ typedef struct
     int use_cpl_io;
     vsi_l_offset vsi_raw_length_before;
     VSIVirtualHandle* vsi_deflate_handle;
+    CPLWorkerThreadPool* vsi_deflate_pool; /* shared by all members */
+    int vsi_deflate_computes_crc32;
+    GUInt32 vsi_deflate_crc32;
 } zip64_internal;
 
 #ifndef NOCRYPT
@@ -868,6 +873,9 @@ extern zipFile ZEXPORT cpl_zipOpen2 (
     ziinit.use_cpl_io = (pzlib_filefunc_def == nullptr) ? 1 : 0;
     ziinit.vsi_raw_length_before = 0;
     ziinit.vsi_deflate_handle = nullptr;
+    ziinit.vsi_deflate_pool = nullptr;
+    ziinit.vsi_deflate_computes_crc32 = 0;
+    ziinit.vsi_deflate_crc32 = 0;
     init_linkedlist(&(ziinit.central_dir));
 
     zip64_internal* zi = static_cast<zip64_internal*>(ALLOC(sizeof(zip64_internal)));
@@ -921,6 +929,20 @@ static void zip64local_putValue_inmemory_update(char **dest, ZPOS64_T x, int nbB
     *dest += nbByte;
 }
 
+/************************************************************************/
+/*                         zip64GetNumThreads()                         */
+/************************************************************************/
+
+static int zip64GetNumThreads()
+{
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszThreads == nullptr )
+        return 1;
+    const int nThreads = EQUAL(pszThreads, "ALL_CPUS") ?
+                                    CPLGetNumCPUs() : atoi(pszThreads);
+    return std::max(1, std::min(128, nThreads));
+}
+
 static int Write_LocalFileHeader(zip64_internal* zi, const char* filename, uInt size_extrafield_local, const void* extrafield_local, int zip64)
 {
   /* write the local header */
@@ -1177,9 +1199,36 @@ extern int ZEXPORT cpl_zipOpenNewFileInZip3 (
         {
             auto fpRaw = reinterpret_cast<VSIVirtualHandle*>(zi->filestream);
             zi->vsi_raw_length_before = fpRaw->Tell();
-            zi->vsi_deflate_handle =
-                VSICreateGZipWritable( fpRaw,
-                                       CPL_DEFLATE_TYPE_RAW_DEFLATE, false);
+            const int nThreads = zip64GetNumThreads();
+            if( nThreads > 1 && zi->vsi_deflate_pool == nullptr )
+            {
+                zi->vsi_deflate_pool = new CPLWorkerThreadPool();
+                if( !zi->vsi_deflate_pool->Setup(nThreads, nullptr, nullptr,
+                                                 false) )
+                {
+                    delete zi->vsi_deflate_pool;
+                    zi->vsi_deflate_pool = nullptr;
+                }
+            }
+            if( nThreads > 1 && zi->vsi_deflate_pool != nullptr )
+            {
+                // Chunks are deflated (and their CRC computed) by the
+                // worker threads, which are reused from member to member.
+                zi->vsi_deflate_computes_crc32 = 1;
+                zi->vsi_deflate_handle =
+                    VSICreateGZipWritableMT( fpRaw,
+                                             CPL_DEFLATE_TYPE_RAW_DEFLATE,
+                                             false,
+                                             nThreads,
+                                             zi->vsi_deflate_pool,
+                                             &zi->vsi_deflate_crc32 );
+            }
+            else
+            {
+                zi->vsi_deflate_handle =
+                    VSICreateGZipWritable( fpRaw,
+                                           CPL_DEFLATE_TYPE_RAW_DEFLATE, false);
+            }
             err = Z_OK;
         }
         else
@@ -1301,7 +1350,8 @@ extern int ZEXPORT cpl_zipWriteInFileInZip (
 
     zi->ci.stream.next_in = reinterpret_cast<Bytef*>(const_cast<void*>(buf));
     zi->ci.stream.avail_in = len;
-    zi->ci.crc32 = crc32(zi->ci.crc32, reinterpret_cast<const Bytef *>(buf),len);
+    if( !zi->vsi_deflate_computes_crc32 )
+        zi->ci.crc32 = crc32(zi->ci.crc32, reinterpret_cast<const Bytef *>(buf),len);
 
     int err=ZIP_OK;
     while ((err==ZIP_OK) && (zi->ci.stream.avail_in>0))
@@ -1378,8 +1428,15 @@ extern int ZEXPORT cpl_zipCloseFileInZipRaw (
         if( zi->vsi_deflate_handle )
         {
             auto fpRaw = reinterpret_cast<VSIVirtualHandle*>(zi->filestream);
+            if( zi->vsi_deflate_handle->Close() != 0 )
+                err = ZIP_ERRNO;
             delete zi->vsi_deflate_handle;
             zi->vsi_deflate_handle = nullptr;
+            if( zi->vsi_deflate_computes_crc32 )
+            {
+                zi->ci.crc32 = zi->vsi_deflate_crc32;
+                zi->vsi_deflate_computes_crc32 = 0;
+            }
             zi->ci.totalCompressedData =
                 fpRaw->Tell() - zi->vsi_raw_length_before;
         }
@@ -1827,6 +1884,7 @@ extern int ZEXPORT cpl_zipClose (
 #ifndef NO_ADDFILEINEXISTINGZIP
     TRYFREE(zi->globalcomment);
 #endif
+    delete zi->vsi_deflate_pool;
     TRYFREE(zi);
 
     return err;
@@ -43,14 +43,18 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
-#include "cpl_multiproc.h"
 #include "cpl_string.h"
 
 //! @cond Doxygen_Suppress
@@ -60,16 +64,18 @@ CPL_CVSID("$Id$")
 /*
 ** Notes on Multithreading:
 **
-** VSIMemFilesystemHandler: This class maintains a mutex to protect
-** access and update of the oFileList array which has all the "files" in
-** the memory filesystem area.  It is expected that multiple threads would
-** want to create and read different files at the same time and so might
-** collide access oFileList without the mutex.
+** VSIMemFilesystemHandler: The "files" of the memory filesystem area are
+** spread over several shards, according to a hash of their name. Each shard
+** has its own mutex protecting its oFileList map, so that threads creating,
+** opening or stat'ing different files rarely contend. Operations that need
+** a consistent view of the whole area (ReadDirEx(), Rename()) lock all the
+** shards, in increasing index order.
 **
-** VSIMemFile: In theory we could allow different threads to update the
-** the same memory file, but for simplicity we restrict to single writer,
-** multiple reader as an expectation on the application code (not enforced
-** here), which means we don't need to do any protection of this class.
+** VSIMemFile: Each file has a reader/writer lock protecting its content
+** and length. Reads take it in shared mode, so that any number of threads
+** can read the same file concurrently, while writes, truncation and
+** conversion to a contiguous buffer take it in exclusive mode. When both a
+** shard mutex and a file lock are needed, the shard mutex is taken first.
 **
 ** VSIMemHandle: This is essentially a "current location" representing
 ** on accessor to a file, and is inherently intended only to be used in
@@ -78,12 +84,87 @@ CPL_CVSID("$Id$")
 ** In General:
 **
 ** Multiple threads accessing the memory filesystem are ok as long as
-**  1) A given VSIMemHandle (i.e. FILE * at app level) isn't used by multiple
-**     threads at once.
-**  2) A given memory file isn't accessed by more than one thread unless
-**     all threads are just reading.
+** a given VSIMemHandle (i.e. FILE * at app level) isn't used by multiple
+** threads at once. Note however that the buffer returned by
+** VSIGetMemFileBuffer() is not protected: it must not be used while other
+** threads modify the file.
 */
 
+/************************************************************************/
+/* ==================================================================== */
+/*                             VSIMemRWLock                             */
+/* ==================================================================== */
+/************************************************************************/
+
+// Reader/writer lock giving priority to writers, so that a continuous flow
+// of readers cannot starve them. It is not recursive.
+class VSIMemRWLock
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIMemRWLock)
+
+    std::mutex              m_oMutex{};
+    std::condition_variable m_oCV{};
+    int                     m_nReaders = 0;
+    int                     m_nWaitingWriters = 0;
+    bool                    m_bWriter = false;
+
+  public:
+    VSIMemRWLock() = default;
+
+    void LockShared()
+    {
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        m_oCV.wait(oLock, [this]
+                   { return !m_bWriter && m_nWaitingWriters == 0; });
+        ++m_nReaders;
+    }
+
+    void UnlockShared()
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( --m_nReaders == 0 && m_nWaitingWriters > 0 )
+            m_oCV.notify_all();
+    }
+
+    void Lock()
+    {
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        ++m_nWaitingWriters;
+        m_oCV.wait(oLock, [this] { return !m_bWriter && m_nReaders == 0; });
+        --m_nWaitingWriters;
+        m_bWriter = true;
+    }
+
+    void Unlock()
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_bWriter = false;
+        m_oCV.notify_all();
+    }
+};
+
+class VSIMemSharedLockHolder
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIMemSharedLockHolder)
+    VSIMemRWLock& m_oLock;
+
+  public:
+    explicit VSIMemSharedLockHolder( VSIMemRWLock& oLock ): m_oLock(oLock)
+        { m_oLock.LockShared(); }
+    ~VSIMemSharedLockHolder() { m_oLock.UnlockShared(); }
+};
+
+class VSIMemExclusiveLockHolder
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIMemExclusiveLockHolder)
+    VSIMemRWLock& m_oLock;
+
+  public:
+    explicit VSIMemExclusiveLockHolder( VSIMemRWLock& oLock ): m_oLock(oLock)
+        { m_oLock.Lock(); }
+    ~VSIMemExclusiveLockHolder() { m_oLock.Unlock(); }
+};
+
 /************************************************************************/
 /* ==================================================================== */
 /*                              VSIMemFile                              */
@@ -106,12 +187,32 @@ public:
     vsi_l_offset  nAllocLength = 0;
     vsi_l_offset  nMaxLength = GUINTBIG_MAX;
 
+    // When nChunkSize != 0, the content is stored in apabyChunks, a list of
+    // nChunkSize-large buffers, instead of pabyData, so that growing the
+    // file never needs to reallocate and copy what has already been written.
+    size_t        nChunkSize = 0;
+    std::vector<GByte*> apabyChunks{};
+
     time_t        mTime = 0;
 
+    // Protects the above members, except osFilename (protected by the
+    // filesystem handler) and bIsDirectory (immutable).
+    mutable VSIMemRWLock oLock{};
+
     VSIMemFile();
     virtual ~VSIMemFile();
 
     bool          SetLength( vsi_l_offset nNewSize );
+    void          SetChunkSize( size_t nNewChunkSize );
+    void          CopyTo( void* pBuffer, vsi_l_offset nOffset,
+                          size_t nSize ) const;
+    void          CopyFrom( vsi_l_offset nOffset, const void* pBuffer,
+                            size_t nSize );
+    bool          MakeContiguous();
+
+  private:
+    void          FreeData();
+    bool          SetLengthChunked( vsi_l_offset nNewLength );
 };
 
 /************************************************************************/
@@ -156,8 +257,25 @@ class VSIMemFilesystemHandler final : public VSIFilesystemHandler
     CPL_DISALLOW_COPY_ASSIGN(VSIMemFilesystemHandler)
 
   public:
-    std::map<CPLString, VSIMemFile*> oFileList{};
-    CPLMutex        *hMutex = nullptr;
+    struct FileListShard
+    {
+        std::mutex                        oMutex{};
+        std::map<CPLString, VSIMemFile*>  oFileList{};
+    };
+
+    static constexpr int knShardCount = 16;
+    FileListShard   aoShards[knShardCount];
+
+    // Locks all the shards, for operations that span several files.
+    class AllShardsHolder
+    {
+        CPL_DISALLOW_COPY_ASSIGN(AllShardsHolder)
+        VSIMemFilesystemHandler* m_poFS;
+
+      public:
+        explicit AllShardsHolder( VSIMemFilesystemHandler* poFS );
+        ~AllShardsHolder();
+    };
 
     VSIMemFilesystemHandler() = default;
     ~VSIMemFilesystemHandler() override;
@@ -168,7 +286,7 @@ class VSIMemFilesystemHandler final : public VSIFilesystemHandler
     VSIVirtualHandle *Open( const char *pszFilename,
                             const char *pszAccess,
                             bool bSetError,
-                            CSLConstList /* papszOptions */ ) override;
+                            CSLConstList papszOptions ) override;
     int Stat( const char *pszFilename, VSIStatBufL *pStatBuf,
               int nFlags ) override;
     int Unlink( const char *pszFilename ) override;
@@ -182,6 +300,7 @@ class VSIMemFilesystemHandler final : public VSIFilesystemHandler
 
     static std::string NormalizePath( const std::string &in );
 
+    FileListShard&   GetShard( const CPLString& osFilename );
     int              Unlink_unlocked( const char *pszFilename );
 };
 
@@ -212,8 +331,44 @@ VSIMemFile::~VSIMemFile()
                   "Memory file %s deleted with %d references.",
                   osFilename.c_str(), nRefCount );
 
+    FreeData();
+}
+
+/************************************************************************/
+/*                              FreeData()                              */
+/************************************************************************/
+
+void VSIMemFile::FreeData()
+
+{
     if( bOwnData && pabyData )
         CPLFree( pabyData );
+    pabyData = nullptr;
+    nAllocLength = 0;
+
+    for( GByte* pabyChunk: apabyChunks )
+        CPLFree( pabyChunk );
+    apabyChunks.clear();
+}
+
+/************************************************************************/
+/*                            SetChunkSize()                            */
+/************************************************************************/
+
+// Select the storage layout of the file. Existing content is discarded, so
+// this must only be called on a newly created or overwritten file. A file
+// whose buffer is not owned keeps its contiguous layout and is truncated.
+void VSIMemFile::SetChunkSize( size_t nNewChunkSize )
+
+{
+    if( !bOwnData )
+    {
+        SetLength(0);
+        return;
+    }
+    FreeData();
+    nLength = 0;
+    nChunkSize = nNewChunkSize;
 }
 
 /************************************************************************/
@@ -230,6 +385,9 @@ bool VSIMemFile::SetLength( vsi_l_offset nNewLength )
         return false;
     }
 
+    if( nChunkSize != 0 )
+        return SetLengthChunked( nNewLength );
+
 /* -------------------------------------------------------------------- */
 /*      Grow underlying array if needed.                                */
 /* -------------------------------------------------------------------- */
@@ -280,6 +438,177 @@ bool VSIMemFile::SetLength( vsi_l_offset nNewLength )
     return true;
 }
 
+/************************************************************************/
+/*                          SetLengthChunked()                          */
+/************************************************************************/
+
+bool VSIMemFile::SetLengthChunked( vsi_l_offset nNewLength )
+
+{
+    const vsi_l_offset nChunkCount =
+        (nNewLength + nChunkSize - 1) / nChunkSize;
+    if( nChunkCount > apabyChunks.max_size() )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot extend in-memory file to " CPL_FRMT_GUIB " bytes",
+                 nNewLength);
+        return false;
+    }
+
+    if( nChunkCount < apabyChunks.size() )
+    {
+        for( size_t i = static_cast<size_t>(nChunkCount);
+             i < apabyChunks.size(); ++i )
+        {
+            CPLFree(apabyChunks[i]);
+        }
+        apabyChunks.resize(static_cast<size_t>(nChunkCount));
+    }
+
+    // Clear the part of the last chunk beyond the new end of file, so that
+    // extending the file again later exposes zeroes and not stale data.
+    if( nNewLength < nLength && !apabyChunks.empty() )
+    {
+        const size_t nOffsetInChunk =
+            static_cast<size_t>(nNewLength % nChunkSize);
+        if( nOffsetInChunk != 0 )
+        {
+            const vsi_l_offset nChunkEnd = nNewLength - nOffsetInChunk +
+                                           nChunkSize;
+            const size_t nToClear = static_cast<size_t>(
+                std::min(nLength, nChunkEnd) - nNewLength);
+            memset(apabyChunks.back() + nOffsetInChunk, 0, nToClear);
+        }
+    }
+
+    while( apabyChunks.size() < nChunkCount )
+    {
+        GByte* pabyChunk = static_cast<GByte*>(VSICalloc(1, nChunkSize));
+        if( pabyChunk == nullptr )
+        {
+            CPLError(
+                CE_Failure, CPLE_OutOfMemory,
+                "Cannot extend in-memory file to " CPL_FRMT_GUIB
+                " bytes due to out-of-memory situation",
+                nNewLength);
+            return false;
+        }
+        apabyChunks.push_back(pabyChunk);
+    }
+
+    nLength = nNewLength;
+    time(&mTime);
+
+    return true;
+}
+
+/************************************************************************/
+/*                               CopyTo()                               */
+/************************************************************************/
+
+// Copy nSize bytes at nOffset to pBuffer. The range must be within the
+// allocated storage.
+void VSIMemFile::CopyTo( void* pBuffer, vsi_l_offset nOffset,
+                         size_t nSize ) const
+
+{
+    if( nChunkSize == 0 )
+    {
+        memcpy( pBuffer, pabyData + nOffset, nSize );
+        return;
+    }
+
+    GByte* pabyDst = static_cast<GByte*>(pBuffer);
+    while( nSize > 0 )
+    {
+        const size_t iChunk = static_cast<size_t>(nOffset / nChunkSize);
+        const size_t nOffsetInChunk = static_cast<size_t>(nOffset % nChunkSize);
+        const size_t nToCopy = std::min(nSize, nChunkSize - nOffsetInChunk);
+        memcpy( pabyDst, apabyChunks[iChunk] + nOffsetInChunk, nToCopy );
+        pabyDst += nToCopy;
+        nOffset += nToCopy;
+        nSize -= nToCopy;
+    }
+}
+
+/************************************************************************/
+/*                              CopyFrom()                              */
+/************************************************************************/
+
+// Copy nSize bytes from pBuffer at nOffset. The range must be within the
+// allocated storage.
+void VSIMemFile::CopyFrom( vsi_l_offset nOffset, const void* pBuffer,
+                           size_t nSize )
+
+{
+    if( nChunkSize == 0 )
+    {
+        memcpy( pabyData + nOffset, pBuffer, nSize );
+        return;
+    }
+
+    const GByte* pabySrc = static_cast<const GByte*>(pBuffer);
+    while( nSize > 0 )
+    {
+        const size_t iChunk = static_cast<size_t>(nOffset / nChunkSize);
+        const size_t nOffsetInChunk = static_cast<size_t>(nOffset % nChunkSize);
+        const size_t nToCopy = std::min(nSize, nChunkSize - nOffsetInChunk);
+        memcpy( apabyChunks[iChunk] + nOffsetInChunk, pabySrc, nToCopy );
+        pabySrc += nToCopy;
+        nOffset += nToCopy;
+        nSize -= nToCopy;
+    }
+}
+
+/************************************************************************/
+/*                           MakeContiguous()                           */
+/************************************************************************/
+
+// Switch a chunked file to a single pabyData buffer, for callers that need
+// a pointer to the whole content. A file made of a single chunk is converted
+// without copy.
+bool VSIMemFile::MakeContiguous()
+
+{
+    if( nChunkSize == 0 )
+        return true;
+
+    GByte* pabyNewData = nullptr;
+    vsi_l_offset nNewAlloc = 0;
+    if( apabyChunks.size() == 1 )
+    {
+        pabyNewData = apabyChunks[0];
+        nNewAlloc = nChunkSize;
+    }
+    else if( !apabyChunks.empty() )
+    {
+        if( static_cast<vsi_l_offset>(static_cast<size_t>(nLength))
+            == nLength )
+        {
+            pabyNewData = static_cast<GByte *>(
+                VSIMalloc(static_cast<size_t>(nLength)));
+        }
+        if( pabyNewData == nullptr )
+        {
+            CPLError(
+                CE_Failure, CPLE_OutOfMemory,
+                "Cannot allocate " CPL_FRMT_GUIB " bytes to make in-memory "
+                "file %s contiguous", nLength, osFilename.c_str());
+            return false;
+        }
+        CopyTo(pabyNewData, 0, static_cast<size_t>(nLength));
+        for( GByte* pabyChunk: apabyChunks )
+            CPLFree( pabyChunk );
+        nNewAlloc = nLength;
+    }
+    apabyChunks.clear();
+
+    pabyData = pabyNewData;
+    nAllocLength = nNewAlloc;
+    nChunkSize = 0;
+    return true;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                             VSIMemHandle                             */
@@ -339,6 +668,7 @@ int VSIMemHandle::Seek( vsi_l_offset nOffset, int nWhence )
     }
     else if( nWhence == SEEK_END )
     {
+        VSIMemSharedLockHolder oHolder(poFile->oLock);
         m_nOffset = poFile->nLength + nOffset;
     }
     else
@@ -349,12 +679,11 @@ int VSIMemHandle::Seek( vsi_l_offset nOffset, int nWhence )
 
     bEOF = false;
 
-    if( m_nOffset > poFile->nLength )
+    if( bUpdate ) // Writable files are zero-extended by seek past end.
     {
-        if( bUpdate ) // Writable files are zero-extended by seek past end.
-        {
+        VSIMemSharedLockHolder oHolder(poFile->oLock);
+        if( m_nOffset > poFile->nLength )
             bExtendFileAtNextWrite = true;
-        }
     }
 
     return 0;
@@ -384,6 +713,7 @@ size_t VSIMemHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
         return 0;
     }
 
+    VSIMemSharedLockHolder oHolder(poFile->oLock);
     if( poFile->nLength <= m_nOffset ||
         nBytesToRead + m_nOffset < nBytesToRead )
     {
@@ -398,8 +728,8 @@ size_t VSIMemHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
     }
 
     if( nBytesToRead )
-        memcpy( pBuffer, poFile->pabyData + m_nOffset,
-                static_cast<size_t>(nBytesToRead) );
+        poFile->CopyTo( pBuffer, m_nOffset,
+                        static_cast<size_t>(nBytesToRead) );
     m_nOffset += nBytesToRead;
 
     return nCount;
@@ -417,10 +747,13 @@ size_t VSIMemHandle::Write( const void * pBuffer, size_t nSize, size_t nCount )
         errno = EACCES;
         return 0;
     }
+
+    VSIMemExclusiveLockHolder oHolder(poFile->oLock);
     if( bExtendFileAtNextWrite )
     {
         bExtendFileAtNextWrite = false;
-        if( !poFile->SetLength( m_nOffset ) )
+        // Another handle may have extended the file since the seek.
+        if( m_nOffset > poFile->nLength && !poFile->SetLength( m_nOffset ) )
             return 0;
     }
 
@@ -441,7 +774,7 @@ size_t VSIMemHandle::Write( const void * pBuffer, size_t nSize, size_t nCount )
     }
 
     if( nBytesToWrite )
-        memcpy( poFile->pabyData + m_nOffset, pBuffer, nBytesToWrite );
+        poFile->CopyFrom( m_nOffset, pBuffer, nBytesToWrite );
     m_nOffset += nBytesToWrite;
 
     time(&poFile->mTime);
@@ -472,6 +805,7 @@ int VSIMemHandle::Truncate( vsi_l_offset nNewSize )
     }
 
     bExtendFileAtNextWrite = false;
+    VSIMemExclusiveLockHolder oHolder(poFile->oLock);
     if( poFile->SetLength( nNewSize ) )
         return 0;
 
@@ -491,15 +825,46 @@ int VSIMemHandle::Truncate( vsi_l_offset nNewSize )
 VSIMemFilesystemHandler::~VSIMemFilesystemHandler()
 
 {
-    for( const auto &iter : oFileList )
+    for( auto &oShard : aoShards )
     {
-        CPLAtomicDec(&iter.second->nRefCount);
-        delete iter.second;
+        for( const auto &iter : oShard.oFileList )
+        {
+            CPLAtomicDec(&iter.second->nRefCount);
+            delete iter.second;
+        }
     }
+}
+
+/************************************************************************/
+/*                          AllShardsHolder()                           */
+/************************************************************************/
+
+VSIMemFilesystemHandler::AllShardsHolder::AllShardsHolder(
+                                    VSIMemFilesystemHandler* poFS ) :
+    m_poFS(poFS)
+{
+    for( auto &oShard : m_poFS->aoShards )
+        oShard.oMutex.lock();
+}
+
+/************************************************************************/
+/*                         ~AllShardsHolder()                           */
+/************************************************************************/
+
+VSIMemFilesystemHandler::AllShardsHolder::~AllShardsHolder()
+{
+    for( int i = knShardCount - 1; i >= 0; --i )
+        m_poFS->aoShards[i].oMutex.unlock();
+}
+
+/************************************************************************/
+/*                              GetShard()                              */
+/************************************************************************/
 
-    if( hMutex != nullptr )
-        CPLDestroyMutex( hMutex );
-    hMutex = nullptr;
+VSIMemFilesystemHandler::FileListShard&
+VSIMemFilesystemHandler::GetShard( const CPLString& osFilename )
+{
+    return aoShards[std::hash<std::string>()(osFilename) % knShardCount];
 }
 
 /************************************************************************/
@@ -510,10 +875,9 @@ VSIVirtualHandle *
 VSIMemFilesystemHandler::Open( const char *pszFilename,
                                const char *pszAccess,
                                bool bSetError,
-                               CSLConstList /* papszOptions */ )
+                               CSLConstList papszOptions )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
     const CPLString osFilename = NormalizePath(pszFilename);
     if( osFilename.empty() )
         return nullptr;
@@ -526,12 +890,41 @@ VSIMemFilesystemHandler::Open( const char *pszFilename,
                     osFilename.substr(iPos + strlen("||maxlength=")).c_str()));
     }
 
+    // Storage layout of created or overwritten files: 0 for a single
+    // contiguous buffer, or the size of the chunks the file is made of.
+    size_t nChunkSize = 0;
+    if( strstr(pszAccess, "w") || strstr(pszAccess, "a") )
+    {
+        const char* pszChunkSize = CSLFetchNameValueDef(
+            papszOptions, "CHUNK_SIZE",
+            CPLGetConfigOption("CPL_VSIMEM_CHUNK_SIZE", "0"));
+        const GIntBig nVal = CPLAtoGIntBig(pszChunkSize);
+        // Smaller chunks would cost more in allocations than they save.
+        constexpr GIntBig knMinChunkSize = 4096;
+        if( nVal > 0 && nVal < knMinChunkSize )
+        {
+            CPLError(CE_Warning, CPLE_IllegalArg,
+                     "CHUNK_SIZE=%s is below the minimum of " CPL_FRMT_GIB
+                     " bytes. Ignored", pszChunkSize, knMinChunkSize);
+        }
+        else if( nVal > 0 )
+        {
+            nChunkSize = static_cast<size_t>(std::min(
+                static_cast<GUIntBig>(nVal),
+                static_cast<GUIntBig>(std::numeric_limits<size_t>::max())));
+        }
+    }
+
+    FileListShard& oShard = GetShard(osFilename);
+    std::lock_guard<std::mutex> oShardLock(oShard.oMutex);
+
 /* -------------------------------------------------------------------- */
 /*      Get the filename we are opening, create if needed.              */
 /* -------------------------------------------------------------------- */
     VSIMemFile *poFile = nullptr;
-    if( oFileList.find(osFilename) != oFileList.end() )
-        poFile = oFileList[osFilename];
+    const auto oIter = oShard.oFileList.find(osFilename);
+    if( oIter != oShard.oFileList.end() )
+        poFile = oIter->second;
 
     // If no file and opening in read, error out.
     if( strstr(pszAccess, "w") == nullptr
@@ -551,18 +944,23 @@ VSIMemFilesystemHandler::Open( const char *pszFilename,
     {
         poFile = new VSIMemFile;
         poFile->osFilename = osFilename;
-        oFileList[poFile->osFilename] = poFile;
+        oShard.oFileList[poFile->osFilename] = poFile;
         CPLAtomicInc(&(poFile->nRefCount));  // For file list.
 #ifdef DEBUG_VERBOSE
         CPLDebug("VSIMEM", "Creating file %s: ref_count=%d",
                  pszFilename, poFile->nRefCount);
 #endif
         poFile->nMaxLength = nMaxLength;
+        poFile->nChunkSize = nChunkSize;
     }
     // Overwrite
     else if( strstr(pszAccess, "w") )
     {
-        poFile->SetLength(0);
+        VSIMemExclusiveLockHolder oHolder(poFile->oLock);
+        if( poFile->nChunkSize != nChunkSize )
+            poFile->SetChunkSize(nChunkSize);
+        else
+            poFile->SetLength(0);
         poFile->nMaxLength = nMaxLength;
     }
 
@@ -591,7 +989,10 @@ VSIMemFilesystemHandler::Open( const char *pszFilename,
              poHandle, pszFilename, poFile->nRefCount);
 #endif
     if( strstr(pszAccess, "a") )
+    {
+        VSIMemSharedLockHolder oHolder(poFile->oLock);
         poHandle->m_nOffset = poFile->nLength;
+    }
 
     return poHandle;
 }
@@ -605,8 +1006,6 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
                                    int /* nFlags */ )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const CPLString osFilename = NormalizePath(pszFilename);
 
     memset( pStatBuf, 0, sizeof(VSIStatBufL) );
@@ -618,13 +1017,17 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
         return 0;
     }
 
-    if( oFileList.find(osFilename) == oFileList.end() )
+    FileListShard& oShard = GetShard(osFilename);
+    std::lock_guard<std::mutex> oShardLock(oShard.oMutex);
+
+    const auto oIter = oShard.oFileList.find(osFilename);
+    if( oIter == oShard.oFileList.end() )
     {
         errno = ENOENT;
         return -1;
     }
 
-    VSIMemFile *poFile = oFileList[osFilename];
+    VSIMemFile *poFile = oIter->second;
 
     memset( pStatBuf, 0, sizeof(VSIStatBufL) );
 
@@ -635,6 +1038,7 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
     }
     else
     {
+        VSIMemSharedLockHolder oHolder(poFile->oLock);
         pStatBuf->st_size = poFile->nLength;
         pStatBuf->st_mode = S_IFREG;
         pStatBuf->st_mtime = poFile->mTime;
@@ -650,26 +1054,30 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
 int VSIMemFilesystemHandler::Unlink( const char * pszFilename )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-    return Unlink_unlocked(pszFilename);
+    const CPLString osFilename = NormalizePath(pszFilename);
+    std::lock_guard<std::mutex> oShardLock(GetShard(osFilename).oMutex);
+    return Unlink_unlocked(osFilename);
 }
 
 /************************************************************************/
 /*                           Unlink_unlocked()                          */
 /************************************************************************/
 
+// The caller must hold the mutex of the shard of pszFilename.
 int VSIMemFilesystemHandler::Unlink_unlocked( const char * pszFilename )
 
 {
     const CPLString osFilename = NormalizePath(pszFilename);
+    auto& oFileList = GetShard(osFilename).oFileList;
 
-    if( oFileList.find(osFilename) == oFileList.end() )
+    const auto oIter = oFileList.find(osFilename);
+    if( oIter == oFileList.end() )
     {
         errno = ENOENT;
         return -1;
     }
 
-    VSIMemFile *poFile = oFileList[osFilename];
+    VSIMemFile *poFile = oIter->second;
 #ifdef DEBUG_VERBOSE
     CPLDebug("VSIMEM", "Unlink %s: ref_count=%d (before)",
              pszFilename, poFile->nRefCount);
@@ -677,7 +1085,7 @@ int VSIMemFilesystemHandler::Unlink_unlocked( const char * pszFilename )
     if( CPLAtomicDec(&(poFile->nRefCount)) == 0 )
         delete poFile;
 
-    oFileList.erase( oFileList.find(osFilename) );
+    oFileList.erase( oIter );
 
     return 0;
 }
@@ -690,11 +1098,12 @@ int VSIMemFilesystemHandler::Mkdir( const char * pszPathname,
                                     long /* nMode */ )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const CPLString osPathname = NormalizePath(pszPathname);
 
-    if( oFileList.find(osPathname) != oFileList.end() )
+    FileListShard& oShard = GetShard(osPathname);
+    std::lock_guard<std::mutex> oShardLock(oShard.oMutex);
+
+    if( oShard.oFileList.find(osPathname) != oShard.oFileList.end() )
     {
         errno = EEXIST;
         return -1;
@@ -704,7 +1113,7 @@ int VSIMemFilesystemHandler::Mkdir( const char * pszPathname,
 
     poFile->osFilename = osPathname;
     poFile->bIsDirectory = true;
-    oFileList[osPathname] = poFile;
+    oShard.oFileList[osPathname] = poFile;
     CPLAtomicInc(&(poFile->nRefCount));  // Referenced by file list.
 #ifdef DEBUG_VERBOSE
     CPLDebug("VSIMEM", "Mkdir on %s: ref_count=%d",
@@ -731,48 +1140,48 @@ char **VSIMemFilesystemHandler::ReadDirEx( const char *pszPath,
                                            int nMaxFiles )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const CPLString osPath = NormalizePath(pszPath);
 
-    char **papszDir = nullptr;
     size_t nPathLen = osPath.size();
 
     if( nPathLen > 0 && osPath.back() == '/' )
         nPathLen--;
 
-    // In case of really big number of files in the directory, CSLAddString
-    // can be slow (see #2158). We then directly build the list.
-    int nItems = 0;
-    int nAllocatedItems = 0;
+    AllShardsHolder oHolder(this);
 
-    for( const auto& iter : oFileList )
+    // Files are spread over the shards, so gather the matching ones and
+    // sort them to return them in the same order as a single sorted list.
+    std::vector<const CPLString*> apoMatches;
+    for( const auto& oShard : aoShards )
     {
-        const char *pszFilePath = iter.second->osFilename.c_str();
-        if( EQUALN(osPath, pszFilePath, nPathLen)
-            && pszFilePath[nPathLen] == '/'
-            && strstr(pszFilePath+nPathLen+1, "/") == nullptr )
+        for( const auto& iter : oShard.oFileList )
         {
-            if( nItems == 0 )
-            {
-                papszDir = static_cast<char**>(CPLCalloc(2, sizeof(char*)));
-                nAllocatedItems = 1;
-            }
-            else if( nItems >= nAllocatedItems )
+            const char *pszFilePath = iter.second->osFilename.c_str();
+            if( EQUALN(osPath, pszFilePath, nPathLen)
+                && pszFilePath[nPathLen] == '/'
+                && strstr(pszFilePath+nPathLen+1, "/") == nullptr )
             {
-                nAllocatedItems = nAllocatedItems * 2;
-                papszDir = static_cast<char**>(
-                    CPLRealloc(papszDir, (nAllocatedItems + 2)*sizeof(char*)) );
+                apoMatches.push_back(&(iter.second->osFilename));
             }
-
-            papszDir[nItems] = CPLStrdup(pszFilePath+nPathLen+1);
-            papszDir[nItems+1] = nullptr;
-
-            nItems++;
-            if( nMaxFiles > 0 && nItems > nMaxFiles )
-                break;
         }
     }
+    if( apoMatches.empty() )
+        return nullptr;
+
+    std::sort(apoMatches.begin(), apoMatches.end(),
+              [](const CPLString* a, const CPLString* b) { return *a < *b; });
+    if( nMaxFiles > 0 &&
+        apoMatches.size() > static_cast<size_t>(nMaxFiles) + 1 )
+    {
+        apoMatches.resize(static_cast<size_t>(nMaxFiles) + 1);
+    }
+
+    // In case of really big number of files in the directory, CSLAddString
+    // can be slow (see #2158). We then directly build the list.
+    char **papszDir = static_cast<char**>(
+        CPLCalloc(apoMatches.size() + 1, sizeof(char*)));
+    for( size_t i = 0; i < apoMatches.size(); ++i )
+        papszDir[i] = CPLStrdup(apoMatches[i]->c_str() + nPathLen + 1);
 
     return papszDir;
 }
@@ -785,8 +1194,6 @@ int VSIMemFilesystemHandler::Rename( const char *pszOldPath,
                                      const char *pszNewPath )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const CPLString osOldPath = NormalizePath(pszOldPath);
     const CPLString osNewPath = NormalizePath(pszNewPath);
     if( !STARTS_WITH(pszNewPath, "/vsimem/") )
@@ -795,30 +1202,46 @@ int VSIMemFilesystemHandler::Rename( const char *pszOldPath,
     if( osOldPath.compare(osNewPath) == 0 )
         return 0;
 
-    if( oFileList.find(osOldPath) == oFileList.end() )
+    AllShardsHolder oHolder(this);
+
+    if( GetShard(osOldPath).oFileList.count(osOldPath) == 0 )
     {
         errno = ENOENT;
         return -1;
     }
 
-    std::map<CPLString, VSIMemFile*>::iterator it = oFileList.find(osOldPath);
-    while( it != oFileList.end() && it->first.ifind(osOldPath) == 0 )
+    // Detach the file and its children (when it is a directory) from the
+    // list before inserting them under their new name, so that replacing
+    // an existing target cannot affect one of the files being moved.
+    std::vector<VSIMemFile*> apoMoved;
+    for( auto& oShard : aoShards )
     {
-        const CPLString osRemainder = it->first.substr(osOldPath.size());
-        if( osRemainder.empty() || osRemainder[0] == '/' )
-        {
-            const CPLString osNewFullPath = osNewPath + osRemainder;
-            Unlink_unlocked(osNewFullPath);
-            oFileList[osNewFullPath] = it->second;
-            it->second->osFilename = osNewFullPath;
-            oFileList.erase(it++);
-        }
-        else
+        auto it = oShard.oFileList.begin();
+        while( it != oShard.oFileList.end() )
         {
-            ++it;
+            if( it->first.compare(0, osOldPath.size(), osOldPath) == 0 &&
+                (it->first.size() == osOldPath.size() ||
+                 it->first[osOldPath.size()] == '/') )
+            {
+                apoMoved.push_back(it->second);
+                oShard.oFileList.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
         }
     }
 
+    for( VSIMemFile* poFile : apoMoved )
+    {
+        const CPLString osNewFullPath =
+            osNewPath + poFile->osFilename.substr(osOldPath.size());
+        Unlink_unlocked(osNewFullPath);
+        GetShard(osNewFullPath).oFileList[osNewFullPath] = poFile;
+        poFile->osFilename = osNewFullPath;
+    }
+
     return 0;
 }
 
@@ -869,6 +1292,23 @@ GIntBig VSIMemFilesystemHandler::GetDiskFreeSpace( const char* /*pszDirname*/ )
  *
  * Directory related functions are supported.
  *
+ * By default, the content of a memory file is stored in a single buffer,
+ * which is reallocated as the file grows. This involves copying the data
+ * already written and temporarily requires up to twice the file size.
+ * Starting with GDAL 3.4, when creating a file with VSIFOpenEx2L(), the
+ * CHUNK_SIZE=number_of_bytes option (or the CPL_VSIMEM_CHUNK_SIZE
+ * configuration option) causes the file to be stored instead as a list of
+ * fixed-size chunks, so that appending never copies existing data. This is
+ * transparent to readers, except that VSIGetMemFileBuffer() has then to
+ * merge the chunks into a single buffer. A chunk size of a few megabytes is
+ * appropriate for very large files. Chunk sizes below 4096 bytes are
+ * ignored.
+ *
+ * Starting with GDAL 3.4, different threads can create, read and write
+ * different memory files with little contention, and a memory file can be
+ * read by several threads while another one writes to it, each thread using
+ * its own file handle.
+ *
  * This code example demonstrates using GDAL to translate from one memory
  * buffer to another.
  *
@@ -962,9 +1402,10 @@ VSILFILE *VSIFileFromMemBuffer( const char *pszFilename,
     poFile->nAllocLength = nDataLength;
 
     {
-        CPLMutexHolder oHolder( &poHandler->hMutex );
+        auto& oShard = poHandler->GetShard(osFilename);
+        std::lock_guard<std::mutex> oShardLock(oShard.oMutex);
         poHandler->Unlink_unlocked(osFilename);
-        poHandler->oFileList[poFile->osFilename] = poFile;
+        oShard.oFileList[poFile->osFilename] = poFile;
         CPLAtomicInc(&(poFile->nRefCount));
 #ifdef DEBUG_VERBOSE
         CPLDebug("VSIMEM", "VSIFileFromMemBuffer() %s: ref_count=%d (after)",
@@ -989,6 +1430,12 @@ VSILFILE *VSIFileFromMemBuffer( const char *pszFilename,
  * object will be deleted, and ownership of the buffer will pass to the
  * caller otherwise the underlying file will remain in existence.
  *
+ * If the file was created with a CHUNK_SIZE (see VSIInstallMemFileHandler()),
+ * its chunks are first merged into a single buffer, which the file keeps
+ * using afterwards. This is done without copy when the file fits in a single
+ * chunk, and otherwise requires a temporary extra allocation of the size of
+ * the file.
+ *
  * @param pszFilename the name of the file to grab the buffer of.
  * @param pnDataLength (file) length returned in this variable.
  * @param bUnlinkAndSeize TRUE to remove the file, or FALSE to leave unaltered.
@@ -1011,15 +1458,23 @@ GByte *VSIGetMemFileBuffer( const char *pszFilename,
     const CPLString osFilename =
         VSIMemFilesystemHandler::NormalizePath(pszFilename);
 
-    CPLMutexHolder oHolder( &poHandler->hMutex );
+    auto& oShard = poHandler->GetShard(osFilename);
+    std::lock_guard<std::mutex> oShardLock(oShard.oMutex);
 
-    if( poHandler->oFileList.find(osFilename) == poHandler->oFileList.end() )
+    const auto oIter = oShard.oFileList.find(osFilename);
+    if( oIter == oShard.oFileList.end() )
         return nullptr;
 
-    VSIMemFile *poFile = poHandler->oFileList[osFilename];
-    GByte *pabyData = poFile->pabyData;
-    if( pnDataLength != nullptr )
-        *pnDataLength = poFile->nLength;
+    VSIMemFile *poFile = oIter->second;
+    GByte *pabyData = nullptr;
+    {
+        VSIMemExclusiveLockHolder oHolder(poFile->oLock);
+        if( !poFile->MakeContiguous() )
+            return nullptr;
+        pabyData = poFile->pabyData;
+        if( pnDataLength != nullptr )
+            *pnDataLength = poFile->nLength;
+    }
 
     if( bUnlinkAndSeize )
     {
@@ -1029,7 +1484,7 @@ GByte *VSIGetMemFileBuffer( const char *pszFilename,
         else
             poFile->bOwnData = false;
 
-        poHandler->oFileList.erase( poHandler->oFileList.find(osFilename) );
+        oShard.oFileList.erase( oIter );
 #ifdef DEBUG_VERBOSE
         CPLDebug("VSIMEM", "VSIGetMemFileBuffer() %s: ref_count=%d (before)",
                  poFile->osFilename.c_str(), poFile->nRefCount);
@@ -61,6 +61,9 @@ class CPL_DLL VSIVirtualHandle {
     virtual int       ReadMultiRange( int nRanges, void ** ppData,
                                       const vsi_l_offset* panOffsets,
                                       const size_t* panSizes );
+    virtual void      AdviseRead( CPL_UNUSED int nRanges,
+                                  CPL_UNUSED const vsi_l_offset* panOffsets,
+                                  CPL_UNUSED const size_t* panSizes ) {}
     virtual size_t    Write( const void *pBuffer, size_t nSize,size_t nCount)=0;
     virtual int       Eof() = 0;
     virtual int       Flush() {return 0;}
@@ -71,6 +74,9 @@ class CPL_DLL VSIVirtualHandle {
     virtual VSIRangeStatus GetRangeStatus( CPL_UNUSED vsi_l_offset nOffset,
                                            CPL_UNUSED vsi_l_offset nLength )
                                           { return VSI_RANGE_STATUS_UNKNOWN; }
+    virtual bool      HasPRead() const { return false; }
+    virtual size_t    PRead( void* pBuffer, size_t nSize,
+                             vsi_l_offset nOffset ) const;
 
     virtual           ~VSIVirtualHandle() { }
 };
@@ -148,8 +154,19 @@ private:
     VSIFilesystemHandler *poDefaultHandler = nullptr;
     std::map<std::string, VSIFilesystemHandler *> oHandlers{};
 
+    // Trie of the prefixes of oHandlers, rebuilt by InstallHandler()
+    struct PrefixTrieNode
+    {
+        std::vector<std::pair<char, int>> aoChildren{}; // sorted by char
+        const std::string *posPrefix = nullptr; // set if a prefix ends here
+        VSIFilesystemHandler *poHandler = nullptr;
+    };
+    std::vector<PrefixTrieNode> aoPrefixTrie{};
+
     VSIFileManager();
 
+    void BuildPrefixTrie();
+
     static VSIFileManager *Get();
 
     CPL_DISALLOW_COPY_ASSIGN(VSIFileManager)
@@ -277,6 +294,9 @@ const int CPL_DEFLATE_TYPE_ZLIB = 1;
 const int CPL_DEFLATE_TYPE_RAW_DEFLATE = 2;
 VSIVirtualHandle CPL_DLL *VSICreateGZipWritable( VSIVirtualHandle* poBaseHandle, int nDeflateType, int bAutoCloseBaseHandle );
 
+class CPLWorkerThreadPool;
+VSIVirtualHandle *VSICreateGZipWritableMT( VSIVirtualHandle* poBaseHandle, int nDeflateType, bool bAutoCloseBaseHandle, int nThreads, CPLWorkerThreadPool* poPool, GUInt32* pnCRC32 );
+
 VSIVirtualHandle *VSICreateUploadOnCloseFile( VSIVirtualHandle* poBaseHandle );
 
 #endif /* ndef CPL_VSI_VIRTUAL_H_INCLUDED */
@@ -352,6 +352,11 @@ char **CPLReadDir( const char *pszPath )
  * implementation, minimizing the number of network requests, when invoked with
  * nRecurseDepth <= 0.
  *
+ * For /vsis3/, /vsigs/ and /vsioss/, a recursive listing can be parallelized
+ * by setting the NUM_THREADS option to a value greater than 1. Each directory
+ * is then listed by separate requests, so directories are returned as entries
+ * too, and entries are returned in no particular order.
+ *
  * Entries are read by calling VSIGetNextDirEntry() on the handled returned by
  * that function, until it returns NULL. VSICloseDir() must be called once done
  * with the returned directory handle.
@@ -670,7 +675,11 @@ int VSIRename( const char * oldpath, const char * newpath )
  *     local file system, or for upload to /vsis3/, /vsiaz/ or /vsiadls/ from local file system.
  *     Only used if NUM_THREADS > 1.
  *     For upload to /vsis3/, this chunk size must be set at least to 5 MB.
- *     The default is 8 MB since GDAL 3.3</li>
+ *     The default is 8 MB since GDAL 3.3.
+ *     For a copy between two objects of /vsis3/, objects larger than CHUNK_SIZE
+ *     (100 MB by default in that case) are copied server-side as a multipart
+ *     upload whose parts are copied in parallel with UploadPartCopy, which
+ *     also allows copying objects larger than 5 GB.</li>
  * </ul>
  * @param pProgressFunc Progress callback, or NULL.
  * @param pProgressData User data of progress callback, or NULL.
@@ -1025,7 +1034,11 @@ int VSISupportsSparseFiles( const char* pszPath )
 /**
  * \brief Returns if the filesystem supports efficient multi-range reading.
  *
- * Currently only returns TRUE for /vsicurl/ and derived file systems.
+ * Currently returns TRUE for /vsicurl/ and derived file systems, and starting
+ * with GDAL 3.4, for local files on Linux when io_uring is available (which
+ * can be disabled by setting the VSI_LOCAL_IO_URING configuration option to
+ * NO). In the latter case, all the ranges of a ReadMultiRange() call on a file
+ * opened in read-only mode are submitted to the kernel in a single batch.
  *
  * @param pszPath the path of the filesystem object to be tested.
  * UTF-8 encoded.
@@ -1705,9 +1718,33 @@ VSILFILE *VSIFOpenExL( const char * pszFilename, const char * pszAccess,
  * @param bSetError flag determining whether or not this open call
  * should set VSIErrors on failure.
  * @param papszOptions NULL or NULL-terminated list of strings. The content is
- *                     highly file system dependent. Currently only MIME headers
+ *                     highly file system dependent. MIME headers
  *                     such as Content-Type and Content-Encoding are supported
  *                     for the /vsis3/, /vsigs/, /vsiaz/, /vsiadls/ file systems.
+ *                     For local files opened in read-only mode on Unix,
+ *                     IO_METHOD=STDIO/PREAD/MMAP (GDAL >= 3.4) selects how the
+ *                     file is read: through the C library stdio functions (the
+ *                     default, which can be changed with the VSI_LOCAL_IO_METHOD
+ *                     configuration option), with pread() on the file
+ *                     descriptor, or from a memory mapping of the file.
+ *                     The PREAD and MMAP methods bypass stdio buffering.
+ *                     MMAP must not be used on files that may be truncated
+ *                     while they are opened.
+ *                     Still for local files on Unix, the following access
+ *                     hints (GDAL >= 3.4) are turned into posix_fadvise()
+ *                     calls where available:
+ *                     ACCESS_PATTERN=NORMAL/SEQUENTIAL/RANDOM,
+ *                     NOREUSE=YES, and WILLNEED=offset:size[,offset:size]*
+ *                     to start reading ranges in the background (a size of
+ *                     0 meaning until the end of the file).
+ *                     DROP_BEHIND=YES, for files opened in read-only mode
+ *                     with IO_METHOD=STDIO or PREAD, evicts from the page
+ *                     cache the pages that have been read, which is
+ *                     appropriate when streaming very large files.
+ *                     For /vsimem/ files opened in "w" or "a" mode,
+ *                     CHUNK_SIZE=number_of_bytes (GDAL >= 3.4, at least
+ *                     4096) stores the created file as a list of chunks
+ *                     of that size instead of a single reallocated buffer.
  *
  * @return NULL on failure, or the file handle.
  *
@@ -2057,6 +2094,56 @@ int VSIFReadMultiRangeL( int nRanges, void ** ppData,
     return poFileHandle->ReadMultiRange(nRanges, ppData, panOffsets, panSizes);
 }
 
+/************************************************************************/
+/*                          VSIFAdviseReadL()                           */
+/************************************************************************/
+
+/**
+ * \fn VSIVirtualHandle::AdviseRead( int nRanges,
+ *                                   const vsi_l_offset* panOffsets,
+ *                                   const size_t* panSizes )
+ * \brief Advise that the given ranges will be read soon.
+ *
+ * This is a hint that implementations may use to start fetching data in
+ * the background, so that later Read() or ReadMultiRange() calls on those
+ * ranges can be served without waiting. The call does not block and
+ * does not report errors. The default implementation does nothing.
+ *
+ * @param nRanges number of ranges.
+ * @param panOffsets array of nRanges offsets of the ranges.
+ * @param panSizes array of nRanges sizes of the ranges (in bytes).
+ *
+ * @since GDAL 3.4
+ */
+
+/**
+ * \brief Advise that the given ranges will be read soon.
+ *
+ * This is a hint that implementations may use to start fetching data in
+ * the background, so that later VSIFReadL() or VSIFReadMultiRangeL() calls
+ * on those ranges can be served without waiting. This is currently
+ * implemented by the /vsicurl/ and related network file systems, which
+ * fill their block cache with the advised ranges.
+ *
+ * The call does not block and does not report errors.
+ *
+ * @param nRanges number of ranges.
+ * @param panOffsets array of nRanges offsets of the ranges.
+ * @param panSizes array of nRanges sizes of the ranges (in bytes).
+ * @param fp file handle opened with VSIFOpenL().
+ *
+ * @since GDAL 3.4
+ */
+
+void VSIFAdviseReadL( int nRanges,
+                      const vsi_l_offset* panOffsets,
+                      const size_t* panSizes, VSILFILE * fp )
+{
+    VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>(fp);
+
+    poFileHandle->AdviseRead(nRanges, panOffsets, panSizes);
+}
+
 /************************************************************************/
 /*                             VSIFWriteL()                             */
 /************************************************************************/
@@ -2360,7 +2447,9 @@ int VSIIngestFile( VSILFILE* fp,
     bool bFreeFP = false;
     if( nullptr == fp )
     {
-        fp = VSIFOpenL( pszFilename, "rb" );
+        const char* const apszOptions[] = { "ACCESS_PATTERN=SEQUENTIAL",
+                                            nullptr };
+        fp = VSIFOpenEx2L( pszFilename, "rb", FALSE, apszOptions );
         if( nullptr == fp )
         {
             CPLError( CE_Failure, CPLE_FileIO,
@@ -2788,32 +2877,103 @@ VSIFilesystemHandler *VSIFileManager::GetHandler( const char *pszPath )
 
 {
     VSIFileManager *poThis = Get();
-    const size_t nPathLen = strlen(pszPath);
-
-    for( std::map<std::string, VSIFilesystemHandler*>::const_iterator iter =
-             poThis->oHandlers.begin();
-         iter != poThis->oHandlers.end();
-         ++iter )
+    const auto& aoTrie = poThis->aoPrefixTrie;
+    if( aoTrie.empty() )
+        return poThis->poDefaultHandler;
+
+    // Several prefixes may match, in which case the lowest one in
+    // lexicographic order wins, as when oHandlers was scanned in order.
+    const std::string* posBestPrefix = nullptr;
+    VSIFilesystemHandler* poBestHandler = nullptr;
+    const auto AddCandidate = [&posBestPrefix, &poBestHandler](
+                                            const PrefixTrieNode& oNode)
+    {
+        if( oNode.posPrefix != nullptr &&
+            (posBestPrefix == nullptr || *oNode.posPrefix < *posBestPrefix) )
+        {
+            posBestPrefix = oNode.posPrefix;
+            poBestHandler = oNode.poHandler;
+        }
+    };
+    const auto GetChild = [&aoTrie](const PrefixTrieNode& oNode, char ch)
+    {
+        const auto oIter = std::lower_bound(
+            oNode.aoChildren.begin(), oNode.aoChildren.end(),
+            std::pair<char, int>(ch, 0),
+            [](const std::pair<char, int>& a, const std::pair<char, int>& b)
+            { return a.first < b.first; });
+        return (oIter != oNode.aoChildren.end() && oIter->first == ch) ?
+            &aoTrie[oIter->second] : nullptr;
+    };
+
+    const PrefixTrieNode* poNode = &aoTrie[0];
+    size_t i = 0;
+    for( ; pszPath[i] != '\0'; ++i )
     {
-        const char* pszIterKey = iter->first.c_str();
-        const size_t nIterKeyLen = iter->first.size();
-        if( strncmp(pszPath, pszIterKey, nIterKeyLen) == 0 )
-            return iter->second;
+        // The prefix pszPath[0:i] matches.
+        AddCandidate(*poNode);
 
         // "/vsimem\foo" should be handled as "/vsimem/foo".
-        if( nIterKeyLen && nPathLen > nIterKeyLen &&
-            pszIterKey[nIterKeyLen-1] == '/' &&
-            pszPath[nIterKeyLen-1] == '\\' &&
-            strncmp(pszPath, pszIterKey, nIterKeyLen - 1) == 0 )
-            return iter->second;
+        if( pszPath[i] == '\\' && pszPath[i+1] != '\0' )
+        {
+            const PrefixTrieNode* poSlash = GetChild(*poNode, '/');
+            if( poSlash )
+                AddCandidate(*poSlash);
+        }
+
+        poNode = GetChild(*poNode, pszPath[i]);
+        if( poNode == nullptr )
+            break;
+    }
+    if( poNode != nullptr )
+    {
+        AddCandidate(*poNode);
 
         // /vsimem should be treated as a match for /vsimem/.
-        if( nPathLen + 1 == nIterKeyLen
-            && strncmp(pszPath, pszIterKey, nPathLen) == 0 )
-            return iter->second;
+        for( const auto& oChild: poNode->aoChildren )
+            AddCandidate(aoTrie[oChild.second]);
     }
 
-    return poThis->poDefaultHandler;
+    return poBestHandler ? poBestHandler : poThis->poDefaultHandler;
+}
+
+/************************************************************************/
+/*                          BuildPrefixTrie()                           */
+/************************************************************************/
+
+void VSIFileManager::BuildPrefixTrie()
+{
+    std::vector<PrefixTrieNode> aoTrie(1);
+    for( const auto& oIter: oHandlers )
+    {
+        size_t iNode = 0;
+        for( const char ch: oIter.first )
+        {
+            auto& aoChildren = aoTrie[iNode].aoChildren;
+            auto oChildIter = std::lower_bound(
+                aoChildren.begin(), aoChildren.end(),
+                std::pair<char, int>(ch, 0),
+                [](const std::pair<char, int>& a,
+                   const std::pair<char, int>& b)
+                { return a.first < b.first; });
+            if( oChildIter != aoChildren.end() && oChildIter->first == ch )
+            {
+                iNode = oChildIter->second;
+            }
+            else
+            {
+                const int iNewNode = static_cast<int>(aoTrie.size());
+                aoChildren.insert(oChildIter,
+                                  std::pair<char, int>(ch, iNewNode));
+                // aoChildren may be invalidated by the following line
+                aoTrie.emplace_back();
+                iNode = iNewNode;
+            }
+        }
+        aoTrie[iNode].posPrefix = &oIter.first;
+        aoTrie[iNode].poHandler = oIter.second;
+    }
+    aoPrefixTrie = std::move(aoTrie);
 }
 
 /************************************************************************/
@@ -2827,7 +2987,10 @@ void VSIFileManager::InstallHandler( const std::string& osPrefix,
     if( osPrefix == "" )
         Get()->poDefaultHandler = poHandler;
     else
+    {
         Get()->oHandlers[osPrefix] = poHandler;
+        Get()->BuildPrefixTrie();
+    }
 }
 
 /************************************************************************/
@@ -2885,6 +3048,45 @@ int VSIVirtualHandle::Truncate( vsi_l_offset nNewSize )
     return -1;
 }
 
+/************************************************************************/
+/*                              PRead()                                 */
+/************************************************************************/
+
+/**
+ * \fn VSIVirtualHandle::HasPRead() const
+ * \brief Returns whether this file handle supports the PRead() method.
+ *
+ * @since GDAL 3.4
+ */
+
+/**
+ * \brief Do a parallel-compatible read operation.
+ *
+ * This methods reads into pBuffer up to nSize bytes starting at offset nOffset
+ * in the file. The current file offset is not affected by this method.
+ *
+ * The implementation is thread-safe: several threads can issue PRead()
+ * concurrently on the same VSIVirtualHandle object.
+ *
+ * This method has the same semantics as pread() Linux operation.
+ *
+ * This is only available if HasPRead() returns true.
+ *
+ * @param pBuffer output buffer (must be at least nSize bytes large).
+ * @param nSize number of bytes to read in the file.
+ * @param nOffset file offset from which to read.
+ * @return number of bytes read.
+ * @since GDAL 3.4
+ */
+
+size_t VSIVirtualHandle::PRead( void* /* pBuffer */, size_t /* nSize */,
+                                vsi_l_offset /* nOffset */ ) const
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "PRead() not implemented for this file handle");
+    return 0;
+}
+
 /************************************************************************/
 /*                           ReadMultiRange()                           */
 /************************************************************************/
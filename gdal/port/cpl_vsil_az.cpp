@@ -952,6 +952,32 @@ class VSIAzureWriteHandle final : public VSIAppendWriteHandle
     std::unique_ptr<VSIAzureBlobHandleHelper> m_poHandleHelper{};
     CPLStringList                             m_aosOptions{};
 
+    // Parallel block upload
+    struct UploadJob
+    {
+        VSIAzureWriteHandle *poParent = nullptr;
+        GByte              *pabyBuffer = nullptr;
+        size_t              nSize = 0;
+        int                 nBlockNumber = 0;
+    };
+
+    int                 m_nUploadThreads = 1;
+    int                 m_nMaxRetry = 0;
+    double              m_dfRetryDelay = 0.0;
+    int                 m_nBlockNumber = 0;
+    std::vector<CPLString> m_aosBlockIds{};
+    int                 m_nAllocatedBuffers = 1;
+    std::unique_ptr<CPLWorkerThreadPool> m_poUploadPool{};
+    std::vector<GByte*> m_apabyFreeBuffers{};
+    bool                m_bUploadError = false;
+    std::mutex          m_oUploadMutex{};
+    std::condition_variable m_oUploadCV{};
+
+    static void         PutBlockJob( void* pData );
+    bool                SubmitPutBlock();
+    bool                WaitPendingUploads();
+    bool                SendBlockList();
+
     bool                Send(bool bIsLastBlock) override;
     bool                SendInternal(bool bInitOnly, bool bIsLastBlock);
 
@@ -1000,6 +1026,24 @@ VSIAzureWriteHandle::VSIAzureWriteHandle( VSIAzureFSHandler* poFS,
         m_poHandleHelper(poHandleHelper),
         m_aosOptions(papszOptions)
 {
+    // Number of blocks that may be uploaded concurrently. The blob is then
+    // written as a block blob rather than an append blob. Each in-flight
+    // block owns one buffer, so the memory used is bounded by
+    // (m_nUploadThreads + 1) * m_nBufferSize.
+    const char* pszThreads =
+        CPLGetConfigOption("VSIAZ_UPLOAD_NUM_THREADS", "1");
+    if( EQUAL(pszThreads, "ALL_CPUS") )
+        m_nUploadThreads = CPLGetNumCPUs();
+    else
+        m_nUploadThreads = atoi(pszThreads);
+    m_nUploadThreads = std::max(1, std::min(128, m_nUploadThreads));
+
+    // coverity[tainted_data]
+    m_nMaxRetry = atoi(CPLGetConfigOption("GDAL_HTTP_MAX_RETRY",
+                                   CPLSPrintf("%d",CPL_HTTP_MAX_RETRY)));
+    // coverity[tainted_data]
+    m_dfRetryDelay = CPLAtof(CPLGetConfigOption("GDAL_HTTP_RETRY_DELAY",
+                                CPLSPrintf("%f", CPL_HTTP_RETRY_DELAY)));
 }
 
 /************************************************************************/
@@ -1009,6 +1053,9 @@ VSIAzureWriteHandle::VSIAzureWriteHandle( VSIAzureFSHandler* poFS,
 VSIAzureWriteHandle::~VSIAzureWriteHandle()
 {
     Close();
+    m_poUploadPool.reset();
+    for( GByte* pabyBuffer: m_apabyFreeBuffers )
+        CPLFree(pabyBuffer);
 }
 
 /************************************************************************/
@@ -1032,6 +1079,19 @@ void VSIAzureWriteHandle::InvalidateParentDirectory()
 
 bool VSIAzureWriteHandle::Send(bool bIsLastBlock)
 {
+    if( m_nUploadThreads > 1 &&
+        (!bIsLastBlock ||
+         m_nCurOffset > static_cast<vsi_l_offset>(m_nBufferSize)) )
+    {
+        if( m_nBufferOff > 0 && !SubmitPutBlock() )
+        {
+            if( bIsLastBlock )
+                WaitPendingUploads();
+            return false;
+        }
+        return !bIsLastBlock || SendBlockList();
+    }
+
     if( !bIsLastBlock )
     {
         CPLAssert( m_nBufferOff == m_nBufferSize );
@@ -1045,6 +1105,176 @@ bool VSIAzureWriteHandle::Send(bool bIsLastBlock)
     return SendInternal( false, bIsLastBlock );
 }
 
+/************************************************************************/
+/*                            PutBlockJob()                             */
+/************************************************************************/
+
+void VSIAzureWriteHandle::PutBlockJob( void* pData )
+{
+    UploadJob* psJob = static_cast<UploadJob*>(pData);
+    VSIAzureWriteHandle* poThis = psJob->poParent;
+    VSIAzureFSHandler* poFS =
+        cpl::down_cast<VSIAzureFSHandler*>(poThis->m_poFS);
+
+    bool bSkip;
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oUploadMutex);
+        bSkip = poThis->m_bUploadError;
+    }
+
+    CPLString osBlockId;
+    if( !bSkip )
+    {
+        // PutBlock() modifies the query parameters of the helper, so
+        // each job needs its own one.
+        std::unique_ptr<VSIAzureBlobHandleHelper> poHandleHelper(
+            VSIAzureBlobHandleHelper::BuildFromURI(
+                poThis->m_osFilename.c_str() + poFS->GetFSPrefix().size(),
+                poFS->GetFSPrefix().c_str()));
+        if( poHandleHelper )
+        {
+            osBlockId = poFS->PutBlock(
+                poThis->m_osFilename, psJob->nBlockNumber,
+                psJob->pabyBuffer, psJob->nSize, poHandleHelper.get(),
+                poThis->m_nMaxRetry, poThis->m_dfRetryDelay);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oUploadMutex);
+        if( osBlockId.empty() )
+            poThis->m_bUploadError = true;
+        else
+            poThis->m_aosBlockIds[psJob->nBlockNumber - 1] = osBlockId;
+        poThis->m_apabyFreeBuffers.push_back(psJob->pabyBuffer);
+    }
+    poThis->m_oUploadCV.notify_one();
+    delete psJob;
+}
+
+/************************************************************************/
+/*                          SubmitPutBlock()                            */
+/************************************************************************/
+
+// Uploads m_pabyBuffer as the next block. The first block is sent from this
+// thread, so that an existing blob of another type is replaced before other
+// blocks are sent. Next ones are handed over to a worker thread, and a new
+// buffer is acquired, waiting if all of them are currently being uploaded.
+bool VSIAzureWriteHandle::SubmitPutBlock()
+{
+    m_nBlockNumber ++;
+    if( m_nBlockNumber > 50000 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%d blocks have been uploaded for %s, which is the maximum. "
+                 "Increase VSIAZ_CHUNK_SIZE to a higher value.",
+                 m_nBlockNumber - 1, m_osFilename.c_str());
+        return false;
+    }
+    m_aosBlockIds.resize(m_nBlockNumber);
+
+    if( m_nBlockNumber == 1 )
+    {
+        VSIAzureFSHandler* poFS = cpl::down_cast<VSIAzureFSHandler*>(m_poFS);
+        m_aosBlockIds[0] = poFS->PutBlock(m_osFilename, m_nBlockNumber,
+                                          m_pabyBuffer, m_nBufferOff,
+                                          m_poHandleHelper.get(),
+                                          m_nMaxRetry, m_dfRetryDelay);
+        return !m_aosBlockIds[0].empty();
+    }
+
+    if( !m_poUploadPool )
+    {
+        auto poPool = std::unique_ptr<CPLWorkerThreadPool>(
+                                                new CPLWorkerThreadPool());
+        if( !poPool->Setup(m_nUploadThreads, nullptr, nullptr, false) )
+            return false;
+        m_poUploadPool = std::move(poPool);
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(m_oUploadMutex);
+        if( m_bUploadError )
+            return false;
+    }
+
+    UploadJob* psJob = new UploadJob();
+    psJob->poParent = this;
+    psJob->pabyBuffer = m_pabyBuffer;
+    psJob->nSize = m_nBufferOff;
+    psJob->nBlockNumber = m_nBlockNumber;
+    if( !m_poUploadPool->SubmitJob(PutBlockJob, psJob) )
+    {
+        delete psJob;
+        return false;
+    }
+    m_pabyBuffer = nullptr;
+    m_nBufferOff = 0;
+
+    std::unique_lock<std::mutex> oLock(m_oUploadMutex);
+    while( m_apabyFreeBuffers.empty() &&
+           m_nAllocatedBuffers > m_nUploadThreads &&
+           !m_bUploadError )
+    {
+        m_oUploadCV.wait(oLock);
+    }
+    if( m_bUploadError )
+        return false;
+    if( !m_apabyFreeBuffers.empty() )
+    {
+        m_pabyBuffer = m_apabyFreeBuffers.back();
+        m_apabyFreeBuffers.pop_back();
+    }
+    else
+    {
+        m_pabyBuffer = static_cast<GByte *>(VSIMalloc(m_nBufferSize));
+        if( m_pabyBuffer == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                    "Cannot allocate working buffer for %s",
+                     m_osFSPrefix.c_str());
+            return false;
+        }
+        m_nAllocatedBuffers++;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                        WaitPendingUploads()                          */
+/************************************************************************/
+
+bool VSIAzureWriteHandle::WaitPendingUploads()
+{
+    if( !m_poUploadPool )
+        return true;
+    m_poUploadPool->WaitCompletion();
+    std::lock_guard<std::mutex> oLock(m_oUploadMutex);
+    return !m_bUploadError;
+}
+
+/************************************************************************/
+/*                           SendBlockList()                            */
+/************************************************************************/
+
+// Commits the uploaded blocks, in order, once all of them are uploaded.
+// Blocks left uncommitted after an error are discarded by the service.
+bool VSIAzureWriteHandle::SendBlockList()
+{
+    if( !WaitPendingUploads() )
+        return false;
+
+    VSIAzureFSHandler* poFS = cpl::down_cast<VSIAzureFSHandler*>(m_poFS);
+    if( !poFS->PutBlockList(m_osFilename, m_aosBlockIds,
+                            m_poHandleHelper.get(),
+                            m_nMaxRetry, m_dfRetryDelay) )
+    {
+        return false;
+    }
+    InvalidateParentDirectory();
+    return true;
+}
+
 /************************************************************************/
 /*                          SendInternal()                              */
 /************************************************************************/
@@ -1819,7 +2049,11 @@ const char* VSIAzureFSHandler::GetOptions()
         "description='Secret key'/>"
     "  <Option name='VSIAZ_CHUNK_SIZE' type='int' "
         "description='Size in MB for chunks of files that are uploaded' "
-        "default='4' min='1' max='4'/>" +
+        "default='4' min='1' max='4'/>"
+    "  <Option name='VSIAZ_UPLOAD_NUM_THREADS' type='string' "
+        "description='Number of threads used to upload chunks in parallel, "
+        "as blocks of a block blob. Integer value or ALL_CPUS. Each thread "
+        "uses a buffer of VSIAZ_CHUNK_SIZE' default='1'/>" +
         VSICurlFilesystemHandler::GetOptionsStatic() +
         "</Options>");
     return osOptions.c_str();
@@ -128,6 +128,9 @@ class VSICachedFile final : public VSIVirtualHandle
     int ReadMultiRange( int nRanges, void ** ppData,
                         const vsi_l_offset* panOffsets,
                         const size_t* panSizes ) override;
+    void AdviseRead( int nRanges, const vsi_l_offset* panOffsets,
+                     const size_t* panSizes ) override
+        { poBase->AdviseRead( nRanges, panOffsets, panSizes ); }
 
     size_t Write( const void *pBuffer, size_t nSize,
                   size_t nMemb ) override;
@@ -32,6 +32,8 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <deque>
 #include <set>
 #include <map>
 #include <memory>
@@ -39,6 +41,7 @@
 #include "cpl_aws.h"
 #include "cpl_json.h"
 #include "cpl_json_header.h"
+#include "cpl_md5.h"
 #include "cpl_minixml.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
@@ -48,6 +51,10 @@
 #include "cpl_http.h"
 #include "cpl_mem_cache.h"
 
+#ifndef _WIN32
+#include <utime.h>
+#endif
+
 #ifndef S_IRUSR
 #define S_IRUSR     00400
 #define S_IWUSR     00200
@@ -136,12 +143,17 @@ void VSICurlAuthParametersChanged()
     gnGenerationAuthParameters++;
 }
 
+static CURLSH* VSICurlGetShareHandle();
+// Connections kept open by the process-wide multi handle
+constexpr long VSICURL_SHARED_MAX_CONNECTS = 256;
+
 namespace cpl {
 
-// Do not access those 2 variables directly !
-// Use VSICURLGetDownloadChunkSize() and GetMaxRegions()
+// Do not access those 3 variables directly !
+// Use VSICURLGetDownloadChunkSize(), GetMaxRegions() and GetCacheSize()
 static int N_MAX_REGIONS_DO_NOT_USE_DIRECTLY = 1000;
 static int DOWNLOAD_CHUNK_SIZE_DO_NOT_USE_DIRECTLY = 16384;
+static GIntBig CACHE_SIZE_DO_NOT_USE_DIRECTLY = 16384000;
 
 /************************************************************************/
 /*                    VSICURLReadGlobalEnvVariables()                   */
@@ -168,6 +180,7 @@ static void VSICURLReadGlobalEnvVariables()
             }
             N_MAX_REGIONS_DO_NOT_USE_DIRECTLY = std::max(1,
                 static_cast<int>(nCacheSize / DOWNLOAD_CHUNK_SIZE_DO_NOT_USE_DIRECTLY));
+            CACHE_SIZE_DO_NOT_USE_DIRECTLY = nCacheSize;
         }
     };
     static Initializer initializer;
@@ -193,6 +206,16 @@ static int GetMaxRegions()
     return N_MAX_REGIONS_DO_NOT_USE_DIRECTLY;
 }
 
+/************************************************************************/
+/*                            GetCacheSize()                            */
+/************************************************************************/
+
+static GIntBig GetCacheSize()
+{
+    VSICURLReadGlobalEnvVariables();
+    return CACHE_SIZE_DO_NOT_USE_DIRECTLY;
+}
+
 
 /************************************************************************/
 /*          VSICurlFindStringSensitiveExceptEscapeSequences()           */
@@ -394,8 +417,21 @@ VSICurlHandle::VSICurlHandle( VSICurlFilesystemHandler* poFSIn,
     // coverity[tainted_data]
     m_dfRetryDelay(CPLAtof(CPLGetConfigOption("GDAL_HTTP_RETRY_DELAY",
                                 CPLSPrintf("%f", CPL_HTTP_RETRY_DELAY)))),
+    m_bHedgeRequests(CPLTestBool(
+        CPLGetConfigOption("CPL_VSIL_CURL_HEDGED_REQUESTS", "NO"))),
+    m_dfHedgePercentile(CPLAtof(
+        CPLGetConfigOption("CPL_VSIL_CURL_HEDGE_PERCENTILE", "95"))),
+    m_dfHedgeMinDelay(CPLAtof(
+        CPLGetConfigOption("CPL_VSIL_CURL_HEDGE_MIN_DELAY", "0.1"))),
     m_bUseHead(CPLTestBool(CPLGetConfigOption("CPL_VSIL_CURL_USE_HEAD",
-                                             "YES")))
+                                             "YES"))),
+    m_bAdaptiveReadahead(CPLTestBool(
+        CPLGetConfigOption("CPL_VSIL_CURL_ADAPTIVE_READAHEAD", "YES"))),
+    m_nParallelReadThreshold(static_cast<size_t>(std::max(
+        static_cast<GIntBig>(0), CPLAtoGIntBig(CPLGetConfigOption(
+            "CPL_VSIL_CURL_PARALLEL_READ_THRESHOLD", "16777216"))))),
+    m_nParallelReadConnections(atoi(
+        CPLGetConfigOption("CPL_VSIL_CURL_PARALLEL_READ_CONNECTIONS", "4")))
 {
     m_papszHTTPOptions = CPLHTTPGetOptionsFromEnv();
     if( pszURLIn )
@@ -422,6 +458,11 @@ VSICurlHandle::VSICurlHandle( VSICurlFilesystemHandler* poFSIn,
 
 VSICurlHandle::~VSICurlHandle()
 {
+    if( m_poAdviseReadPool )
+    {
+        m_bAdviseReadInterrupted = true;
+        m_poAdviseReadPool.reset();
+    }
     if( !m_bCached )
     {
         poFS->InvalidateCachedData(m_pszURL);
@@ -556,6 +597,9 @@ void VSICURLInitWriteFuncStruct( WriteFuncStruct   *psStruct,
 {
     psStruct->pBuffer = nullptr;
     psStruct->nSize = 0;
+    psStruct->poSlabPool = nullptr;
+    psStruct->nSlabSize = 0;
+    psStruct->apoSlabs.clear();
     psStruct->bIsHTTP = false;
     psStruct->bIsInHeader = true;
     psStruct->bMultiRange = false;
@@ -589,6 +633,41 @@ size_t VSICurlHandleWriteFunc( void *buffer, size_t count,
     WriteFuncStruct* psStruct = static_cast<WriteFuncStruct *>(req);
     const size_t nSize = count * nmemb;
 
+    if( psStruct->poSlabPool != nullptr )
+    {
+        const char* pabySrc = static_cast<const char*>(buffer);
+        size_t nRemaining = nSize;
+        while( nRemaining > 0 )
+        {
+            if( psStruct->apoSlabs.empty() ||
+                psStruct->apoSlabs.back()->size() == psStruct->nSlabSize )
+            {
+                auto poSlab = psStruct->poSlabPool->Acquire(psStruct->nSlabSize);
+                if( poSlab == nullptr )
+                    return 0;
+                psStruct->apoSlabs.push_back(std::move(poSlab));
+            }
+            VSICurlSlab* poSlab = psStruct->apoSlabs.back().get();
+            const size_t nToCopy =
+                std::min(nRemaining, psStruct->nSlabSize - poSlab->size());
+            memcpy(poSlab->data() + poSlab->size(), pabySrc, nToCopy);
+            poSlab->resize(poSlab->size() + nToCopy);
+            pabySrc += nToCopy;
+            nRemaining -= nToCopy;
+        }
+        if( psStruct->pfnReadCbk )
+        {
+            if( !psStruct->pfnReadCbk(psStruct->fp, buffer, nSize,
+                                      psStruct->pReadCbkUserData) )
+            {
+                psStruct->bInterrupted = true;
+                return 0;
+            }
+        }
+        psStruct->nSize += nSize;
+        return nmemb;
+    }
+
     char* pNewBuffer = static_cast<char *>(
         VSIRealloc(psStruct->pBuffer, psStruct->nSize + nSize + 1));
     if( pNewBuffer )
@@ -695,9 +774,8 @@ size_t VSICurlHandleWriteFunc( void *buffer, size_t count,
                          psStruct->nContentLength > 10 *
                          (psStruct->nEndOffset - psStruct->nStartOffset + 1)) )
                     {
-                        CPLError(CE_Failure, CPLE_AppDefined,
-                                 "Range downloading not supported by this "
-                                 "server!");
+                        // Reported by VSICURLReportWriteFuncError(), as
+                        // this may run in the thread of VSICurlSharedMulti.
                         psStruct->bError = true;
                         return 0;
                     }
@@ -793,12 +871,281 @@ static GIntBig VSICurlGetExpiresFromS3LikeSignedURL( const char* pszURL )
     return CPLYMDHMSToUnixTime(&brokendowntime) + nDelay;
 }
 
+/************************************************************************/
+/*                    VSICURLReportWriteFuncError()                     */
+/************************************************************************/
+
+// Report in the requesting thread the error detected by
+// VSICurlHandleWriteFunc() while receiving the headers of sHeaderData.
+static void VSICURLReportWriteFuncError( const WriteFuncStruct& sHeaderData )
+{
+    if( sHeaderData.bError )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Range downloading not supported by this server!");
+    }
+}
+
+/************************************************************************/
+/*                          VSICurlSharedMulti                          */
+/************************************************************************/
+
+// Process-wide multi handle, used when CPL_VSIL_CURL_SHARED_CONNECTIONS is
+// set. libcurl does not support sharing a connection cache between multi
+// handles driven from different threads, so the single transfers of all
+// threads are instead added to this multi handle, which is serviced by one
+// background thread. Its connections are thus reused by all threads,
+// HTTP/2 transfers to the same host are multiplexed, and
+// CPL_VSIL_CURL_MAX_HOST_CONNECTIONS caps the connections of the process.
+// The callbacks of those transfers run in the background thread while the
+// requesting thread waits for their completion, so they must not depend on
+// the error handlers or configuration options of the requesting thread:
+// transfers invoking a user read callback are not run there.
+
+#if CURL_AT_LEAST_VERSION(7,68,0)
+namespace {
+class VSICurlSharedMulti
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSICurlSharedMulti)
+
+    struct Request
+    {
+        CURL*       hEasyHandle = nullptr;
+        bool        bDone = false;
+        CURLMcode   eAddError = CURLM_OK;
+        std::condition_variable oCV{};
+    };
+
+    CURLM*      m_hMulti = nullptr;
+    std::mutex  m_oMutex{};
+    std::condition_variable m_oCV{};
+    std::vector<Request*> m_apoPending{};
+    CPLJoinableThread* m_hThread = nullptr;
+    bool        m_bStop = false;
+
+    static void ThreadFunc( void* pData );
+
+  public:
+    VSICurlSharedMulti();
+    ~VSICurlSharedMulti();
+
+    static VSICurlSharedMulti* Get();
+
+    bool        Perform( CURL* hEasyHandle );
+    void        StopThread();
+};
+
+/************************************************************************/
+/*                         VSICurlSharedMulti()                         */
+/************************************************************************/
+
+VSICurlSharedMulti::VSICurlSharedMulti()
+{
+    m_hMulti = curl_multi_init();
+    if( m_hMulti == nullptr )
+        return;
+    curl_multi_setopt(m_hMulti, CURLMOPT_PIPELINING,
+                      static_cast<long>(CURLPIPE_MULTIPLEX));
+    curl_multi_setopt(m_hMulti, CURLMOPT_MAXCONNECTS,
+                      VSICURL_SHARED_MAX_CONNECTS);
+    const long nMaxHostConnections = atoi(
+        CPLGetConfigOption("CPL_VSIL_CURL_MAX_HOST_CONNECTIONS", "0"));
+    if( nMaxHostConnections > 0 )
+    {
+        curl_multi_setopt(m_hMulti, CURLMOPT_MAX_HOST_CONNECTIONS,
+                          nMaxHostConnections);
+    }
+}
+
+/************************************************************************/
+/*                        ~VSICurlSharedMulti()                         */
+/************************************************************************/
+
+VSICurlSharedMulti::~VSICurlSharedMulti()
+{
+    StopThread();
+    if( m_hMulti )
+        curl_multi_cleanup(m_hMulti);
+}
+
+/************************************************************************/
+/*                                Get()                                 */
+/************************************************************************/
+
+VSICurlSharedMulti* VSICurlSharedMulti::Get()
+{
+    if( VSICurlGetShareHandle() == nullptr )
+        return nullptr;
+    static std::unique_ptr<VSICurlSharedMulti> poSharedMulti(
+                                                    new VSICurlSharedMulti());
+    return poSharedMulti->m_hMulti ? poSharedMulti.get() : nullptr;
+}
+
+/************************************************************************/
+/*                              Perform()                               */
+/************************************************************************/
+
+// Run the transfer of hEasyHandle in the background thread and wait for its
+// completion. Returns false if the thread could not be started.
+bool VSICurlSharedMulti::Perform( CURL* hEasyHandle )
+{
+    Request oRequest;
+    oRequest.hEasyHandle = hEasyHandle;
+
+    {
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        if( m_hThread == nullptr )
+        {
+            m_hThread = CPLCreateJoinableThread(ThreadFunc, this);
+            if( m_hThread == nullptr )
+            {
+                CPLDebug("VSICURL", "Cannot start the thread of the shared "
+                         "connections. Using a per-thread connection");
+                return false;
+            }
+        }
+        m_apoPending.push_back(&oRequest);
+        m_oCV.notify_one();
+        // Interrupt curl_multi_poll() if transfers are already running.
+        curl_multi_wakeup(m_hMulti);
+        oRequest.oCV.wait(oLock, [&oRequest] { return oRequest.bDone; });
+    }
+
+    if( oRequest.eAddError != CURLM_OK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "curl_multi_add_handle() failed: %s",
+                 curl_multi_strerror(oRequest.eAddError));
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             StopThread()                             */
+/************************************************************************/
+
+// Wait for the running transfers to complete and stop the background
+// thread. It is restarted by the next Perform().
+void VSICurlSharedMulti::StopThread()
+{
+    CPLJoinableThread* hThread;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        hThread = m_hThread;
+        if( hThread == nullptr )
+            return;
+        m_bStop = true;
+    }
+    m_oCV.notify_all();
+    curl_multi_wakeup(m_hMulti);
+    CPLJoinThread(hThread);
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_hThread = nullptr;
+    m_bStop = false;
+}
+
+/************************************************************************/
+/*                             ThreadFunc()                             */
+/************************************************************************/
+
+void VSICurlSharedMulti::ThreadFunc( void* pData )
+{
+    VSICurlSharedMulti* poThis = static_cast<VSICurlSharedMulti*>(pData);
+    std::map<CURL*, Request*> oMapRunning;
+
+    void* old_handler = CPLHTTPIgnoreSigPipe();
+    while( true )
+    {
+        {
+            std::unique_lock<std::mutex> oLock(poThis->m_oMutex);
+            if( oMapRunning.empty() )
+            {
+                poThis->m_oCV.wait(oLock, [poThis]
+                    { return poThis->m_bStop ||
+                             !poThis->m_apoPending.empty(); });
+                if( poThis->m_apoPending.empty() )
+                    break;
+            }
+            for( Request* poRequest: poThis->m_apoPending )
+            {
+                poRequest->eAddError = curl_multi_add_handle(
+                    poThis->m_hMulti, poRequest->hEasyHandle);
+                if( poRequest->eAddError != CURLM_OK )
+                {
+                    poRequest->bDone = true;
+                    poRequest->oCV.notify_one();
+                    continue;
+                }
+                oMapRunning[poRequest->hEasyHandle] = poRequest;
+            }
+            poThis->m_apoPending.clear();
+        }
+
+        int still_running;
+        while( curl_multi_perform(poThis->m_hMulti, &still_running) ==
+                                        CURLM_CALL_MULTI_PERFORM )
+        {
+            // loop
+        }
+
+        int msgq = 0;
+        while( CURLMsg* msg = curl_multi_info_read(poThis->m_hMulti, &msgq) )
+        {
+            if( msg->msg != CURLMSG_DONE )
+                continue;
+            CURL* hEasyHandle = msg->easy_handle;
+            curl_multi_remove_handle(poThis->m_hMulti, hEasyHandle);
+            auto oIter = oMapRunning.find(hEasyHandle);
+            if( oIter == oMapRunning.end() )
+                continue;
+            // Notify with the lock held, as the request is destroyed as
+            // soon as its thread sees bDone.
+            std::lock_guard<std::mutex> oLock(poThis->m_oMutex);
+            oIter->second->bDone = true;
+            oIter->second->oCV.notify_one();
+            oMapRunning.erase(oIter);
+        }
+
+        if( !oMapRunning.empty() )
+            curl_multi_poll(poThis->m_hMulti, nullptr, 0, 1000, nullptr);
+    }
+    CPLHTTPRestoreSigPipeHandler(old_handler);
+}
+} // namespace
+#endif // CURL_AT_LEAST_VERSION(7,68,0)
+
+/************************************************************************/
+/*                    VSICurlStopSharedMultiThread()                    */
+/************************************************************************/
+
+static void VSICurlStopSharedMultiThread()
+{
+#if CURL_AT_LEAST_VERSION(7,68,0)
+    VSICurlSharedMulti* poSharedMulti = VSICurlSharedMulti::Get();
+    if( poSharedMulti )
+        poSharedMulti->StopThread();
+#endif
+}
+
 /************************************************************************/
 /*                           MultiPerform()                             */
 /************************************************************************/
 
-void MultiPerform(CURLM* hCurlMultiHandle, CURL* hEasyHandle)
+// Unless bCallbacksInCallingThread is set, a single transfer may be run by
+// VSICurlSharedMulti.
+void MultiPerform(CURLM* hCurlMultiHandle, CURL* hEasyHandle,
+                  CPL_UNUSED bool bCallbacksInCallingThread)
 {
+#if CURL_AT_LEAST_VERSION(7,68,0)
+    if( hEasyHandle && !bCallbacksInCallingThread )
+    {
+        VSICurlSharedMulti* poSharedMulti = VSICurlSharedMulti::Get();
+        if( poSharedMulti && poSharedMulti->Perform(hEasyHandle) )
+            return;
+    }
+#endif
+
     int repeats = 0;
 
     if( hEasyHandle )
@@ -1386,18 +1733,237 @@ CPLString VSICurlHandle::GetRedirectURLIfValid(bool& bHasExpired)
     return osURL;
 }
 
+/************************************************************************/
+/*                         MultiPerformHedged()                         */
+/************************************************************************/
+
+// Run the range request hCurlHandle. If no byte of the response has been
+// received after a delay derived from the time to first byte of previous
+// requests, a duplicate request is issued on the same multi handle, and
+// the first one to succeed wins. The transfer data of the winner is
+// stored in sWriteFuncData, sWriteFuncHeaderData and pszCurlErrBuf, and
+// its handle is returned. The other handle is cleaned up.
+
+CURL* VSICurlHandle::MultiPerformHedged( CURLM* hCurlMultiHandle,
+                                         CURL* hCurlHandle,
+                                         WriteFuncStruct& sWriteFuncData,
+                                         WriteFuncStruct& sWriteFuncHeaderData,
+                                         char* pszCurlErrBuf )
+{
+    using namespace std::chrono;
+    const auto nStart = steady_clock::now();
+    const auto GetElapsed = [&nStart]()
+    {
+        return duration_cast<duration<double>>(
+                    steady_clock::now() - nStart).count();
+    };
+
+    // Do not hedge until enough latencies have been measured
+    double dfHedgeDelay =
+        poFS->GetFirstByteLatencyPercentile(m_dfHedgePercentile);
+    if( dfHedgeDelay >= 0 )
+        dfHedgeDelay = std::max(dfHedgeDelay, m_dfHedgeMinDelay);
+
+    struct Transfer
+    {
+        CURL*           hCurlHandle = nullptr;
+        WriteFuncStruct sWriteFuncData{};
+        WriteFuncStruct sWriteFuncHeaderData{};
+        char            szCurlErrBuf[CURL_ERROR_SIZE+1] = {};
+        bool            bDone = false;
+        bool            bSuccess = false;
+    };
+    Transfer asTransfers[2];
+    int nTransfers = 1;
+    asTransfers[0].hCurlHandle = hCurlHandle;
+    curl_multi_add_handle(hCurlMultiHandle, hCurlHandle);
+
+    const auto StartHedge = [&]()
+    {
+        CURL* hHedge = curl_easy_duphandle(hCurlHandle);
+        if( hHedge == nullptr )
+            return;
+        Transfer& oHedge = asTransfers[1];
+        oHedge.hCurlHandle = hHedge;
+        oHedge.sWriteFuncData = sWriteFuncData;
+        oHedge.sWriteFuncData.pBuffer = nullptr;
+        oHedge.sWriteFuncData.apoSlabs.clear();
+        oHedge.sWriteFuncHeaderData = sWriteFuncHeaderData;
+        oHedge.sWriteFuncHeaderData.pBuffer = nullptr;
+        curl_easy_setopt(hHedge, CURLOPT_WRITEDATA, &oHedge.sWriteFuncData);
+        curl_easy_setopt(hHedge, CURLOPT_HEADERDATA,
+                         &oHedge.sWriteFuncHeaderData);
+        curl_easy_setopt(hHedge, CURLOPT_ERRORBUFFER, oHedge.szCurlErrBuf);
+        curl_multi_add_handle(hCurlMultiHandle, hHedge);
+        nTransfers = 2;
+    };
+
+    // Point the primary transfer to our own structures, so that both are
+    // handled the same way.
+    Transfer& oPrimary = asTransfers[0];
+    oPrimary.sWriteFuncData = sWriteFuncData;
+    oPrimary.sWriteFuncHeaderData = sWriteFuncHeaderData;
+    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &oPrimary.sWriteFuncData);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA,
+                     &oPrimary.sWriteFuncHeaderData);
+    curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER, oPrimary.szCurlErrBuf);
+
+    int iWinner = -1;
+    int repeats = 0;
+    void* old_handler = CPLHTTPIgnoreSigPipe();
+    while( true )
+    {
+        int still_running = 0;
+        while( curl_multi_perform(hCurlMultiHandle, &still_running) ==
+                                        CURLM_CALL_MULTI_PERFORM )
+        {
+            // loop
+        }
+
+        CURLMsg *msg = nullptr;
+        int msgq = 0;
+        while( (msg = curl_multi_info_read(hCurlMultiHandle, &msgq)) != nullptr )
+        {
+            if( msg->msg != CURLMSG_DONE )
+                continue;
+            for( int i = 0; i < nTransfers; i++ )
+            {
+                Transfer& oTransfer = asTransfers[i];
+                if( msg->easy_handle != oTransfer.hCurlHandle )
+                    continue;
+                oTransfer.bDone = true;
+                long response_code = 0;
+                curl_easy_getinfo(oTransfer.hCurlHandle, CURLINFO_HTTP_CODE,
+                                  &response_code);
+                oTransfer.bSuccess =
+                    msg->data.result == CURLE_OK &&
+                    !oTransfer.sWriteFuncHeaderData.bError &&
+                    response_code >= 200 && response_code < 300;
+            }
+        }
+
+        // First successful transfer wins. If none succeeds, the primary
+        // one is used, so that the usual error handling applies.
+        bool bAllDone = true;
+        for( int i = 0; i < nTransfers; i++ )
+        {
+            if( asTransfers[i].bSuccess && iWinner < 0 )
+                iWinner = i;
+            bAllDone &= asTransfers[i].bDone;
+        }
+        if( iWinner < 0 && bAllDone )
+            iWinner = 0;
+        if( iWinner >= 0 || !still_running )
+            break;
+
+        const bool bCanHedge = nTransfers == 1 && dfHedgeDelay >= 0 &&
+            oPrimary.sWriteFuncHeaderData.nSize == 0;
+        if( bCanHedge )
+        {
+            const double dfRemaining = dfHedgeDelay - GetElapsed();
+            if( dfRemaining <= 0 )
+            {
+                CPLDebug(poFS->GetDebugKey(),
+                         "No response after %.3f s. Hedging request for %s",
+                         dfHedgeDelay, m_pszURL);
+                StartHedge();
+                continue;
+            }
+#if CURL_AT_LEAST_VERSION(7,28,0)
+            int numfds = 0;
+            curl_multi_wait(hCurlMultiHandle, nullptr, 0,
+                            std::max(1, std::min(1000,
+                                static_cast<int>(dfRemaining * 1000))),
+                            &numfds);
+            continue;
+#endif
+        }
+        CPLMultiPerformWait(hCurlMultiHandle, repeats);
+    }
+    CPLHTTPRestoreSigPipeHandler(old_handler);
+    if( iWinner < 0 )
+        iWinner = 0;
+
+    // Record the time to first byte of the primary request, or a lower
+    // bound of it if it did not get any.
+    double dfFirstByteLatency = 0;
+    if( oPrimary.sWriteFuncHeaderData.nSize > 0 &&
+        curl_easy_getinfo(hCurlHandle, CURLINFO_STARTTRANSFER_TIME,
+                          &dfFirstByteLatency) == CURLE_OK &&
+        dfFirstByteLatency > 0 )
+    {
+        poFS->AddFirstByteLatency(dfFirstByteLatency);
+    }
+    else
+    {
+        poFS->AddFirstByteLatency(GetElapsed());
+    }
+
+    for( int i = 0; i < nTransfers; i++ )
+    {
+        Transfer& oTransfer = asTransfers[i];
+        curl_multi_remove_handle(hCurlMultiHandle, oTransfer.hCurlHandle);
+        NetworkStatisticsLogger::LogGET(oTransfer.sWriteFuncData.nSize);
+        if( i == iWinner )
+            continue;
+        if( i == 0 )
+        {
+            CPLDebug(poFS->GetDebugKey(), "Hedged request won for %s",
+                     m_pszURL);
+        }
+        VSICURLResetHeaderAndWriterFunctions(oTransfer.hCurlHandle);
+        curl_easy_cleanup(oTransfer.hCurlHandle);
+        CPLFree(oTransfer.sWriteFuncData.pBuffer);
+        CPLFree(oTransfer.sWriteFuncHeaderData.pBuffer);
+    }
+
+    Transfer& oWinner = asTransfers[iWinner];
+    sWriteFuncData = oWinner.sWriteFuncData;
+    sWriteFuncHeaderData = oWinner.sWriteFuncHeaderData;
+    memcpy(pszCurlErrBuf, oWinner.szCurlErrBuf, sizeof(oWinner.szCurlErrBuf));
+    curl_easy_setopt(oWinner.hCurlHandle, CURLOPT_ERRORBUFFER, pszCurlErrBuf);
+    return oWinner.hCurlHandle;
+}
+
+/************************************************************************/
+/*                       VSICURLSlabsToBuffer()                         */
+/************************************************************************/
+
+// Move the body written in slabs to pBuffer, for code paths that need it
+// contiguous, such as the parsing of error responses.
+static void VSICURLSlabsToBuffer( WriteFuncStruct* psStruct )
+{
+    if( psStruct->poSlabPool == nullptr )
+        return;
+    CPLAssert( psStruct->pBuffer == nullptr );
+    psStruct->pBuffer = static_cast<char*>(VSIMalloc(psStruct->nSize + 1));
+    if( psStruct->pBuffer != nullptr )
+    {
+        size_t nOffset = 0;
+        for( const auto& poSlab: psStruct->apoSlabs )
+        {
+            memcpy(psStruct->pBuffer + nOffset, poSlab->data(), poSlab->size());
+            nOffset += poSlab->size();
+        }
+        psStruct->pBuffer[nOffset] = '\0';
+    }
+    psStruct->apoSlabs.clear();
+    psStruct->poSlabPool = nullptr;
+}
+
 /************************************************************************/
 /*                          DownloadRegion()                            */
 /************************************************************************/
 
-std::string VSICurlHandle::DownloadRegion( const vsi_l_offset startOffset,
-                                           const int nBlocks )
+std::vector<std::shared_ptr<VSICurlSlab>>
+VSICurlHandle::DownloadRegion( const vsi_l_offset startOffset,
+                               const int nBlocks )
 {
     if( bInterrupted && bStopOnInterruptUntilUninstall )
-        return std::string();
+        return {};
 
     if( oFileProp.eExists == EXIST_NO )
-        return std::string();
+        return {};
 
     CURLM* hCurlMultiHandle = poFS->GetCurlMultiHandleFor(m_pszURL);
 
@@ -1421,6 +1987,9 @@ retry:
     VSICURLInitWriteFuncStruct(&sWriteFuncData,
                                reinterpret_cast<VSILFILE *>(this),
                                pfnReadCbk, pReadCbkUserData);
+    // Write the body directly in the slabs that will be cached
+    sWriteFuncData.poSlabPool = &poFS->GetSlabPool();
+    sWriteFuncData.nSlabSize = VSICURLGetDownloadChunkSize();
     curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &sWriteFuncData);
     curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
                      VSICurlHandleWriteFunc);
@@ -1468,14 +2037,25 @@ retry:
 
     curl_easy_setopt(hCurlHandle, CURLOPT_FILETIME, 1);
 
-    MultiPerform(hCurlMultiHandle, hCurlHandle);
+    // The read callback cannot be invoked by two concurrent transfers
+    if( m_bHedgeRequests && pfnReadCbk == nullptr )
+    {
+        hCurlHandle = MultiPerformHedged(hCurlMultiHandle, hCurlHandle,
+                                         sWriteFuncData, sWriteFuncHeaderData,
+                                         szCurlErrBuf);
+    }
+    else
+    {
+        MultiPerform(hCurlMultiHandle, hCurlHandle, pfnReadCbk != nullptr);
+        NetworkStatisticsLogger::LogGET(sWriteFuncData.nSize);
+    }
+    VSICURLReportWriteFuncError(sWriteFuncHeaderData);
+    poFS->AddTransferStats(hCurlHandle);
 
     VSICURLResetHeaderAndWriterFunctions(hCurlHandle);
 
     curl_slist_free_all(headers);
 
-    NetworkStatisticsLogger::LogGET(sWriteFuncData.nSize);
-
     if( sWriteFuncData.bInterrupted )
     {
         bInterrupted = true;
@@ -1484,12 +2064,20 @@ retry:
         CPLFree(sWriteFuncHeaderData.pBuffer);
         curl_easy_cleanup(hCurlHandle);
 
-        return std::string();
+        return {};
     }
 
     long response_code = 0;
     curl_easy_getinfo(hCurlHandle, CURLINFO_HTTP_CODE, &response_code);
 
+    if( (response_code != 200 && response_code != 206 &&
+         response_code != 225 && response_code != 226 &&
+         response_code != 426) ||
+        sWriteFuncHeaderData.bError )
+    {
+        VSICURLSlabsToBuffer(&sWriteFuncData);
+    }
+
     if( ENABLE_DEBUG && szCurlErrBuf[0] != '\0' )
     {
         CPLDebug(poFS->GetDebugKey(),
@@ -1535,7 +2123,7 @@ retry:
         nRetryCount++;
         if( Authenticate() )
             goto retry;
-        return std::string();
+        return {};
     }
 
     CPLString osEffectiveURL;
@@ -1635,7 +2223,7 @@ retry:
         CPLFree(sWriteFuncData.pBuffer);
         CPLFree(sWriteFuncHeaderData.pBuffer);
         curl_easy_cleanup(hCurlHandle);
-        return std::string();
+        return {};
     }
 
     if( !oFileProp.bHasComputedFileSize && sWriteFuncHeaderData.pBuffer )
@@ -1703,61 +2291,49 @@ retry:
         }
     }
 
-    DownloadRegionPostProcess(startOffset, nBlocks,
-                              sWriteFuncData.pBuffer,
-                              sWriteFuncData.nSize);
+    DownloadRegionPostProcess(startOffset, nBlocks, sWriteFuncData.apoSlabs);
 
-    std::string osRet;
-    osRet.assign(sWriteFuncData.pBuffer, sWriteFuncData.nSize);
-
-    CPLFree(sWriteFuncData.pBuffer);
     CPLFree(sWriteFuncHeaderData.pBuffer);
     curl_easy_cleanup(hCurlHandle);
 
-    return osRet;
+    return std::move(sWriteFuncData.apoSlabs);
 }
 
 /************************************************************************/
 /*                      DownloadRegionPostProcess()                     */
 /************************************************************************/
 
-void VSICurlHandle::DownloadRegionPostProcess( const vsi_l_offset startOffset,
-                                               const int nBlocks,
-                                               const char* pBuffer,
-                                               size_t nSize )
+void VSICurlHandle::DownloadRegionPostProcess(
+                    const vsi_l_offset startOffset,
+                    const int nBlocks,
+                    const std::vector<std::shared_ptr<VSICurlSlab>>& apoSlabs )
 {
     const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
     lastDownloadedOffset = startOffset + nBlocks * knDOWNLOAD_CHUNK_SIZE;
 
-    if( nSize > static_cast<size_t>(nBlocks) * knDOWNLOAD_CHUNK_SIZE )
+    if( apoSlabs.size() > static_cast<size_t>(nBlocks) )
     {
         if( ENABLE_DEBUG )
             CPLDebug(
-                poFS->GetDebugKey(), "Got more data than expected : %u instead of %u",
-                static_cast<unsigned int>(nSize),
-                static_cast<unsigned int>(nBlocks * knDOWNLOAD_CHUNK_SIZE));
+                poFS->GetDebugKey(), "Got more data than expected : %u blocks instead of %u",
+                static_cast<unsigned int>(apoSlabs.size()),
+                static_cast<unsigned int>(nBlocks));
     }
 
     vsi_l_offset l_startOffset = startOffset;
-    while( nSize > 0 )
+    for( const auto& poSlab: apoSlabs )
     {
 #if DEBUG_VERBOSE
         if( ENABLE_DEBUG )
             CPLDebug(
                 poFS->GetDebugKey(),
                 "Add region %u - %u",
-                static_cast<unsigned int>(startOffset),
-                static_cast<unsigned int>(
-                    std::min(static_cast<size_t>(knDOWNLOAD_CHUNK_SIZE), nSize)));
+                static_cast<unsigned int>(l_startOffset),
+                static_cast<unsigned int>(poSlab->size()));
 #endif
-        const size_t nChunkSize =
-            std::min(static_cast<size_t>(knDOWNLOAD_CHUNK_SIZE), nSize);
-        poFS->AddRegion(m_pszURL, l_startOffset, nChunkSize, pBuffer);
-        l_startOffset += nChunkSize;
-        pBuffer += nChunkSize;
-        nSize -= nChunkSize;
+        poFS->AddRegion(m_pszURL, l_startOffset, poSlab);
+        l_startOffset += poSlab->size();
     }
-
 }
 
 /************************************************************************/
@@ -1782,9 +2358,17 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
              static_cast<int>(curOffset), static_cast<int>(nBufferRequestSize));
 #endif
 
+    if( m_bAdaptiveReadahead )
+        UpdateAccessPattern(curOffset, nBufferRequestSize);
+
     vsi_l_offset iterOffset = curOffset;
     const int knMAX_REGIONS = GetMaxRegions();
     const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+    // Regions downloaded by this call. They are also in the region cache,
+    // but might have been evicted from it when the request is larger than
+    // the cache.
+    std::vector<std::shared_ptr<VSICurlSlab>> apoDownloadedRegions;
+    vsi_l_offset nDownloadedRegionsOffset = 0;
     while( nBufferRequestSize )
     {
         // Don't try to read after end of file.
@@ -1800,15 +2384,49 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             break;
         }
 
+        // Large reads are downloaded with several concurrent connections,
+        // directly into the user buffer.
+        if( m_nParallelReadConnections > 1 && m_nParallelReadThreshold > 0 &&
+            pfnReadCbk == nullptr && oFileProp.bHasComputedFileSize &&
+            nBufferRequestSize >= m_nParallelReadThreshold )
+        {
+            const size_t nToRead = static_cast<size_t>(
+                std::min(static_cast<vsi_l_offset>(nBufferRequestSize),
+                         oFileProp.fileSize - iterOffset));
+            if( nToRead >= m_nParallelReadThreshold &&
+                ReadParallel(pBuffer, iterOffset, nToRead) )
+            {
+                pBuffer = static_cast<char *>(pBuffer) + nToRead;
+                iterOffset += nToRead;
+                nBufferRequestSize -= nToRead;
+                lastDownloadedOffset =
+                    (iterOffset / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
+                continue;
+            }
+        }
+
         const vsi_l_offset nOffsetToDownload =
                 (iterOffset / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
-        std::string osRegion;
-        std::shared_ptr<std::string> psRegion = poFS->GetRegion(m_pszURL, nOffsetToDownload);
-        if( psRegion != nullptr )
+        CheckPredictedBlock(nOffsetToDownload);
+        std::shared_ptr<VSICurlSlab> psRegion;
+        if( nOffsetToDownload >= nDownloadedRegionsOffset &&
+            (nOffsetToDownload - nDownloadedRegionsOffset) /
+                knDOWNLOAD_CHUNK_SIZE < apoDownloadedRegions.size() )
         {
-            osRegion = *psRegion;
+            psRegion = apoDownloadedRegions[static_cast<size_t>(
+                (nOffsetToDownload - nDownloadedRegionsOffset) /
+                    knDOWNLOAD_CHUNK_SIZE)];
         }
         else
+        {
+            psRegion = poFS->GetRegion(m_pszURL, nOffsetToDownload);
+        }
+        if( psRegion == nullptr && WaitForAdvisedBlock(nOffsetToDownload) )
+        {
+            // The block was being prefetched by AdviseRead().
+            psRegion = poFS->GetRegion(m_pszURL, nOffsetToDownload);
+        }
+        if( psRegion == nullptr )
         {
             if( nOffsetToDownload == lastDownloadedOffset )
             {
@@ -1842,9 +2460,10 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             // this should not cause bugs. Just missed optimization.
             for( int i = 1; i < nBlocksToDownload; i++ )
             {
-                if( poFS->GetRegion(
-                        m_pszURL,
-                        nOffsetToDownload + i * knDOWNLOAD_CHUNK_SIZE) != nullptr )
+                const vsi_l_offset nBlockOffset =
+                    nOffsetToDownload + i * knDOWNLOAD_CHUNK_SIZE;
+                if( poFS->GetRegion(m_pszURL, nBlockOffset) != nullptr ||
+                    IsAdvisedBlockPending(nBlockOffset) )
                 {
                     nBlocksToDownload = i;
                     break;
@@ -1854,17 +2473,20 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             if( nBlocksToDownload > knMAX_REGIONS )
                 nBlocksToDownload = knMAX_REGIONS;
 
-            osRegion = DownloadRegion(nOffsetToDownload, nBlocksToDownload);
-            if( osRegion.empty() )
+            apoDownloadedRegions =
+                DownloadRegion(nOffsetToDownload, nBlocksToDownload);
+            nDownloadedRegionsOffset = nOffsetToDownload;
+            if( apoDownloadedRegions.empty() )
             {
                 if( !bInterrupted )
                     bEOF = true;
                 return 0;
             }
+            psRegion = apoDownloadedRegions[0];
         }
 
         const vsi_l_offset nRegionOffset = iterOffset - nOffsetToDownload;
-        if (osRegion.size() < nRegionOffset)
+        if (psRegion->size() < nRegionOffset)
         {
             if( iterOffset == curOffset )
             {
@@ -1876,14 +2498,14 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
 
         const int nToCopy = static_cast<int>(
             std::min(static_cast<vsi_l_offset>(nBufferRequestSize),
-                     osRegion.size() - nRegionOffset));
+                     psRegion->size() - nRegionOffset));
         memcpy(pBuffer,
-               osRegion.data() + nRegionOffset,
+               psRegion->data() + nRegionOffset,
                nToCopy);
         pBuffer = static_cast<char *>(pBuffer) + nToCopy;
         iterOffset += nToCopy;
         nBufferRequestSize -= nToCopy;
-        if( osRegion.size() < static_cast<size_t>(knDOWNLOAD_CHUNK_SIZE) &&
+        if( psRegion->size() < static_cast<size_t>(knDOWNLOAD_CHUNK_SIZE) &&
             nBufferRequestSize != 0 )
         {
             break;
@@ -1900,19 +2522,387 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
 }
 
 /************************************************************************/
-/*                           ReadMultiRange()                           */
+/*                       VSICurlDirectWriteFunc()                       */
 /************************************************************************/
 
-int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
-                                   const vsi_l_offset* const panOffsets,
-                                   const size_t* const panSizes )
+namespace {
+struct VSICurlDirectWriteStruct
 {
-    if( bInterrupted && bStopOnInterruptUntilUninstall )
-        return FALSE;
+    char*   pabyDst = nullptr;
+    size_t  nSize = 0;
+    size_t  nWritten = 0;
+};
+}
 
-    poFS->GetCachedFileProp(m_pszURL, oFileProp);
-    if( oFileProp.eExists == EXIST_NO )
-        return -1;
+static size_t VSICurlDirectWriteFunc( void *buffer, size_t count,
+                                      size_t nmemb, void *req )
+{
+    VSICurlDirectWriteStruct* psStruct =
+        static_cast<VSICurlDirectWriteStruct *>(req);
+    const size_t nSize = count * nmemb;
+    // Abort the transfer if the server sends more than requested.
+    if( nSize > psStruct->nSize - psStruct->nWritten )
+        return 0;
+    memcpy(psStruct->pabyDst + psStruct->nWritten, buffer, nSize);
+    psStruct->nWritten += nSize;
+    return nSize;
+}
+
+/************************************************************************/
+/*                           ReadParallel()                             */
+/************************************************************************/
+
+// Download the nSize bytes at nOffset with m_nParallelReadConnections
+// concurrent range GETs, written directly into pBuffer and bypassing the
+// region cache. Returns false if any part failed, or if the request is too
+// small to be split, in which case the caller should use the regular code
+// path, which retries.
+
+bool VSICurlHandle::ReadParallel( void* pBuffer, vsi_l_offset nOffset,
+                                  size_t nSize )
+{
+    // Split the request into parts made of whole chunks, so that small
+    // requests (the threshold may be lower than the number of connections)
+    // do not end up with empty parts.
+    const size_t knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+    const size_t nChunks =
+        (nSize + knDOWNLOAD_CHUNK_SIZE - 1) / knDOWNLOAD_CHUNK_SIZE;
+    const size_t nMaxParts = std::min(
+        static_cast<size_t>(m_nParallelReadConnections), nChunks);
+    if( nMaxParts < 2 )
+        return false;
+    const size_t nPartSize =
+        (nChunks + nMaxParts - 1) / nMaxParts * knDOWNLOAD_CHUNK_SIZE;
+    const size_t nParts = (nSize + nPartSize - 1) / nPartSize;
+    if( nParts < 2 )
+        return false;
+
+    bool bHasExpired = false;
+    CPLString osURL(GetRedirectURLIfValid(bHasExpired));
+    if( bHasExpired )
+        return false;
+
+    CURLM* hMultiHandle = poFS->GetCurlMultiHandleFor(osURL);
+
+    struct Part
+    {
+        CURL               *hCurlHandle = nullptr;
+        struct curl_slist  *headers = nullptr;
+        VSICurlDirectWriteStruct sWriteData{};
+        WriteFuncStruct     sWriteFuncHeaderData{};
+        char                szCurlErrBuf[CURL_ERROR_SIZE+1] = {};
+    };
+    std::vector<Part> asParts(nParts);
+
+    CPLDebug(poFS->GetDebugKey(),
+             "Downloading " CPL_FRMT_GUIB "-" CPL_FRMT_GUIB
+             " (%s) with %d connections...",
+             nOffset, nOffset + nSize - 1, osURL.c_str(),
+             static_cast<int>(asParts.size()));
+
+    for( size_t i = 0; i < asParts.size(); i++ )
+    {
+        Part& oPart = asParts[i];
+        const size_t nPartOffset = i * nPartSize;
+        oPart.sWriteData.pabyDst = static_cast<char*>(pBuffer) + nPartOffset;
+        oPart.sWriteData.nSize = std::min(nPartSize, nSize - nPartOffset);
+
+        CURL* hCurlHandle = curl_easy_init();
+        oPart.hCurlHandle = hCurlHandle;
+        struct curl_slist* headers =
+            VSICurlSetOptions(hCurlHandle, osURL, m_papszHTTPOptions);
+
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &oPart.sWriteData);
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
+                         VSICurlDirectWriteFunc);
+
+        VSICURLInitWriteFuncStruct(&oPart.sWriteFuncHeaderData,
+                                   nullptr, nullptr, nullptr);
+        curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA,
+                         &oPart.sWriteFuncHeaderData);
+        curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION,
+                         VSICurlHandleWriteFunc);
+        oPart.sWriteFuncHeaderData.bIsHTTP = STARTS_WITH(m_pszURL, "http");
+        oPart.sWriteFuncHeaderData.nStartOffset = nOffset + nPartOffset;
+        oPart.sWriteFuncHeaderData.nEndOffset =
+            nOffset + nPartOffset + oPart.sWriteData.nSize - 1;
+
+        char rangeStr[512] = {};
+        snprintf(rangeStr, sizeof(rangeStr),
+                 CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                 oPart.sWriteFuncHeaderData.nStartOffset,
+                 oPart.sWriteFuncHeaderData.nEndOffset);
+        if( oPart.sWriteFuncHeaderData.bIsHTTP )
+        {
+            CPLString osHeaderRange;
+            osHeaderRange.Printf("Range: bytes=%s", rangeStr);
+            // So it gets included in Azure signature
+            headers = curl_slist_append(headers, osHeaderRange.c_str());
+            curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, nullptr);
+        }
+        else
+        {
+            curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, rangeStr);
+        }
+
+        curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER,
+                         oPart.szCurlErrBuf);
+
+        headers = VSICurlMergeHeaders(headers, GetCurlHeaders("GET", headers));
+        curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, headers);
+        oPart.headers = headers;
+        curl_multi_add_handle(hMultiHandle, hCurlHandle);
+    }
+
+    MultiPerform(hMultiHandle);
+
+    bool bRet = true;
+    for( auto& oPart: asParts )
+    {
+        long response_code = 0;
+        curl_easy_getinfo(oPart.hCurlHandle, CURLINFO_HTTP_CODE,
+                          &response_code);
+        NetworkStatisticsLogger::LogGET(oPart.sWriteData.nWritten);
+        if( (response_code != 206 && response_code != 225) ||
+            oPart.sWriteData.nWritten != oPart.sWriteData.nSize )
+        {
+            CPLDebug(poFS->GetDebugKey(),
+                     "Parallel download of " CPL_FRMT_GUIB "-" CPL_FRMT_GUIB
+                     " failed: response_code=%d, msg=%s",
+                     oPart.sWriteFuncHeaderData.nStartOffset,
+                     oPart.sWriteFuncHeaderData.nEndOffset,
+                     static_cast<int>(response_code), oPart.szCurlErrBuf);
+            bRet = false;
+        }
+        else
+        {
+            poFS->AddTransferStats(oPart.hCurlHandle);
+        }
+
+        curl_multi_remove_handle(hMultiHandle, oPart.hCurlHandle);
+        VSICURLResetHeaderAndWriterFunctions(oPart.hCurlHandle);
+        curl_easy_cleanup(oPart.hCurlHandle);
+        CPLFree(oPart.sWriteFuncHeaderData.pBuffer);
+        curl_slist_free_all(oPart.headers);
+    }
+
+    return bRet;
+}
+
+/************************************************************************/
+/*                        UpdateAccessPattern()                         */
+/************************************************************************/
+
+// Read() doubles the size of the downloaded regions for contiguous reads,
+// but gets no readahead for strided reads (e.g. every Nth tile row) or
+// reverse reads. When two successive reads are separated by the same
+// non-contiguous stride, the next ranges on that stride are predicted
+// and prefetched with AdviseRead(). The number of predicted ranges grows
+// while predictions are read, and is reset as soon as one is wasted.
+
+void VSICurlHandle::UpdateAccessPattern( vsi_l_offset nOffset, size_t nSize )
+{
+    constexpr int MAX_READAHEAD_WINDOW = 16;
+
+    const vsi_l_offset nLastOffset = m_nLastReadOffset;
+    const size_t nLastSize = m_nLastReadSize;
+    m_nLastReadOffset = nOffset;
+    m_nLastReadSize = nSize;
+    if( nLastOffset == VSI_L_OFFSET_MAX )
+        return;
+
+    // Contiguous or overlapping forward reads are handled by Read().
+    GIntBig nStride = 0;
+    if( nOffset < nLastOffset || nOffset > nLastOffset + nLastSize )
+        nStride = static_cast<GIntBig>(nOffset) -
+                  static_cast<GIntBig>(nLastOffset);
+
+    if( nStride == 0 || nStride != m_nReadStride )
+    {
+        if( !m_oSetPredictedBlocks.empty() )
+        {
+            // Some predicted blocks have been fetched for nothing.
+            m_oSetPredictedBlocks.clear();
+            m_nReadaheadWindow = 1;
+            m_nReadaheadHits = 0;
+        }
+        m_nReadStride = nStride;
+        return;
+    }
+
+    if( m_nReadaheadHits >= m_nReadaheadWindow &&
+        m_nReadaheadWindow < MAX_READAHEAD_WINDOW )
+    {
+        m_nReadaheadWindow *= 2;
+        m_nReadaheadHits = 0;
+    }
+
+    poFS->GetCachedFileProp(m_pszURL, oFileProp);
+    const int knMAX_REGIONS = GetMaxRegions();
+    const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    int nBlocks = 0;
+    for( int i = 1; i <= m_nReadaheadWindow; i++ )
+    {
+        const GIntBig nNextOffset =
+            static_cast<GIntBig>(nOffset) + i * nStride;
+        if( nNextOffset < 0 ||
+            (oFileProp.bHasComputedFileSize &&
+             static_cast<vsi_l_offset>(nNextOffset) >= oFileProp.fileSize) )
+        {
+            break;
+        }
+        const vsi_l_offset nStart = static_cast<vsi_l_offset>(nNextOffset);
+        const vsi_l_offset nFirstBlock =
+            (nStart / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
+        nBlocks += static_cast<int>(
+            (nStart + nSize - nFirstBlock + knDOWNLOAD_CHUNK_SIZE - 1) /
+                knDOWNLOAD_CHUNK_SIZE);
+        if( nBlocks > knMAX_REGIONS )
+            break;
+        for( vsi_l_offset nBlock = nFirstBlock; nBlock < nStart + nSize;
+             nBlock += knDOWNLOAD_CHUNK_SIZE )
+        {
+            m_oSetPredictedBlocks.insert(nBlock);
+        }
+        anOffsets.push_back(nStart);
+        anSizes.push_back(nSize);
+    }
+    if( anOffsets.empty() )
+        return;
+
+#if DEBUG_VERBOSE
+    CPLDebug(poFS->GetDebugKey(),
+             "Stride " CPL_FRMT_GIB " detected. Prefetching %d ranges",
+             nStride, static_cast<int>(anOffsets.size()));
+#endif
+    AdviseRead(static_cast<int>(anOffsets.size()),
+               anOffsets.data(), anSizes.data());
+}
+
+/************************************************************************/
+/*                        CheckPredictedBlock()                         */
+/************************************************************************/
+
+void VSICurlHandle::CheckPredictedBlock( vsi_l_offset nBlockOffset )
+{
+    if( !m_oSetPredictedBlocks.empty() &&
+        m_oSetPredictedBlocks.erase(nBlockOffset) > 0 )
+    {
+        m_nReadaheadHits++;
+    }
+}
+
+/************************************************************************/
+/*                         VSICurlPlanRanges()                          */
+/************************************************************************/
+
+namespace {
+struct VSICurlMergedRange
+{
+    vsi_l_offset nStart = 0;
+    vsi_l_offset nEnd = 0;      // exclusive
+    int          iFirst = 0;
+    int          iLast = 0;     // inclusive
+};
+}
+
+// Group the ranges of a ReadMultiRange() request into the ranges to
+// actually download. A range is merged into the previous group when it
+// starts no further than nGapBudget bytes after the end of that group
+// (consecutive and overlapping ranges included). Empty ranges are attached
+// to the current group, and groups made only of empty ranges are dropped.
+
+static std::vector<VSICurlMergedRange> VSICurlPlanRanges(
+                                            int nRanges,
+                                            const vsi_l_offset* panOffsets,
+                                            const size_t* panSizes,
+                                            bool bMerge,
+                                            vsi_l_offset nGapBudget )
+{
+    std::vector<VSICurlMergedRange> aoMerged;
+    bool bHasData = false;
+    for( int i = 0; i < nRanges; i++ )
+    {
+        const vsi_l_offset nEnd = panOffsets[i] + panSizes[i];
+        if( !aoMerged.empty() &&
+            (panSizes[i] == 0 ||
+             !bHasData ||
+             (bMerge &&
+              panOffsets[i] >= aoMerged.back().nStart &&
+              panOffsets[i] <= aoMerged.back().nEnd + nGapBudget)) )
+        {
+            VSICurlMergedRange& oLast = aoMerged.back();
+            oLast.iLast = i;
+            if( panSizes[i] == 0 )
+                continue;
+            if( !bHasData )
+            {
+                oLast.nStart = panOffsets[i];
+                oLast.nEnd = nEnd;
+                bHasData = true;
+            }
+            else if( nEnd > oLast.nEnd )
+            {
+                oLast.nEnd = nEnd;
+            }
+            continue;
+        }
+        if( !aoMerged.empty() && !bHasData )
+            aoMerged.pop_back();
+        VSICurlMergedRange oRange;
+        oRange.nStart = panOffsets[i];
+        oRange.nEnd = nEnd;
+        oRange.iFirst = i;
+        oRange.iLast = i;
+        aoMerged.push_back(oRange);
+        bHasData = panSizes[i] != 0;
+    }
+    if( !aoMerged.empty() && !bHasData )
+        aoMerged.pop_back();
+    return aoMerged;
+}
+
+/************************************************************************/
+/*                      VSICurlScatterMergedRange()                     */
+/************************************************************************/
+
+// Copy the content of the ranges of oMerged from pData, which holds
+// nDataSize bytes starting at oMerged.nStart.
+static bool VSICurlScatterMergedRange( const VSICurlMergedRange& oMerged,
+                                       const char* pData, size_t nDataSize,
+                                       void ** const ppData,
+                                       const vsi_l_offset* const panOffsets,
+                                       const size_t* const panSizes )
+{
+    if( nDataSize < oMerged.nEnd - oMerged.nStart )
+        return false;
+    for( int i = oMerged.iFirst; i <= oMerged.iLast; i++ )
+    {
+        if( panSizes[i] == 0 )
+            continue;
+        memcpy(ppData[i],
+               pData + static_cast<size_t>(panOffsets[i] - oMerged.nStart),
+               panSizes[i]);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           ReadMultiRange()                           */
+/************************************************************************/
+
+int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
+                                   const vsi_l_offset* const panOffsets,
+                                   const size_t* const panSizes )
+{
+    if( bInterrupted && bStopOnInterruptUntilUninstall )
+        return FALSE;
+
+    poFS->GetCachedFileProp(m_pszURL, oFileProp);
+    if( oFileProp.eExists == EXIST_NO )
+        return -1;
 
     NetworkStatisticsFileSystem oContextFS(poFS->GetFSPrefix());
     NetworkStatisticsFile oContextFile(m_osFilename);
@@ -1955,9 +2945,16 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     }
 #endif
 
+    const std::vector<VSICurlMergedRange> aoMerged = VSICurlPlanRanges(
+        nRanges, panOffsets, panSizes,
+        CPLTestBool(CPLGetConfigOption(
+            "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE")),
+        poFS->GetMergeGapBudget());
+    const int nRequests = static_cast<int>(aoMerged.size());
+
     std::vector<CURL*> aHandles;
-    std::vector<WriteFuncStruct> asWriteFuncData(nRanges);
-    std::vector<WriteFuncStruct> asWriteFuncHeaderData(nRanges);
+    std::vector<WriteFuncStruct> asWriteFuncData(nRequests);
+    std::vector<WriteFuncStruct> asWriteFuncHeaderData(nRequests);
     std::vector<char*> apszRanges;
     std::vector<struct curl_slist*> aHeaders;
 
@@ -1965,27 +2962,11 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     {
         std::array<char,CURL_ERROR_SIZE+1> szCurlErrBuf;
     };
-    std::vector<CurlErrBuffer> asCurlErrors(nRanges);
+    std::vector<CurlErrBuffer> asCurlErrors(nRequests);
 
-    const bool bMergeConsecutiveRanges = CPLTestBool(CPLGetConfigOption(
-        "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE"));
-
-    for( int i = 0, iRequest = 0; i < nRanges; )
+    for( int iRequest = 0; iRequest < nRequests; iRequest++ )
     {
-        size_t nSize = 0;
-        int iNext = i;
-        // Identify consecutive ranges
-        while( bMergeConsecutiveRanges &&
-               iNext + 1 < nRanges &&
-               panOffsets[iNext] + panSizes[iNext] == panOffsets[iNext+1] )
-        {
-            nSize += panSizes[iNext];
-            iNext++;
-        }
-        nSize += panSizes[iNext];
-        if( nSize == 0 )
-            continue;
-
+        const VSICurlMergedRange& oMerged = aoMerged[iRequest];
         CURL* hCurlHandle = curl_easy_init();
         aHandles.push_back(hCurlHandle);
 
@@ -2011,9 +2992,8 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
         curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION,
                          VSICurlHandleWriteFunc);
         asWriteFuncHeaderData[iRequest].bIsHTTP = STARTS_WITH(m_pszURL, "http");
-        asWriteFuncHeaderData[iRequest].nStartOffset = panOffsets[i];
-
-        asWriteFuncHeaderData[iRequest].nEndOffset = panOffsets[i] + nSize-1;
+        asWriteFuncHeaderData[iRequest].nStartOffset = oMerged.nStart;
+        asWriteFuncHeaderData[iRequest].nEndOffset = oMerged.nEnd - 1;
 
         char rangeStr[512] = {};
         snprintf(rangeStr, sizeof(rangeStr),
@@ -2049,9 +3029,6 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
         curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, headers);
         aHeaders.push_back(headers);
         curl_multi_add_handle(hMultiHandle, hCurlHandle);
-
-        i = iNext + 1;
-        iRequest ++;
     }
 
     if( !aHandles.empty() )
@@ -2060,22 +3037,14 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     }
 
     int nRet = 0;
-    size_t iReq = 0;
-    int iRange = 0;
     size_t nTotalDownloaded = 0;
-    for( ; iReq < aHandles.size(); iReq++, iRange++ )
+    for( size_t iReq = 0; iReq < aHandles.size(); iReq++ )
     {
-        while( iRange < nRanges && panSizes[iRange] == 0 )
-        {
-            iRange ++;
-        }
-        if( iRange == nRanges )
-            break;
-
+        VSICURLReportWriteFuncError(asWriteFuncHeaderData[iReq]);
         long response_code = 0;
         curl_easy_getinfo(aHandles[iReq], CURLINFO_HTTP_CODE, &response_code);
 
-        if( ENABLE_DEBUG && asCurlErrors[iRange].szCurlErrBuf[0] != '\0' )
+        if( ENABLE_DEBUG && asCurlErrors[iReq].szCurlErrBuf[0] != '\0' )
         {
             char rangeStr[512] = {};
             snprintf(rangeStr, sizeof(rangeStr),
@@ -2083,7 +3052,7 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                     asWriteFuncHeaderData[iReq].nStartOffset,
                     asWriteFuncHeaderData[iReq].nEndOffset);
 
-            const char* pszErrorMsg = &asCurlErrors[iRange].szCurlErrBuf[0];
+            const char* pszErrorMsg = &asCurlErrors[iReq].szCurlErrBuf[0];
             CPLDebug(poFS->GetDebugKey(),
                      "ReadMultiRange(%s), %s: response_code=%d, msg=%s",
                      osURL.c_str(),
@@ -2109,38 +3078,14 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
         }
         else if( nRet == 0 )
         {
-            size_t nOffset = 0;
-            size_t nRemainingSize = asWriteFuncData[iReq].nSize;
-            nTotalDownloaded += nRemainingSize;
-            CPLAssert( iRange < nRanges );
-            while( true )
+            nTotalDownloaded += asWriteFuncData[iReq].nSize;
+            poFS->AddTransferStats(aHandles[iReq]);
+            if( !VSICurlScatterMergedRange(aoMerged[iReq],
+                                           asWriteFuncData[iReq].pBuffer,
+                                           asWriteFuncData[iReq].nSize,
+                                           ppData, panOffsets, panSizes) )
             {
-                if( nRemainingSize < panSizes[iRange] )
-                {
-                    nRet = -1;
-                    break;
-                }
-
-                if( panSizes[iRange] > 0 )
-                {
-                    memcpy( ppData[iRange],
-                            asWriteFuncData[iReq].pBuffer + nOffset,
-                            panSizes[iRange] );
-                }
-
-                if( bMergeConsecutiveRanges &&
-                    iRange + 1 < nRanges &&
-                    panOffsets[iRange] + panSizes[iRange] ==
-                                                    panOffsets[iRange + 1] )
-                {
-                    nOffset += panSizes[iRange];
-                    nRemainingSize -= panSizes[iRange];
-                    iRange++;
-                }
-                else
-                {
-                    break;
-                }
+                nRet = -1;
             }
         }
 
@@ -2172,31 +3117,27 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
                                    const vsi_l_offset* const panOffsets,
                                    const size_t* const panSizes )
 {
+    const std::vector<VSICurlMergedRange> aoMerged = VSICurlPlanRanges(
+        nRanges, panOffsets, panSizes, true, poFS->GetMergeGapBudget());
+    if( aoMerged.empty() )
+        return 0;
+
     CPLString osRanges;
     CPLString osFirstRange;
     CPLString osLastRange;
-    int nMergedRanges = 0;
+    const int nMergedRanges = static_cast<int>(aoMerged.size());
     vsi_l_offset nTotalReqSize = 0;
-    for( int i=0; i < nRanges; i++ )
+    for( const auto& oMerged: aoMerged )
     {
         CPLString osCurRange;
-        if( i != 0 )
+        osCurRange.Printf(CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                          oMerged.nStart, oMerged.nEnd - 1);
+        nTotalReqSize += oMerged.nEnd - oMerged.nStart;
+        if( !osRanges.empty() )
             osRanges.append(",");
-        osCurRange = CPLSPrintf(CPL_FRMT_GUIB "-", panOffsets[i]);
-        while( i + 1 < nRanges &&
-               panOffsets[i] + panSizes[i] == panOffsets[i+1] )
-        {
-            nTotalReqSize += panSizes[i];
-            i++;
-        }
-        nTotalReqSize += panSizes[i];
-        osCurRange.append
-            (CPLSPrintf(CPL_FRMT_GUIB, panOffsets[i] + panSizes[i]-1));
-        nMergedRanges++;
-
         osRanges += osCurRange;
 
-        if( nMergedRanges == 1 )
+        if( osFirstRange.empty() )
             osFirstRange = osCurRange;
         osLastRange = osCurRange;
     }
@@ -2240,8 +3181,8 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
     sWriteFuncHeaderData.bMultiRange = nMergedRanges > 1;
     if( nMergedRanges == 1 )
     {
-        sWriteFuncHeaderData.nStartOffset = panOffsets[0];
-        sWriteFuncHeaderData.nEndOffset = panOffsets[0] + nTotalReqSize-1;
+        sWriteFuncHeaderData.nStartOffset = aoMerged[0].nStart;
+        sWriteFuncHeaderData.nEndOffset = aoMerged[0].nEnd - 1;
     }
 
     if( ENABLE_DEBUG )
@@ -2264,7 +3205,8 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
     headers = VSICurlMergeHeaders(headers, GetCurlHeaders("GET", headers));
     curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, headers);
 
-    MultiPerform(hCurlMultiHandle, hCurlHandle);
+    MultiPerform(hCurlMultiHandle, hCurlHandle, pfnReadCbk != nullptr);
+    VSICURLReportWriteFuncError(sWriteFuncHeaderData);
 
     VSICURLResetHeaderAndWriterFunctions(hCurlHandle);
 
@@ -2324,7 +3266,6 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
     char* pszBoundary;
     CPLString osBoundary;
     char *pszNext = nullptr;
-    int iRange = 0;
     int iPart = 0;
     char* pszEOL = nullptr;
 
@@ -2334,17 +3275,12 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
 
     if( nMergedRanges == 1 )
     {
-        size_t nAccSize = 0;
-        if( static_cast<vsi_l_offset>(nSize) < nTotalReqSize )
-            goto end;
-
-        for( int i=0; i < nRanges; i++ )
+        if( VSICurlScatterMergedRange(aoMerged[0], pBuffer, nSize,
+                                      ppData, panOffsets, panSizes) )
         {
-            memcpy(ppData[i], pBuffer + nAccSize, panSizes[i]);
-            nAccSize += panSizes[i];
+            poFS->AddTransferStats(hCurlHandle);
+            nRet = 0;
         }
-
-        nRet = 0;
         goto end;
     }
 
@@ -2403,7 +3339,7 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
 /* -------------------------------------------------------------------- */
 /*      Loop over parts...                                              */
 /* -------------------------------------------------------------------- */
-    while( iPart < nRanges )
+    while( iPart < nMergedRanges )
     {
 /* -------------------------------------------------------------------- */
 /*      Collect headers.                                                */
@@ -2460,33 +3396,22 @@ int VSICurlHandle::ReadMultiRangeSingleGet(
 /* -------------------------------------------------------------------- */
         size_t nBytesAvail = nSize - (pszNext - pBuffer);
 
-        while( true )
+        if( !VSICurlScatterMergedRange(aoMerged[iPart], pszNext, nBytesAvail,
+                                       ppData, panOffsets, panSizes) )
         {
-            if( nBytesAvail < panSizes[iRange] )
-            {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "Error while parsing multipart content (at line %d)",
-                         __LINE__);
-                goto end;
-            }
-
-            memcpy(ppData[iRange], pszNext, panSizes[iRange]);
-            pszNext += panSizes[iRange];
-            nBytesAvail -= panSizes[iRange];
-            if( iRange + 1 < nRanges &&
-                panOffsets[iRange] + panSizes[iRange] ==
-                panOffsets[iRange + 1] )
-            {
-                iRange++;
-            }
-            else
-            {
-                break;
-            }
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Error while parsing multipart content (at line %d)",
+                     __LINE__);
+            goto end;
+        }
+        {
+            const size_t nPartSize = static_cast<size_t>(
+                aoMerged[iPart].nEnd - aoMerged[iPart].nStart);
+            pszNext += nPartSize;
+            nBytesAvail -= nPartSize;
         }
 
         iPart++;
-        iRange++;
 
         while( nBytesAvail > 0
                && (*pszNext != '-'
@@ -2540,207 +3465,1258 @@ end:
 }
 
 /************************************************************************/
-/*                               Write()                                */
+/*                            AdviseRead()                              */
 /************************************************************************/
 
-size_t VSICurlHandle::Write( const void * /* pBuffer */,
-                             size_t /* nSize */,
-                             size_t /* nMemb */ )
+struct VSICurlHandle::AdviseReadBatch
 {
-    return 0;
-}
+    struct Request
+    {
+        CURL               *hCurlHandle = nullptr;
+        struct curl_slist  *headers = nullptr;
+        CPLString           osRange{};
+        WriteFuncStruct     sWriteFuncData{};
+        WriteFuncStruct     sWriteFuncHeaderData{};
+        std::array<char,CURL_ERROR_SIZE+1> szCurlErrBuf{};
+    };
 
-/************************************************************************/
-/*                                 Eof()                                */
-/************************************************************************/
+    VSICurlHandle         *poHandle = nullptr;
+    CPLString              osURL{};
+    CPLString              osCacheKey{};
+    std::vector<Request>   aoRequests{};
+    std::vector<vsi_l_offset> anBlocks{};
+};
 
-int       VSICurlHandle::Eof()
+void VSICurlHandle::AdviseRead( int const nRanges,
+                                const vsi_l_offset* const panOffsets,
+                                const size_t* const panSizes )
 {
-    return bEOF;
-}
+    if( nRanges <= 0 || !m_bCached ||
+        (bInterrupted && bStopOnInterruptUntilUninstall) )
+        return;
 
-/************************************************************************/
-/*                                 Flush()                              */
-/************************************************************************/
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_HTTP_ENABLE_ADVISE_READ",
+                                        "TRUE")) )
+        return;
+
+    poFS->GetCachedFileProp(m_pszURL, oFileProp);
+    if( oFileProp.eExists == EXIST_NO )
+        return;
+
+    bool bHasExpired = false;
+    CPLString osURL(GetRedirectURLIfValid(bHasExpired));
+    if( bHasExpired )
+        return;
+
+    const int knMAX_REGIONS = GetMaxRegions();
+    const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+
+    // Collect the blocks that are neither cached nor already being fetched.
+    std::set<vsi_l_offset> oSetBlocks;
+    for( int i = 0; i < nRanges; i++ )
+    {
+        if( panSizes[i] == 0 )
+            continue;
+        vsi_l_offset nEnd = panOffsets[i] + panSizes[i];
+        if( oFileProp.bHasComputedFileSize )
+            nEnd = std::min(nEnd, oFileProp.fileSize);
+        for( vsi_l_offset nBlock =
+                (panOffsets[i] / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
+             nBlock < nEnd &&
+                static_cast<int>(oSetBlocks.size()) < knMAX_REGIONS;
+             nBlock += knDOWNLOAD_CHUNK_SIZE )
+        {
+            if( poFS->GetRegion(m_pszURL, nBlock) == nullptr &&
+                !IsAdvisedBlockPending(nBlock) )
+            {
+                oSetBlocks.insert(nBlock);
+            }
+        }
+    }
+    if( oSetBlocks.empty() )
+        return;
+
+    // Group consecutive blocks into single requests.
+    std::vector<std::pair<vsi_l_offset, int>> aoRanges;
+    for( const auto nBlock: oSetBlocks )
+    {
+        if( !aoRanges.empty() &&
+            aoRanges.back().first +
+                static_cast<vsi_l_offset>(aoRanges.back().second) *
+                    knDOWNLOAD_CHUNK_SIZE == nBlock &&
+            aoRanges.back().second < knMAX_REGIONS )
+        {
+            aoRanges.back().second++;
+        }
+        else
+        {
+            aoRanges.emplace_back(nBlock, 1);
+        }
+    }
+
+    AdviseReadBatch* psBatch = new AdviseReadBatch();
+    psBatch->poHandle = this;
+    psBatch->osURL = osURL;
+    psBatch->osCacheKey = m_pszURL;
+    psBatch->anBlocks.assign(oSetBlocks.begin(), oSetBlocks.end());
+    psBatch->aoRequests.resize(aoRanges.size());
+
+    for( size_t i = 0; i < aoRanges.size(); i++ )
+    {
+        auto& oReq = psBatch->aoRequests[i];
+        CURL* hCurlHandle = curl_easy_init();
+        oReq.hCurlHandle = hCurlHandle;
+
+        struct curl_slist* headers =
+            VSICurlSetOptions(hCurlHandle, osURL, m_papszHTTPOptions);
+
+        VSICURLInitWriteFuncStruct(&oReq.sWriteFuncData,
+                                   reinterpret_cast<VSILFILE *>(this),
+                                   nullptr, nullptr);
+        oReq.sWriteFuncData.poSlabPool = &poFS->GetSlabPool();
+        oReq.sWriteFuncData.nSlabSize = knDOWNLOAD_CHUNK_SIZE;
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA,
+                         &oReq.sWriteFuncData);
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
+                         VSICurlHandleWriteFunc);
+
+        VSICURLInitWriteFuncStruct(&oReq.sWriteFuncHeaderData,
+                                   nullptr, nullptr, nullptr);
+        curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA,
+                         &oReq.sWriteFuncHeaderData);
+        curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION,
+                         VSICurlHandleWriteFunc);
+        oReq.sWriteFuncHeaderData.bIsHTTP = STARTS_WITH(m_pszURL, "http");
+        oReq.sWriteFuncHeaderData.nStartOffset = aoRanges[i].first;
+        oReq.sWriteFuncHeaderData.nEndOffset = aoRanges[i].first +
+            static_cast<vsi_l_offset>(aoRanges[i].second) *
+                knDOWNLOAD_CHUNK_SIZE - 1;
+        if( oFileProp.bHasComputedFileSize &&
+            oReq.sWriteFuncHeaderData.nEndOffset >= oFileProp.fileSize )
+        {
+            oReq.sWriteFuncHeaderData.nEndOffset = oFileProp.fileSize - 1;
+        }
+
+        char rangeStr[512] = {};
+        snprintf(rangeStr, sizeof(rangeStr),
+                 CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                 oReq.sWriteFuncHeaderData.nStartOffset,
+                 oReq.sWriteFuncHeaderData.nEndOffset);
+
+        if( ENABLE_DEBUG )
+            CPLDebug(poFS->GetDebugKey(),
+                     "AdviseRead(): prefetching %s (%s)...",
+                     rangeStr, osURL.c_str());
+
+        if( oReq.sWriteFuncHeaderData.bIsHTTP )
+        {
+            oReq.osRange.Printf("Range: bytes=%s", rangeStr);
+            // So it gets included in Azure signature
+            headers = curl_slist_append(headers, oReq.osRange.c_str());
+            curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, nullptr);
+        }
+        else
+        {
+            oReq.osRange = rangeStr;
+            curl_easy_setopt(hCurlHandle, CURLOPT_RANGE,
+                             oReq.osRange.c_str());
+        }
+
+        curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER,
+                         &oReq.szCurlErrBuf[0]);
+
+        // Signing is done here, in the calling thread, as the
+        // GetCurlHeaders() implementations are not thread-safe.
+        headers = VSICurlMergeHeaders(headers, GetCurlHeaders("GET", headers));
+        curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, headers);
+        oReq.headers = headers;
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(m_oAdviseReadMutex);
+        m_oSetAdviseReadPendingBlocks.insert(oSetBlocks.begin(),
+                                             oSetBlocks.end());
+    }
+
+    if( !m_poAdviseReadPool )
+    {
+        auto poPool = std::unique_ptr<CPLWorkerThreadPool>(
+                                                new CPLWorkerThreadPool());
+        if( poPool->Setup(1, nullptr, nullptr, false) )
+            m_poAdviseReadPool = std::move(poPool);
+    }
+    if( !m_poAdviseReadPool ||
+        !m_poAdviseReadPool->SubmitJob(AdviseReadJob, psBatch) )
+    {
+        // Run it synchronously as a fallback. The batch is released by
+        // AdviseReadJob().
+        AdviseReadJob(psBatch);
+    }
+}
+
+/************************************************************************/
+/*                           AdviseReadJob()                            */
+/************************************************************************/
+
+void VSICurlHandle::AdviseReadJob( void* pData )
+{
+    AdviseReadBatch* psBatch = static_cast<AdviseReadBatch*>(pData);
+    VSICurlHandle* poThis = psBatch->poHandle;
+    VSICurlFilesystemHandler* poFS = poThis->poFS;
+
+    NetworkStatisticsFileSystem oContextFS(poFS->GetFSPrefix());
+    NetworkStatisticsFile oContextFile(poThis->m_osFilename);
+    NetworkStatisticsAction oContextAction("AdviseRead");
+
+    // Errors in prefetching are not errors of the caller. Read() will
+    // retry and report them if the data is really needed.
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+
+    CURLM* hMultiHandle = poFS->GetCurlMultiHandleFor(psBatch->osURL);
+    for( auto& oReq: psBatch->aoRequests )
+        curl_multi_add_handle(hMultiHandle, oReq.hCurlHandle);
+
+    void* old_handler = CPLHTTPIgnoreSigPipe();
+    int repeats = 0;
+    while( !poThis->m_bAdviseReadInterrupted )
+    {
+        int still_running = 0;
+        while( curl_multi_perform(hMultiHandle, &still_running) ==
+                                        CURLM_CALL_MULTI_PERFORM )
+        {
+            // loop
+        }
+        if( !still_running )
+            break;
+        CPLMultiPerformWait(hMultiHandle, repeats);
+    }
+    CPLHTTPRestoreSigPipeHandler(old_handler);
+
+    size_t nTotalDownloaded = 0;
+    for( auto& oReq: psBatch->aoRequests )
+    {
+        long response_code = 0;
+        curl_easy_getinfo(oReq.hCurlHandle, CURLINFO_HTTP_CODE,
+                          &response_code);
+        const auto& sHeaderData = oReq.sWriteFuncHeaderData;
+        if( !poThis->m_bAdviseReadInterrupted &&
+            (response_code == 206 || response_code == 225) &&
+            sHeaderData.nEndOffset + 1 ==
+                sHeaderData.nStartOffset + oReq.sWriteFuncData.nSize )
+        {
+            nTotalDownloaded += oReq.sWriteFuncData.nSize;
+            vsi_l_offset nStartOffset = sHeaderData.nStartOffset;
+            for( const auto& poSlab: oReq.sWriteFuncData.apoSlabs )
+            {
+                poFS->AddRegion(psBatch->osCacheKey, nStartOffset, poSlab);
+                nStartOffset += poSlab->size();
+            }
+        }
+        else if( ENABLE_DEBUG && !poThis->m_bAdviseReadInterrupted )
+        {
+            CPLDebug(poFS->GetDebugKey(),
+                     "AdviseRead(%s): request for " CPL_FRMT_GUIB "-"
+                     CPL_FRMT_GUIB " failed: response_code=%d, msg=%s",
+                     psBatch->osURL.c_str(),
+                     sHeaderData.nStartOffset, sHeaderData.nEndOffset,
+                     static_cast<int>(response_code),
+                     &oReq.szCurlErrBuf[0]);
+        }
+
+        curl_multi_remove_handle(hMultiHandle, oReq.hCurlHandle);
+        VSICURLResetHeaderAndWriterFunctions(oReq.hCurlHandle);
+        curl_easy_cleanup(oReq.hCurlHandle);
+        curl_slist_free_all(oReq.headers);
+        CPLFree(oReq.sWriteFuncData.pBuffer);
+        CPLFree(oReq.sWriteFuncHeaderData.pBuffer);
+    }
+
+    NetworkStatisticsLogger::LogGET(nTotalDownloaded);
+
+    CPLPopErrorHandler();
+
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oAdviseReadMutex);
+        for( const auto nBlock: psBatch->anBlocks )
+            poThis->m_oSetAdviseReadPendingBlocks.erase(nBlock);
+    }
+    poThis->m_oAdviseReadCV.notify_all();
+
+    delete psBatch;
+}
+
+/************************************************************************/
+/*                       IsAdvisedBlockPending()                        */
+/************************************************************************/
+
+bool VSICurlHandle::IsAdvisedBlockPending( vsi_l_offset nBlockOffset )
+{
+    if( !m_poAdviseReadPool )
+        return false;
+    std::lock_guard<std::mutex> oLock(m_oAdviseReadMutex);
+    return m_oSetAdviseReadPendingBlocks.find(nBlockOffset) !=
+                                    m_oSetAdviseReadPendingBlocks.end();
+}
+
+/************************************************************************/
+/*                        WaitForAdvisedBlock()                         */
+/************************************************************************/
+
+// Returns true if the block was being prefetched, in which case the caller
+// should look again in the region cache.
+bool VSICurlHandle::WaitForAdvisedBlock( vsi_l_offset nBlockOffset )
+{
+    if( !m_poAdviseReadPool )
+        return false;
+    std::unique_lock<std::mutex> oLock(m_oAdviseReadMutex);
+    bool bWaited = false;
+    while( m_oSetAdviseReadPendingBlocks.find(nBlockOffset) !=
+                                    m_oSetAdviseReadPendingBlocks.end() )
+    {
+        bWaited = true;
+        m_oAdviseReadCV.wait(oLock);
+    }
+    return bWaited;
+}
+
+/************************************************************************/
+/*                               Write()                                */
+/************************************************************************/
+
+size_t VSICurlHandle::Write( const void * /* pBuffer */,
+                             size_t /* nSize */,
+                             size_t /* nMemb */ )
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                                 Eof()                                */
+/************************************************************************/
+
+int       VSICurlHandle::Eof()
+{
+    return bEOF;
+}
+
+/************************************************************************/
+/*                                 Flush()                              */
+/************************************************************************/
+
+int       VSICurlHandle::Flush()
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                                  Close()                             */
+/************************************************************************/
+
+int       VSICurlHandle::Close()
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                   VSICurlFilesystemHandler()                         */
+/************************************************************************/
+
+VSICurlFilesystemHandler::VSICurlFilesystemHandler():
+    oCacheFileProp{100 * 1024},
+    oCacheDirList{1024, 0}
+{
+}
+
+/************************************************************************/
+/*                           CachedConnection                           */
+/************************************************************************/
+
+namespace {
+struct CachedConnection
+{
+    CURLM          *hCurlMultiHandle = nullptr;
+    void            clear();
+
+    ~CachedConnection() { clear(); }
+};
+} // namespace
+
+#ifdef WIN32
+// Currently thread_local and C++ objects don't work well with DLL on Windows
+static void FreeCachedConnection( void* pData )
+{
+    delete static_cast<std::map<VSICurlFilesystemHandler*, CachedConnection>*>(pData);
+}
+
+// Per-thread and per-filesystem Curl connection cache.
+static std::map<VSICurlFilesystemHandler*, CachedConnection>& GetConnectionCache()
+{
+    static std::map<VSICurlFilesystemHandler*, CachedConnection> dummyCache;
+    int bMemoryErrorOccurred = false;
+    void* pData = CPLGetTLSEx(CTLS_VSICURL_CACHEDCONNECTION, &bMemoryErrorOccurred);
+    if( bMemoryErrorOccurred )
+    {
+        return dummyCache;
+    }
+    if( pData == nullptr)
+    {
+        auto cachedConnection = new std::map<VSICurlFilesystemHandler*, CachedConnection>();
+        CPLSetTLSWithFreeFuncEx( CTLS_VSICURL_CACHEDCONNECTION,
+                                 cachedConnection,
+                                 FreeCachedConnection, &bMemoryErrorOccurred );
+        if( bMemoryErrorOccurred )
+        {
+            delete cachedConnection;
+            return dummyCache;
+        }
+        return *cachedConnection;
+    }
+    return *static_cast<std::map<VSICurlFilesystemHandler*, CachedConnection>*>(pData);
+}
+#else
+static thread_local std::map<VSICurlFilesystemHandler*, CachedConnection> g_tls_connectionCache;
+static std::map<VSICurlFilesystemHandler*, CachedConnection>& GetConnectionCache()
+{
+    return g_tls_connectionCache;
+}
+#endif
+
+/************************************************************************/
+/*                              clear()                                 */
+/************************************************************************/
+
+void CachedConnection::clear()
+{
+    if( hCurlMultiHandle )
+    {
+        curl_multi_cleanup(hCurlMultiHandle);
+        hCurlMultiHandle = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                  ~VSICurlFilesystemHandler()                         */
+/************************************************************************/
+
+//extern "C" int CPL_DLL GDALIsInGlobalDestructor();
+
+namespace {
+void VSICurlStopDiskCacheThread();
+}
+
+VSICurlFilesystemHandler::~VSICurlFilesystemHandler()
+{
+    // Flush pending writes to the disk cache while the file system
+    // handlers are still available.
+    VSICurlStopDiskCacheThread();
+    VSICurlStopSharedMultiThread();
+    VSICurlFilesystemHandler::ClearCache();
+    //if( !GDALIsInGlobalDestructor() )
+    //{
+        GetConnectionCache().erase(this);
+    //}
+
+    if( hMutex != nullptr )
+        CPLDestroyMutex( hMutex );
+    hMutex = nullptr;
+}
+
+/************************************************************************/
+/*                      AllowCachedDataFor()                            */
+/************************************************************************/
+
+bool VSICurlFilesystemHandler::AllowCachedDataFor(const char* pszFilename)
+{
+    bool bCachedAllowed = true;
+    char** papszTokens = CSLTokenizeString2(
+        CPLGetConfigOption("CPL_VSIL_CURL_NON_CACHED", ""), ":", 0 );
+    for( int i = 0; papszTokens && papszTokens[i]; i++)
+    {
+        if( STARTS_WITH(pszFilename, papszTokens[i]) )
+        {
+            bCachedAllowed = false;
+            break;
+        }
+    }
+    CSLDestroy(papszTokens);
+    return bCachedAllowed;
+}
+
+/************************************************************************/
+/*                     GetCurlMultiHandleFor()                          */
+/************************************************************************/
+
+CURLM* VSICurlFilesystemHandler::GetCurlMultiHandleFor(const CPLString& /*osURL*/)
+{
+    auto& conn = GetConnectionCache()[this];
+    if( conn.hCurlMultiHandle == nullptr )
+    {
+        conn.hCurlMultiHandle = curl_multi_init();
+#if CURL_AT_LEAST_VERSION(7,30,0)
+        const long nMaxHostConnections = atoi(
+            CPLGetConfigOption("CPL_VSIL_CURL_MAX_HOST_CONNECTIONS", "0"));
+        if( nMaxHostConnections > 0 )
+        {
+            curl_multi_setopt(conn.hCurlMultiHandle,
+                              CURLMOPT_MAX_HOST_CONNECTIONS,
+                              nMaxHostConnections);
+        }
+#endif
+    }
+    return conn.hCurlMultiHandle;
+}
+
+/************************************************************************/
+/*                       AddFirstByteLatency()                          */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::AddFirstByteLatency( double dfSeconds )
+{
+    constexpr size_t MAX_SAMPLES = 256;
+    std::lock_guard<std::mutex> oLock(m_oFirstByteLatencyMutex);
+    if( m_adfFirstByteLatencies.size() < MAX_SAMPLES )
+    {
+        m_adfFirstByteLatencies.push_back(dfSeconds);
+    }
+    else
+    {
+        m_adfFirstByteLatencies[m_nFirstByteLatencyIdx] = dfSeconds;
+        m_nFirstByteLatencyIdx = (m_nFirstByteLatencyIdx + 1) % MAX_SAMPLES;
+    }
+}
+
+/************************************************************************/
+/*                  GetFirstByteLatencyPercentile()                     */
+/************************************************************************/
+
+// Return the given percentile of the recent times to first byte, or -1 if
+// not enough of them were measured.
+double VSICurlFilesystemHandler::GetFirstByteLatencyPercentile(
+                                                        double dfPercentile )
+{
+    constexpr size_t MIN_SAMPLES = 20;
+    std::vector<double> adfLatencies;
+    {
+        std::lock_guard<std::mutex> oLock(m_oFirstByteLatencyMutex);
+        if( m_adfFirstByteLatencies.size() < MIN_SAMPLES )
+            return -1;
+        adfLatencies = m_adfFirstByteLatencies;
+    }
+    dfPercentile = std::max(0.0, std::min(100.0, dfPercentile));
+    const size_t nIdx = std::min(adfLatencies.size() - 1,
+        static_cast<size_t>(dfPercentile / 100 * adfLatencies.size()));
+    std::nth_element(adfLatencies.begin(), adfLatencies.begin() + nIdx,
+                     adfLatencies.end());
+    return adfLatencies[nIdx];
+}
+
+/************************************************************************/
+/*                          AddTransferStats()                          */
+/************************************************************************/
+
+// Update the smoothed round-trip time and download rate from a completed
+// range GET.
+void VSICurlFilesystemHandler::AddTransferStats( CURL* hCurlHandle )
+{
+    // Below that size, the transfer time is dominated by the latency
+    constexpr double MIN_SIZE_FOR_BANDWIDTH = 64 * 1024;
+    constexpr double ALPHA = 0.2;
+
+    long response_code = 0;
+    double dfPreTransfer = 0;
+    double dfStartTransfer = 0;
+    double dfTotal = 0;
+    curl_easy_getinfo(hCurlHandle, CURLINFO_HTTP_CODE, &response_code);
+    if( response_code < 200 || response_code >= 300 ||
+        curl_easy_getinfo(hCurlHandle, CURLINFO_PRETRANSFER_TIME,
+                          &dfPreTransfer) != CURLE_OK ||
+        curl_easy_getinfo(hCurlHandle, CURLINFO_STARTTRANSFER_TIME,
+                          &dfStartTransfer) != CURLE_OK ||
+        curl_easy_getinfo(hCurlHandle, CURLINFO_TOTAL_TIME,
+                          &dfTotal) != CURLE_OK )
+    {
+        return;
+    }
+
+#if CURL_AT_LEAST_VERSION(7,55,0)
+    curl_off_t nSize = 0;
+    if( curl_easy_getinfo(hCurlHandle, CURLINFO_SIZE_DOWNLOAD_T,
+                          &nSize) != CURLE_OK )
+    {
+        return;
+    }
+    const double dfSize = static_cast<double>(nSize);
+#else
+    double dfSize = 0;
+    if( curl_easy_getinfo(hCurlHandle, CURLINFO_SIZE_DOWNLOAD,
+                          &dfSize) != CURLE_OK )
+    {
+        return;
+    }
+#endif
+
+    std::lock_guard<std::mutex> oLock(m_oTransferStatsMutex);
+    const double dfRTT = dfStartTransfer - dfPreTransfer;
+    if( dfRTT > 0 )
+    {
+        m_dfSmoothedRTT = m_dfSmoothedRTT == 0 ? dfRTT :
+            (1 - ALPHA) * m_dfSmoothedRTT + ALPHA * dfRTT;
+    }
+    const double dfTransferTime = dfTotal - dfStartTransfer;
+    if( dfSize >= MIN_SIZE_FOR_BANDWIDTH && dfTransferTime > 1e-3 )
+    {
+        const double dfBandwidth = dfSize / dfTransferTime;
+        m_dfSmoothedBandwidth = m_dfSmoothedBandwidth == 0 ? dfBandwidth :
+            (1 - ALPHA) * m_dfSmoothedBandwidth + ALPHA * dfBandwidth;
+    }
+}
+
+/************************************************************************/
+/*                         GetMergeGapBudget()                          */
+/************************************************************************/
+
+// Return the maximum number of unneeded bytes between two ranges that
+// ReadMultiRange() should download rather than issuing another request.
+// This is the number of bytes that can be received during a round trip,
+// unless CPL_VSIL_CURL_MERGE_GAP is set.
+vsi_l_offset VSICurlFilesystemHandler::GetMergeGapBudget()
+{
+    constexpr vsi_l_offset DEFAULT_GAP = 4096;
+    constexpr double MAX_GAP = 1024 * 1024;
+
+    const char* pszGap = CPLGetConfigOption("CPL_VSIL_CURL_MERGE_GAP", nullptr);
+    if( pszGap != nullptr )
+        return CPLScanUIntBig(pszGap, static_cast<int>(strlen(pszGap)));
+
+    std::lock_guard<std::mutex> oLock(m_oTransferStatsMutex);
+    if( m_dfSmoothedRTT == 0 || m_dfSmoothedBandwidth == 0 )
+        return DEFAULT_GAP;
+    return static_cast<vsi_l_offset>(
+        std::min(MAX_GAP, m_dfSmoothedRTT * m_dfSmoothedBandwidth));
+}
+
+/************************************************************************/
+/*                          VSICurlDiskCache                            */
+/************************************************************************/
+
+// Optional persistent second tier of the region cache, enabled with
+// CPL_VSIL_CURL_DISK_CACHE_DIR. Each chunk is stored in its own file, whose
+// name is derived from the URL, a validator of the remote content (ETag,
+// or size and modification time), the chunk size and the chunk offset.
+// Files are written under a temporary name and then renamed, so that
+// several processes can safely share the same directory.
+//
+// To keep the read path free of file system scans, an in-memory index of
+// the cached chunks and of their total size is maintained. Writes, the
+// refresh of modification times used for LRU eviction, and trimming are
+// done by a background thread. The index is rebuilt from the directory
+// when the thread starts and before each trim, which is only done once the
+// tracked total exceeds CPL_VSIL_CURL_DISK_CACHE_SIZE, so that chunks
+// added or removed by other processes are eventually taken into account.
+
+namespace {
+class VSICurlDiskCache
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSICurlDiskCache)
+
+    struct Entry
+    {
+        GIntBig      nSize = 0;
+        GIntBig      nLastAccess = 0;
+    };
+
+    // A write of poSlab, or a refresh of the modification time of
+    // osFilename when poSlab is null.
+    struct Job
+    {
+        CPLString                     osFilename{};
+        CPLString                     osSubDir{};
+        std::shared_ptr<VSICurlSlab>  poSlab{};
+    };
+
+    CPLString   m_osDir;
+    GIntBig     m_nMaxSize;
+
+    std::mutex  m_oMutex{};
+    std::condition_variable m_oCV{};
+    std::map<CPLString, Entry> m_oIndex{};
+    bool        m_bIndexLoaded = false;
+    GIntBig     m_nTotalSize = 0;
+    std::deque<Job> m_aoJobs{};
+    size_t      m_nPendingBytes = 0;
+    CPLJoinableThread* m_hThread = nullptr;
+    bool        m_bStop = false;
+
+    CPLString   GetFilename( const char* pszURL, const FileProp& oFileProp,
+                             vsi_l_offset nOffset,
+                             CPLString& osSubDir ) const;
+    void        StartThreadIfNeeded();
+    static void ThreadFunc( void* pData );
+    void        ProcessJob( const Job& oJob );
+    void        RefreshIndex();
+    void        Trim();
+
+  public:
+    VSICurlDiskCache( const char* pszDir, GIntBig nMaxSize ):
+        m_osDir(pszDir), m_nMaxSize(nMaxSize) {}
+    ~VSICurlDiskCache() { StopThread(); }
+
+    static VSICurlDiskCache* Get();
+
+    bool        Read( const char* pszURL, const FileProp& oFileProp,
+                      vsi_l_offset nOffset, VSICurlSlab& oSlab );
+    void        Write( const char* pszURL, const FileProp& oFileProp,
+                       vsi_l_offset nOffset,
+                       const std::shared_ptr<VSICurlSlab>& poSlab );
+    void        StopThread();
+};
+
+/************************************************************************/
+/*                                Get()                                 */
+/************************************************************************/
+
+VSICurlDiskCache* VSICurlDiskCache::Get()
+{
+    static std::unique_ptr<VSICurlDiskCache> poDiskCache = []()
+    {
+        std::unique_ptr<VSICurlDiskCache> poRet;
+        const char* pszDir =
+            CPLGetConfigOption("CPL_VSIL_CURL_DISK_CACHE_DIR", nullptr);
+        if( pszDir == nullptr || pszDir[0] == '\0' )
+            return poRet;
+        VSIStatBufL sStat;
+        if( VSIStatL(pszDir, &sStat) != 0 &&
+            VSIMkdirRecursive(pszDir, 0755) != 0 )
+        {
+            CPLError(CE_Warning, CPLE_FileIO,
+                     "Cannot create %s. Disk cache disabled", pszDir);
+            return poRet;
+        }
+        GIntBig nMaxSize = CPLAtoGIntBig(CPLGetConfigOption(
+            "CPL_VSIL_CURL_DISK_CACHE_SIZE", "1073741824"));
+        if( nMaxSize <= 0 )
+            nMaxSize = static_cast<GIntBig>(1024) * 1024 * 1024;
+        poRet.reset(new VSICurlDiskCache(pszDir, nMaxSize));
+        return poRet;
+    }();
+    return poDiskCache.get();
+}
+
+/************************************************************************/
+/*                            GetFilename()                             */
+/************************************************************************/
+
+CPLString VSICurlDiskCache::GetFilename( const char* pszURL,
+                                         const FileProp& oFileProp,
+                                         vsi_l_offset nOffset,
+                                         CPLString& osSubDir ) const
+{
+    // Only cache content that we can validate against the remote file.
+    if( oFileProp.eExists != EXIST_YES || !oFileProp.bHasComputedFileSize )
+        return CPLString();
+    CPLString osKey(pszURL);
+    if( !oFileProp.ETag.empty() )
+    {
+        osKey += "\n";
+        osKey += oFileProp.ETag;
+    }
+    else if( oFileProp.mTime > 0 )
+    {
+        osKey += CPLSPrintf("\n" CPL_FRMT_GUIB "\n" CPL_FRMT_GIB,
+                            static_cast<GUIntBig>(oFileProp.fileSize),
+                            static_cast<GIntBig>(oFileProp.mTime));
+    }
+    else
+    {
+        return CPLString();
+    }
+
+    const CPLString osHash(CPLMD5String(osKey));
+    osSubDir = CPLFormFilename(m_osDir, osHash.substr(0, 2).c_str(), nullptr);
+    return CPLFormFilename(osSubDir,
+                           CPLSPrintf("%s_%d_" CPL_FRMT_GUIB,
+                                      osHash.c_str(),
+                                      VSICURLGetDownloadChunkSize(),
+                                      static_cast<GUIntBig>(nOffset)),
+                           nullptr);
+}
+
+/************************************************************************/
+/*                        StartThreadIfNeeded()                         */
+/************************************************************************/
+
+// Must be called with m_oMutex held.
+void VSICurlDiskCache::StartThreadIfNeeded()
+{
+    if( m_hThread == nullptr )
+        m_hThread = CPLCreateJoinableThread(ThreadFunc, this);
+}
+
+/************************************************************************/
+/*                             StopThread()                             */
+/************************************************************************/
+
+// Wait for the pending jobs to be processed and stop the background thread.
+// It is restarted by the next Read() or Write().
+void VSICurlDiskCache::StopThread()
+{
+    CPLJoinableThread* hThread;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        hThread = m_hThread;
+        if( hThread == nullptr )
+            return;
+        m_bStop = true;
+    }
+    m_oCV.notify_all();
+    CPLJoinThread(hThread);
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_hThread = nullptr;
+    m_bStop = false;
+}
+
+/************************************************************************/
+/*                             ThreadFunc()                             */
+/************************************************************************/
+
+void VSICurlDiskCache::ThreadFunc( void* pData )
+{
+    VSICurlDiskCache* poThis = static_cast<VSICurlDiskCache*>(pData);
+    bool bIndexLoaded;
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oMutex);
+        bIndexLoaded = poThis->m_bIndexLoaded;
+    }
+    if( !bIndexLoaded )
+        poThis->RefreshIndex();
+
+    while( true )
+    {
+        Job oJob;
+        {
+            std::unique_lock<std::mutex> oLock(poThis->m_oMutex);
+            poThis->m_oCV.wait(oLock, [poThis]
+                { return poThis->m_bStop || !poThis->m_aoJobs.empty(); });
+            if( poThis->m_aoJobs.empty() )
+                break;
+            oJob = std::move(poThis->m_aoJobs.front());
+            poThis->m_aoJobs.pop_front();
+        }
+        poThis->ProcessJob(oJob);
+    }
+}
+
+/************************************************************************/
+/*                             ProcessJob()                             */
+/************************************************************************/
+
+void VSICurlDiskCache::ProcessJob( const Job& oJob )
+{
+    if( !oJob.poSlab )
+    {
+#ifndef _WIN32
+        // Refresh the modification time so that Trim(), possibly run by
+        // another process, evicts the least recently used chunks first.
+        utime(oJob.osFilename, nullptr);
+#endif
+        return;
+    }
+
+    const size_t nSize = oJob.poSlab->size();
+    VSIMkdir(oJob.osSubDir, 0755);
+
+    const CPLString osTmpFilename(oJob.osFilename + CPLSPrintf(
+        ".tmp.%d." CPL_FRMT_GIB, CPLGetCurrentProcessID(), CPLGetPID()));
+    bool bOK = false;
+    VSILFILE* fp = VSIFOpenL(osTmpFilename, "wb");
+    if( fp != nullptr )
+    {
+        bOK = VSIFWriteL(oJob.poSlab->data(), 1, nSize, fp) == nSize;
+        bOK &= VSIFCloseL(fp) == 0;
+        if( !bOK || VSIRename(osTmpFilename, oJob.osFilename) != 0 )
+        {
+            VSIUnlink(osTmpFilename);
+            bOK = false;
+        }
+    }
+
+    bool bTrim = false;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_nPendingBytes -= nSize;
+        if( bOK )
+        {
+            Entry& oEntry = m_oIndex[oJob.osFilename];
+            m_nTotalSize += static_cast<GIntBig>(nSize) - oEntry.nSize;
+            oEntry.nSize = static_cast<GIntBig>(nSize);
+            oEntry.nLastAccess = static_cast<GIntBig>(time(nullptr));
+            bTrim = m_nTotalSize > m_nMaxSize;
+        }
+    }
+    if( bTrim )
+        Trim();
+}
+
+/************************************************************************/
+/*                            RefreshIndex()                            */
+/************************************************************************/
+
+// Rebuild the index from the content of the cache directory, and remove
+// leftovers of processes that died while writing.
+void VSICurlDiskCache::RefreshIndex()
+{
+    std::map<CPLString, Entry> oIndex;
+    GIntBig nTotalSize = 0;
+    const GIntBig nNow = static_cast<GIntBig>(time(nullptr));
+
+    const CPLStringList aosSubDirs(VSIReadDir(m_osDir));
+    for( int i = 0; i < aosSubDirs.size(); i++ )
+    {
+        if( strlen(aosSubDirs[i]) != 2 )
+            continue;
+        const CPLString osSubDir(
+            CPLFormFilename(m_osDir, aosSubDirs[i], nullptr));
+        const CPLStringList aosFiles(VSIReadDir(osSubDir));
+        for( int j = 0; j < aosFiles.size(); j++ )
+        {
+            if( aosFiles[j][0] == '.' )
+                continue;
+            const CPLString osFilename(
+                CPLFormFilename(osSubDir, aosFiles[j], nullptr));
+            VSIStatBufL sStat;
+            if( VSIStatL(osFilename, &sStat) != 0 )
+                continue;
+            if( strstr(aosFiles[j], ".tmp.") != nullptr )
+            {
+                if( nNow - static_cast<GIntBig>(sStat.st_mtime) > 3600 )
+                    VSIUnlink(osFilename);
+                continue;
+            }
+            Entry& oEntry = oIndex[osFilename];
+            oEntry.nSize = static_cast<GIntBig>(sStat.st_size);
+            oEntry.nLastAccess = static_cast<GIntBig>(sStat.st_mtime);
+            nTotalSize += oEntry.nSize;
+        }
+    }
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    // Keep the access times recorded by this process if they are more
+    // recent than the ones of the file system.
+    for( auto& oIter: oIndex )
+    {
+        const auto oOldIter = m_oIndex.find(oIter.first);
+        if( oOldIter != m_oIndex.end() )
+        {
+            oIter.second.nLastAccess = std::max(
+                oIter.second.nLastAccess, oOldIter->second.nLastAccess);
+        }
+    }
+    m_oIndex = std::move(oIndex);
+    m_nTotalSize = nTotalSize;
+    m_bIndexLoaded = true;
+}
+
+/************************************************************************/
+/*                                Trim()                                */
+/************************************************************************/
+
+// Remove the least recently used chunks until the total size of the
+// directory is below 90% of CPL_VSIL_CURL_DISK_CACHE_SIZE. Other processes
+// may concurrently add or remove files, so failures are ignored.
+void VSICurlDiskCache::Trim()
+{
+    RefreshIndex();
+
+    std::vector<std::pair<GIntBig, CPLString>> aoEntries;
+    GIntBig nTotalSize;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( m_nTotalSize <= m_nMaxSize )
+            return;
+        nTotalSize = m_nTotalSize;
+        for( const auto& oIter: m_oIndex )
+            aoEntries.emplace_back(oIter.second.nLastAccess, oIter.first);
+    }
+
+    std::sort(aoEntries.begin(), aoEntries.end());
+    const GIntBig nTargetSize = m_nMaxSize / 10 * 9;
+    for( const auto& oEntry: aoEntries )
+    {
+        if( nTotalSize <= nTargetSize )
+            break;
+        VSIUnlink(oEntry.second);
+
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        const auto oIter = m_oIndex.find(oEntry.second);
+        if( oIter != m_oIndex.end() )
+        {
+            nTotalSize -= oIter->second.nSize;
+            m_nTotalSize -= oIter->second.nSize;
+            m_oIndex.erase(oIter);
+        }
+    }
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+bool VSICurlDiskCache::Read( const char* pszURL, const FileProp& oFileProp,
+                             vsi_l_offset nOffset, VSICurlSlab& oSlab )
+{
+    CPLString osSubDir;
+    const CPLString osFilename(
+        GetFilename(pszURL, oFileProp, nOffset, osSubDir));
+    if( osFilename.empty() )
+        return false;
+
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        StartThreadIfNeeded();
+        // Until the index has been loaded by the background thread, probe
+        // the file system.
+        if( m_bIndexLoaded && m_oIndex.find(osFilename) == m_oIndex.end() )
+            return false;
+    }
+
+    VSILFILE* fp = VSIFOpenL(osFilename, "rb");
+    bool bRet = false;
+    if( fp != nullptr )
+    {
+        if( VSIFSeekL(fp, 0, SEEK_END) == 0 )
+        {
+            const vsi_l_offset nSize = VSIFTellL(fp);
+            if( nSize > 0 &&
+                nSize <= static_cast<vsi_l_offset>(oSlab.capacity()) &&
+                VSIFSeekL(fp, 0, SEEK_SET) == 0 )
+            {
+                oSlab.resize(static_cast<size_t>(nSize));
+                bRet = VSIFReadL(oSlab.data(), 1, oSlab.size(), fp) ==
+                                                                oSlab.size();
+            }
+        }
+        VSIFCloseL(fp);
+    }
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    const auto oIter = m_oIndex.find(osFilename);
+    if( bRet )
+    {
+        if( oIter != m_oIndex.end() )
+            oIter->second.nLastAccess = static_cast<GIntBig>(time(nullptr));
+        Job oJob;
+        oJob.osFilename = osFilename;
+        m_aoJobs.push_back(std::move(oJob));
+        m_oCV.notify_one();
+    }
+    else if( oIter != m_oIndex.end() )
+    {
+        // Removed by another process.
+        m_nTotalSize -= oIter->second.nSize;
+        m_oIndex.erase(oIter);
+    }
 
-int       VSICurlHandle::Flush()
-{
-    return 0;
+    return bRet;
 }
 
 /************************************************************************/
-/*                                  Close()                             */
+/*                               Write()                                */
 /************************************************************************/
 
-int       VSICurlHandle::Close()
+void VSICurlDiskCache::Write( const char* pszURL, const FileProp& oFileProp,
+                              vsi_l_offset nOffset,
+                              const std::shared_ptr<VSICurlSlab>& poSlab )
 {
-    return 0;
+    CPLString osSubDir;
+    const CPLString osFilename(
+        GetFilename(pszURL, oFileProp, nOffset, osSubDir));
+    if( osFilename.empty() || poSlab->size() == 0 )
+        return;
+
+    // Bound the memory held by slabs waiting to be written, in case the
+    // disk is slower than the network.
+    constexpr size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_oIndex.find(osFilename) != m_oIndex.end() ||
+        m_nPendingBytes + poSlab->size() > MAX_PENDING_BYTES )
+    {
+        return;
+    }
+    StartThreadIfNeeded();
+    Job oJob;
+    oJob.osFilename = osFilename;
+    oJob.osSubDir = osSubDir;
+    oJob.poSlab = poSlab;
+    m_nPendingBytes += poSlab->size();
+    m_aoJobs.push_back(std::move(oJob));
+    m_oCV.notify_one();
 }
 
 /************************************************************************/
-/*                   VSICurlFilesystemHandler()                         */
+/*                       VSICurlStopDiskCacheThread()                   */
 /************************************************************************/
 
-VSICurlFilesystemHandler::VSICurlFilesystemHandler():
-    oCacheFileProp{100 * 1024},
-    oCacheDirList{1024, 0}
+void VSICurlStopDiskCacheThread()
 {
+    VSICurlDiskCache* poDiskCache = VSICurlDiskCache::Get();
+    if( poDiskCache )
+        poDiskCache->StopThread();
 }
+} // namespace
 
 /************************************************************************/
-/*                           CachedConnection                           */
+/*                       GetRegionCacheShards()                         */
 /************************************************************************/
 
-namespace {
-struct CachedConnection
-{
-    CURLM          *hCurlMultiHandle = nullptr;
-    void            clear();
-
-    ~CachedConnection() { clear(); }
-};
-} // namespace
-
-#ifdef WIN32
-// Currently thread_local and C++ objects don't work well with DLL on Windows
-static void FreeCachedConnection( void* pData )
-{
-    delete static_cast<std::map<VSICurlFilesystemHandler*, CachedConnection>*>(pData);
-}
-
-// Per-thread and per-filesystem Curl connection cache.
-static std::map<VSICurlFilesystemHandler*, CachedConnection>& GetConnectionCache()
+std::vector<std::unique_ptr<VSICurlFilesystemHandler::RegionCacheShard>>&
+VSICurlFilesystemHandler::GetRegionCacheShards()
 {
-    static std::map<VSICurlFilesystemHandler*, CachedConnection> dummyCache;
-    int bMemoryErrorOccurred = false;
-    void* pData = CPLGetTLSEx(CTLS_VSICURL_CACHEDCONNECTION, &bMemoryErrorOccurred);
-    if( bMemoryErrorOccurred )
-    {
-        return dummyCache;
-    }
-    if( pData == nullptr)
+    std::call_once(m_oRegionCacheInitFlag, [this]()
     {
-        auto cachedConnection = new std::map<VSICurlFilesystemHandler*, CachedConnection>();
-        CPLSetTLSWithFreeFuncEx( CTLS_VSICURL_CACHEDCONNECTION,
-                                 cachedConnection,
-                                 FreeCachedConnection, &bMemoryErrorOccurred );
-        if( bMemoryErrorOccurred )
+        const int nShards = std::max(1, std::min(256,
+            atoi(CPLGetConfigOption("CPL_VSIL_CURL_CACHE_SHARDS", "16"))));
+        m_nRegionCacheMaxBytes = static_cast<size_t>(GetCacheSize());
+        for( int i = 0; i < nShards; i++ )
         {
-            delete cachedConnection;
-            return dummyCache;
+            std::unique_ptr<RegionCacheShard> poShard(new RegionCacheShard());
+            // Eviction is done by AddRegion() according to the byte budget,
+            // so the number of entries is not bounded at the lru11 level.
+            poShard->poCache.reset(new RegionCacheType(0));
+            m_apoRegionCacheShardsDoNotUseDirectly.push_back(
+                std::move(poShard));
         }
-        return *cachedConnection;
-    }
-    return *static_cast<std::map<VSICurlFilesystemHandler*, CachedConnection>*>(pData);
-}
-#else
-static thread_local std::map<VSICurlFilesystemHandler*, CachedConnection> g_tls_connectionCache;
-static std::map<VSICurlFilesystemHandler*, CachedConnection>& GetConnectionCache()
-{
-    return g_tls_connectionCache;
+    });
+    return m_apoRegionCacheShardsDoNotUseDirectly;
 }
-#endif
 
 /************************************************************************/
-/*                              clear()                                 */
+/*                        GetRegionCacheShard()                         */
 /************************************************************************/
 
-void CachedConnection::clear()
+VSICurlFilesystemHandler::RegionCacheShard&
+VSICurlFilesystemHandler::GetRegionCacheShard( const FilenameOffsetPair& oKey )
 {
-    if( hCurlMultiHandle )
-    {
-        curl_multi_cleanup(hCurlMultiHandle);
-        hCurlMultiHandle = nullptr;
-    }
+    auto& apoShards = GetRegionCacheShards();
+    // Offsets are multiple of the chunk size, so the low bits of the hash
+    // are poorly distributed. Mix them before selecting the shard.
+    const GUInt64 nHash =
+        static_cast<GUInt64>(FilenameOffsetPairHasher()(oKey)) *
+            static_cast<GUInt64>(0x9E3779B97F4A7C15ULL);
+    return *(apoShards[static_cast<size_t>(nHash >> 32) % apoShards.size()]);
 }
 
 /************************************************************************/
-/*                  ~VSICurlFilesystemHandler()                         */
+/*                            ~VSICurlSlab()                            */
 /************************************************************************/
 
-//extern "C" int CPL_DLL GDALIsInGlobalDestructor();
-
-VSICurlFilesystemHandler::~VSICurlFilesystemHandler()
+VSICurlSlab::~VSICurlSlab()
 {
-    VSICurlFilesystemHandler::ClearCache();
-    //if( !GDALIsInGlobalDestructor() )
-    //{
-        GetConnectionCache().erase(this);
-    //}
-
-    if( hMutex != nullptr )
-        CPLDestroyMutex( hMutex );
-    hMutex = nullptr;
+    m_poPool->Release(m_pabyData, m_nCapacity);
 }
 
 /************************************************************************/
-/*                      AllowCachedDataFor()                            */
+/*                          ~VSICurlSlabPool()                          */
 /************************************************************************/
 
-bool VSICurlFilesystemHandler::AllowCachedDataFor(const char* pszFilename)
+VSICurlSlabPool::~VSICurlSlabPool()
 {
-    bool bCachedAllowed = true;
-    char** papszTokens = CSLTokenizeString2(
-        CPLGetConfigOption("CPL_VSIL_CURL_NON_CACHED", ""), ":", 0 );
-    for( int i = 0; papszTokens && papszTokens[i]; i++)
-    {
-        if( STARTS_WITH(pszFilename, papszTokens[i]) )
-        {
-            bCachedAllowed = false;
-            break;
-        }
-    }
-    CSLDestroy(papszTokens);
-    return bCachedAllowed;
+    for( char* pabyData: m_apabyFree )
+        VSIFree(pabyData);
 }
 
 /************************************************************************/
-/*                     GetCurlMultiHandleFor()                          */
+/*                              Acquire()                               */
 /************************************************************************/
 
-CURLM* VSICurlFilesystemHandler::GetCurlMultiHandleFor(const CPLString& /*osURL*/)
+std::shared_ptr<VSICurlSlab> VSICurlSlabPool::Acquire( size_t nCapacity )
 {
-    auto& conn = GetConnectionCache()[this];
-    if( conn.hCurlMultiHandle == nullptr )
+    char* pabyData = nullptr;
     {
-        conn.hCurlMultiHandle = curl_multi_init();
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( nCapacity != m_nSlabSize )
+        {
+            // The chunk size has changed: forget about the previous slabs.
+            for( char* pabyFree: m_apabyFree )
+                VSIFree(pabyFree);
+            m_apabyFree.clear();
+            m_nSlabSize = nCapacity;
+        }
+        else if( !m_apabyFree.empty() )
+        {
+            pabyData = m_apabyFree.back();
+            m_apabyFree.pop_back();
+        }
     }
-    return conn.hCurlMultiHandle;
+    if( pabyData == nullptr )
+    {
+        pabyData = static_cast<char*>(VSI_MALLOC_VERBOSE(nCapacity));
+        if( pabyData == nullptr )
+            return nullptr;
+    }
+    return std::make_shared<VSICurlSlab>(this, pabyData, nCapacity);
 }
 
 /************************************************************************/
-/*                          GetRegionCache()                            */
+/*                              Release()                               */
 /************************************************************************/
 
-VSICurlFilesystemHandler::RegionCacheType* VSICurlFilesystemHandler::GetRegionCache()
+void VSICurlSlabPool::Release( char* pabyData, size_t nCapacity )
 {
-    // should be called under hMutex taken
-    if( m_poRegionCacheDoNotUseDirectly == nullptr )
+    // Slabs evicted from the region cache are usually reused right away by
+    // the next download, so a small free list is enough.
+    constexpr size_t MAX_FREE_BYTES = 16 * 1024 * 1024;
     {
-        m_poRegionCacheDoNotUseDirectly.reset(new RegionCacheType(static_cast<size_t>(GetMaxRegions())));
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( nCapacity == m_nSlabSize &&
+            (m_apabyFree.size() + 1) * nCapacity <= MAX_FREE_BYTES )
+        {
+            m_apabyFree.push_back(pabyData);
+            return;
+        }
     }
-    return m_poRegionCacheDoNotUseDirectly.get();
+    VSIFree(pabyData);
 }
 
 /************************************************************************/
 /*                          GetRegion()                                 */
 /************************************************************************/
 
-std::shared_ptr<std::string>
+std::shared_ptr<VSICurlSlab>
 VSICurlFilesystemHandler::GetRegion( const char* pszURL,
                                      vsi_l_offset nFileOffsetStart )
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
     nFileOffsetStart =
         (nFileOffsetStart / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
 
-    std::shared_ptr<std::string> out;
-    if( GetRegionCache()->tryGet(
-        FilenameOffsetPair(std::string(pszURL), nFileOffsetStart), out) )
+    const FilenameOffsetPair oKey(std::string(pszURL), nFileOffsetStart);
+    {
+        auto& oShard = GetRegionCacheShard(oKey);
+        std::lock_guard<std::mutex> oLock(oShard.oMutex);
+
+        std::shared_ptr<VSICurlSlab> out;
+        if( oShard.poCache->tryGet(oKey, out) )
+        {
+            oShard.nHits++;
+            return out;
+        }
+
+        oShard.nMisses++;
+    }
+
+    VSICurlDiskCache* poDiskCache = VSICurlDiskCache::Get();
+    FileProp oFileProp;
+    if( poDiskCache && GetCachedFileProp(pszURL, oFileProp) )
     {
-        return out;
+        auto value = m_oSlabPool.Acquire(knDOWNLOAD_CHUNK_SIZE);
+        if( value &&
+            poDiskCache->Read(pszURL, oFileProp, nFileOffsetStart, *value) )
+        {
+            InsertRegion(oKey, value);
+            return value;
+        }
     }
 
     return nullptr;
@@ -2755,13 +4731,111 @@ void VSICurlFilesystemHandler::AddRegion( const char* pszURL,
                                           size_t nSize,
                                           const char *pData )
 {
-    CPLMutexHolder oHolder( &hMutex );
+    auto value = m_oSlabPool.Acquire(VSICURLGetDownloadChunkSize());
+    if( value == nullptr )
+        return;
+    CPLAssert( nSize <= value->capacity() );
+    memcpy(value->data(), pData, nSize);
+    value->resize(nSize);
+    AddRegion(pszURL, nFileOffsetStart, value);
+}
+
+void VSICurlFilesystemHandler::AddRegion(
+                                const char* pszURL,
+                                vsi_l_offset nFileOffsetStart,
+                                const std::shared_ptr<VSICurlSlab>& poSlab )
+{
+    InsertRegion(FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
+                 poSlab);
+
+    VSICurlDiskCache* poDiskCache = VSICurlDiskCache::Get();
+    FileProp oFileProp;
+    if( poDiskCache && GetCachedFileProp(pszURL, oFileProp) )
+    {
+        poDiskCache->Write(pszURL, oFileProp, nFileOffsetStart, poSlab);
+    }
+}
+
+/************************************************************************/
+/*                           InsertRegion()                             */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::InsertRegion(
+                            const FilenameOffsetPair& oKey,
+                            const std::shared_ptr<VSICurlSlab>& value )
+{
+    {
+        auto& oShard = GetRegionCacheShard(oKey);
+        std::lock_guard<std::mutex> oLock(oShard.oMutex);
+
+        // Regions are charged the capacity of their slab, which is a whole
+        // download chunk even for a short region at the end of a file.
+        std::shared_ptr<VSICurlSlab> oldValue;
+        if( oShard.poCache->tryGet(oKey, oldValue) )
+        {
+            oShard.nBytes -= oldValue->capacity();
+            m_nRegionCacheBytes -= oldValue->capacity();
+        }
+        oShard.poCache->insert(oKey, value);
+        oShard.nBytes += value->capacity();
+        m_nRegionCacheBytes += value->capacity();
+    }
+
+    // While the global budget is exceeded, evict the least recently used
+    // region of each shard in turn, so that cold regions are reclaimed
+    // whatever the shard they live in. Only one shard lock is held at a
+    // time. The region just inserted is never evicted.
+    const auto& apoShards = GetRegionCacheShards();
+    size_t nShardsWithoutEviction = 0;
+    while( m_nRegionCacheBytes > m_nRegionCacheMaxBytes &&
+           nShardsWithoutEviction < apoShards.size() )
+    {
+        auto& oShard = *(apoShards[m_nRegionCacheEvictCursor++ %
+                                   apoShards.size()]);
+        std::lock_guard<std::mutex> oLock(oShard.oMutex);
+        FilenameOffsetPair oOldestKey(std::string(), 0);
+        std::shared_ptr<VSICurlSlab> oldestValue;
+        if( !oShard.poCache->getOldestEntry(oOldestKey, oldestValue) ||
+            oOldestKey == oKey )
+        {
+            nShardsWithoutEviction++;
+            continue;
+        }
+        nShardsWithoutEviction = 0;
+        oShard.poCache->remove(oOldestKey);
+        oShard.nBytes -= oldestValue->capacity();
+        m_nRegionCacheBytes -= oldestValue->capacity();
+    }
+}
 
-    std::shared_ptr<std::string> value(new std::string());
-    value->assign(pData, nSize);
-    GetRegionCache()->insert(
-        FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
-        value);
+/************************************************************************/
+/*                          RemoveRegionsIf()                           */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::RemoveRegionsIf(
+    const std::function<bool(const FilenameOffsetPair&)>& pfnPredicate )
+{
+    for( auto& poShard: GetRegionCacheShards() )
+    {
+        std::lock_guard<std::mutex> oLock(poShard->oMutex);
+        std::list<FilenameOffsetPair> keysToRemove;
+        size_t nRemovedBytes = 0;
+        auto lambda = [&keysToRemove, &nRemovedBytes, &pfnPredicate](
+            const lru11::KeyValuePair<FilenameOffsetPair,
+                                      std::shared_ptr<VSICurlSlab>>& kv)
+        {
+            if( pfnPredicate(kv.key) )
+            {
+                keysToRemove.push_back(kv.key);
+                nRemovedBytes += kv.value->capacity();
+            }
+        };
+        poShard->poCache->cwalk(lambda);
+        for( auto& key: keysToRemove )
+            poShard->poCache->remove(key);
+        poShard->nBytes -= nRemovedBytes;
+        m_nRegionCacheBytes -= nRemovedBytes;
+    }
 }
 
 /************************************************************************/
@@ -2806,7 +4880,9 @@ VSICurlFilesystemHandler::GetCachedDirList( const char* pszURL,
 
     return oCacheDirList.tryGet(std::string(pszURL), oCachedDirList) &&
             // Let a chance to use new auth parameters
-           gnGenerationAuthParameters == oCachedDirList.nGenerationAuthParameters;
+           gnGenerationAuthParameters == oCachedDirList.nGenerationAuthParameters &&
+           (oCachedDirList.nExpireTimestampLocal == 0 ||
+            time(nullptr) < oCachedDirList.nExpireTimestampLocal);
 }
 
 /************************************************************************/
@@ -2864,6 +4940,109 @@ bool VSICurlFilesystemHandler::ExistsInCacheDirList(
     }
 }
 
+/************************************************************************/
+/*                   GetExistenceFromParentListing()                    */
+/************************************************************************/
+
+// Tells whether osFilename exists from the listing of its parent directory.
+// When a second Stat() in a directory misses the file property cache, the
+// directory is listed once (up to CPL_VSIL_CURL_STAT_LIST_DIR_MAX_FILES
+// entries), so that the following sibling probes, like .aux.xml or .ovr
+// ones, are answered without a HEAD request, whether the file exists or not.
+// Such a listing is trusted for CPL_VSIL_CURL_STAT_LIST_DIR_TTL seconds.
+
+ExistStatus VSICurlFilesystemHandler::GetExistenceFromParentListing(
+                                                const CPLString& osFilename )
+{
+    CPLString osFilenameWithoutSlash(osFilename);
+    while( !osFilenameWithoutSlash.empty() &&
+           osFilenameWithoutSlash.back() == '/' )
+    {
+        osFilenameWithoutSlash.resize(osFilenameWithoutSlash.size() - 1);
+    }
+    const CPLString osDirname(CPLGetDirname(osFilenameWithoutSlash));
+    if( !STARTS_WITH_CI(osDirname, GetFSPrefix()) )
+        return EXIST_UNKNOWN;
+    const CPLString osFilenameOnly(CPLGetFilename(osFilenameWithoutSlash));
+
+    const auto IsInList = [&osFilenameOnly](const CachedDirList& oList)
+    {
+        for( int i = 0; i < oList.oFileList.size(); i++ )
+        {
+            if( oList.oFileList[i] == osFilenameOnly )
+                return EXIST_YES;
+        }
+        return EXIST_NO;
+    };
+
+    CachedDirList cachedDirList;
+    if( GetCachedDirList(osDirname, cachedDirList) )
+    {
+        return cachedDirList.bGotFileList ? IsInList(cachedDirList) :
+                                            EXIST_UNKNOWN;
+    }
+
+    const int nMaxFiles = atoi(
+        CPLGetConfigOption("CPL_VSIL_CURL_STAT_LIST_DIR_MAX_FILES", "1000"));
+    const char* pszOptionVal =
+        CPLGetConfigOption( "GDAL_DISABLE_READDIR_ON_OPEN", "NO" );
+    if( nMaxFiles <= 0 ||
+        EQUAL(pszOptionVal, "EMPTY_DIR") || CPLTestBool(pszOptionVal) ||
+        !AllowCachedDataFor(osFilename) )
+    {
+        return EXIST_UNKNOWN;
+    }
+
+    FileProp cachedFileProp;
+    if( GetCachedFileProp(GetURLFromFilename(osFilenameWithoutSlash),
+                          cachedFileProp) )
+    {
+        return EXIST_UNKNOWN;
+    }
+
+    const time_t nNow = time(nullptr);
+    const int nTTL = std::max(0, atoi(
+        CPLGetConfigOption("CPL_VSIL_CURL_STAT_LIST_DIR_TTL", "60")));
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        StatListingState oState;
+        m_oCacheStatListingState.tryGet(osDirname, oState);
+        if( nNow < oState.nSkipUntil )
+            return EXIST_UNKNOWN;
+        // A single miss is cheaper to resolve with a HEAD request.
+        oState.nMisses ++;
+        if( oState.nMisses < 2 )
+        {
+            m_oCacheStatListingState.insert(osDirname, oState);
+            return EXIST_UNKNOWN;
+        }
+        m_oCacheStatListingState.remove(osDirname);
+    }
+
+    CPLDebug(GetDebugKey(), "Listing %s to answer Stat() requests",
+             osDirname.c_str());
+    char** papszFileList = ReadDirInternal(osDirname, nMaxFiles, nullptr);
+    CSLDestroy(papszFileList);
+
+    // ReadDirInternal() does not cache listings truncated to nMaxFiles.
+    if( !GetCachedDirList(osDirname, cachedDirList) ||
+        !cachedDirList.bGotFileList )
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        StatListingState oState;
+        oState.nSkipUntil = nNow + nTTL;
+        m_oCacheStatListingState.insert(osDirname, oState);
+        return EXIST_UNKNOWN;
+    }
+
+    if( cachedDirList.nExpireTimestampLocal == 0 )
+    {
+        cachedDirList.nExpireTimestampLocal = nNow + nTTL;
+        SetCachedDirList(osDirname, cachedDirList);
+    }
+    return IsInList(cachedDirList);
+}
+
 /************************************************************************/
 /*                        InvalidateCachedData()                        */
 /************************************************************************/
@@ -2875,19 +5054,9 @@ void VSICurlFilesystemHandler::InvalidateCachedData( const char* pszURL )
     oCacheFileProp.remove(std::string(pszURL));
 
     // Invalidate all cached regions for this URL
-    std::list<FilenameOffsetPair> keysToRemove;
-    std::string osURL(pszURL);
-    auto lambda = [&keysToRemove, &osURL](
-        const lru11::KeyValuePair<FilenameOffsetPair,
-                                  std::shared_ptr<std::string>>& kv)
-    {
-        if( kv.key.filename_ == osURL )
-            keysToRemove.push_back(kv.key);
-    };
-    auto* poRegionCache = GetRegionCache();
-    poRegionCache->cwalk(lambda);
-    for( auto& key: keysToRemove )
-        poRegionCache->remove(key);
+    const std::string osURL(pszURL);
+    RemoveRegionsIf([&osURL](const FilenameOffsetPair& oKey)
+                    { return oKey.filename_ == osURL; });
 }
 
 /************************************************************************/
@@ -2898,12 +5067,30 @@ void VSICurlFilesystemHandler::ClearCache()
 {
     CPLMutexHolder oHolder( &hMutex );
 
-    GetRegionCache()->clear();
+    int iShard = 0;
+    for( auto& poShard: GetRegionCacheShards() )
+    {
+        std::lock_guard<std::mutex> oLock(poShard->oMutex);
+        if( poShard->nHits + poShard->nMisses > 0 )
+        {
+            CPLDebug(GetDebugKey(),
+                     "Region cache shard %d: " CPL_FRMT_GUIB " hits, "
+                     CPL_FRMT_GUIB " misses",
+                     iShard, poShard->nHits, poShard->nMisses);
+        }
+        m_nRegionCacheBytes -= poShard->nBytes;
+        poShard->poCache->clear();
+        poShard->nBytes = 0;
+        poShard->nHits = 0;
+        poShard->nMisses = 0;
+        iShard++;
+    }
 
     oCacheFileProp.clear();
 
     oCacheDirList.clear();
     nCachedFilesInDirList = 0;
+    m_oCacheStatListingState.clear();
 
     //if( !GDALIsInGlobalDestructor() )
     //{
@@ -2920,20 +5107,8 @@ void VSICurlFilesystemHandler::PartialClearCache(const char* pszFilenamePrefix)
     CPLMutexHolder oHolder( &hMutex );
 
     CPLString osURL = GetURLFromFilename(pszFilenamePrefix);
-    {
-        std::list<FilenameOffsetPair> keysToRemove;
-        auto lambda = [&keysToRemove, &osURL](
-            const lru11::KeyValuePair<FilenameOffsetPair,
-                                                std::shared_ptr<std::string>>& kv)
-        {
-            if( strncmp(kv.key.filename_.c_str(), osURL, osURL.size()) == 0 )
-                keysToRemove.push_back(kv.key);
-        };
-        auto* poRegionCache = GetRegionCache();
-        poRegionCache->cwalk(lambda);
-        for( auto& key: keysToRemove )
-            poRegionCache->remove(key);
-    }
+    RemoveRegionsIf([&osURL](const FilenameOffsetPair& oKey)
+        { return strncmp(oKey.filename_.c_str(), osURL, osURL.size()) == 0; });
 
     {
         std::list<std::string> keysToRemove;
@@ -2964,6 +5139,20 @@ void VSICurlFilesystemHandler::PartialClearCache(const char* pszFilenamePrefix)
         for( auto& key: keysToRemove )
             oCacheDirList.remove(key);
     }
+
+    {
+        const size_t nLen = strlen(pszFilenamePrefix);
+        std::list<std::string> keysToRemove;
+        auto lambda = [&keysToRemove, pszFilenamePrefix, nLen](
+            const lru11::KeyValuePair<std::string, StatListingState>& kv)
+        {
+            if( strncmp(kv.key.c_str(), pszFilenamePrefix, nLen) == 0 )
+                keysToRemove.push_back(kv.key);
+        };
+        m_oCacheStatListingState.cwalk(lambda);
+        for( auto& key: keysToRemove )
+            m_oCacheStatListingState.remove(key);
+    }
 }
 
 /************************************************************************/
@@ -3013,9 +5202,16 @@ const char* VSICurlFilesystemHandler::GetActualURL(const char* pszFilename)
     "  </Option>" \
     "  <Option name='GDAL_HTTP_MULTIPLEX' type='boolean' " \
         "description='Whether to enable HTTP/2 multiplexing' default='YES'/>" \
+    "  <Option name='CPL_VSIL_CURL_MERGE_GAP' type='int' " \
+        "description='Maximum gap in bytes between two ranges of a multi-range " \
+        "read that are merged in a single request. By default, estimated " \
+        "from the measured round-trip time and bandwidth'/>" \
     "  <Option name='GDAL_HTTP_MERGE_CONSECUTIVE_RANGES' type='boolean' " \
-        "description='Whether to merge consecutive ranges in multirange " \
-        "requests' default='YES'/>" \
+        "description='Whether to merge consecutive or nearby ranges in " \
+        "multirange requests' default='YES'/>" \
+    "  <Option name='GDAL_HTTP_ENABLE_ADVISE_READ' type='boolean' " \
+        "description='Whether ranges passed to AdviseRead() should be " \
+        "prefetched in the background' default='YES'/>" \
     "  <Option name='CPL_VSIL_CURL_NON_CACHED' type='string' " \
         "description='Colon-separated list of filenames whose content" \
         "must not be cached across open attempts'/>" \
@@ -3040,6 +5236,46 @@ const char* VSICurlFilesystemHandler::GetActualURL(const char* pszFilename)
     "  <Option name='CPL_VSIL_CURL_CACHE_SIZE' type='integer' " \
         "description='Size in bytes of the global /vsicurl/ cache' " \
         "default='16384000'/>" \
+    "  <Option name='CPL_VSIL_CURL_CACHE_SHARDS' type='integer' " \
+        "description='Number of independently locked partitions of the " \
+        "global /vsicurl/ cache' default='16' min='1' max='256'/>" \
+    "  <Option name='CPL_VSIL_CURL_DISK_CACHE_DIR' type='string' " \
+        "description='Directory where downloaded chunks are persistently " \
+        "cached. Can be shared by several processes'/>" \
+    "  <Option name='CPL_VSIL_CURL_DISK_CACHE_SIZE' type='integer' " \
+        "description='Size in bytes of the persistent disk cache' " \
+        "default='1073741824'/>" \
+    "  <Option name='CPL_VSIL_CURL_ADAPTIVE_READAHEAD' type='boolean' " \
+        "description='Whether to prefetch the next ranges of strided or " \
+        "reverse reads' default='YES'/>" \
+    "  <Option name='CPL_VSIL_CURL_STAT_LIST_DIR_MAX_FILES' type='int' " \
+        "description='Maximum number of files of a directory listed to " \
+        "answer Stat() requests on its files. 0 to disable' default='1000'/>" \
+    "  <Option name='CPL_VSIL_CURL_STAT_LIST_DIR_TTL' type='int' " \
+        "description='Duration in seconds during which a directory listing " \
+        "made for Stat() requests is trusted' default='60'/>" \
+    "  <Option name='CPL_VSIL_CURL_SHARED_CONNECTIONS' type='boolean' " \
+        "description='Whether all threads share the DNS cache, TLS sessions " \
+        "and, for single range requests, connections' default='NO'/>" \
+    "  <Option name='CPL_VSIL_CURL_MAX_HOST_CONNECTIONS' type='int' " \
+        "description='Maximum number of connections to a host per thread, " \
+        "or per process for the connections shared with " \
+        "CPL_VSIL_CURL_SHARED_CONNECTIONS. 0 for no limit' default='0'/>" \
+    "  <Option name='CPL_VSIL_CURL_PARALLEL_READ_THRESHOLD' type='int' " \
+        "description='Minimum size in bytes of a read to download it with " \
+        "several connections. 0 to disable' default='16777216'/>" \
+    "  <Option name='CPL_VSIL_CURL_PARALLEL_READ_CONNECTIONS' type='int' " \
+        "description='Number of connections used for large reads' " \
+        "default='4'/>" \
+    "  <Option name='CPL_VSIL_CURL_HEDGED_REQUESTS' type='boolean' " \
+        "description='Whether to issue a duplicate range request when the " \
+        "first one is slower than usual to respond' default='NO'/>" \
+    "  <Option name='CPL_VSIL_CURL_HEDGE_PERCENTILE' type='double' " \
+        "description='Percentile of the recent times to first byte after " \
+        "which a request is hedged' default='95' min='0' max='100'/>" \
+    "  <Option name='CPL_VSIL_CURL_HEDGE_MIN_DELAY' type='double' " \
+        "description='Minimum delay in seconds before a request is hedged' " \
+        "default='0.1'/>" \
     "  <Option name='CPL_VSIL_CURL_IGNORE_GLACIER_STORAGE' type='boolean' " \
         "description='Whether to skip files with Glacier storage class in " \
         "directory listing.' default='YES'/>"
@@ -4850,6 +7086,68 @@ int VSICurlUninstallReadCbk( VSILFILE* fp )
     return reinterpret_cast<cpl::VSICurlHandle *>(fp)->UninstallReadCbk();
 }
 
+/************************************************************************/
+/*                      VSICurlGetShareHandle()                         */
+/************************************************************************/
+
+// Process-wide curl share handle, used when CPL_VSIL_CURL_SHARED_CONNECTIONS
+// is set, so that the requests of all threads and all /vsicurl/ like
+// filesystems share the DNS cache and the TLS session cache. The connection
+// cache is not shared, as libcurl does not support using it from multi
+// handles driven by different threads: connections are instead shared
+// through the single multi handle of VSICurlSharedMulti.
+
+namespace {
+struct VSICurlShare
+{
+    CURLSH*     hShare = nullptr;
+    std::mutex  aoMutexes[CURL_LOCK_DATA_LAST]{};
+
+    VSICurlShare()
+    {
+        hShare = curl_share_init();
+        if( hShare == nullptr )
+            return;
+        curl_share_setopt(hShare, CURLSHOPT_LOCKFUNC, LockFunc);
+        curl_share_setopt(hShare, CURLSHOPT_UNLOCKFUNC, UnlockFunc);
+        curl_share_setopt(hShare, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(hShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(hShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    ~VSICurlShare()
+    {
+        // Fails harmlessly if a handle still uses it.
+        if( hShare )
+            curl_share_cleanup(hShare);
+    }
+
+    static void LockFunc( CURL*, curl_lock_data eData, curl_lock_access,
+                          void* pUserData )
+    {
+        static_cast<VSICurlShare*>(pUserData)->aoMutexes[eData].lock();
+    }
+
+    static void UnlockFunc( CURL*, curl_lock_data eData, void* pUserData )
+    {
+        static_cast<VSICurlShare*>(pUserData)->aoMutexes[eData].unlock();
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(VSICurlShare)
+};
+} // namespace
+
+static CURLSH* VSICurlGetShareHandle()
+{
+    if( !CPLTestBool(
+            CPLGetConfigOption("CPL_VSIL_CURL_SHARED_CONNECTIONS", "NO")) )
+    {
+        return nullptr;
+    }
+    static VSICurlShare oShare;
+    return oShare.hShare;
+}
+
 /************************************************************************/
 /*                       VSICurlSetOptions()                            */
 /************************************************************************/
@@ -4861,6 +7159,10 @@ struct curl_slist* VSICurlSetOptions(
     struct curl_slist* headers = static_cast<struct curl_slist*>(
         CPLHTTPSetOptions(hCurlHandle, pszURL, papszOptions));
 
+    CURLSH* hShare = VSICurlGetShareHandle();
+    if( hShare )
+        curl_easy_setopt(hCurlHandle, CURLOPT_SHARE, hShare);
+
     long option = CURLFTPMETHOD_SINGLECWD;
     curl_easy_setopt(hCurlHandle, CURLOPT_FTP_FILEMETHOD, option);
 
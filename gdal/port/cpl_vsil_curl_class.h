@@ -38,13 +38,18 @@
 #include "cpl_string.h"
 #include "cpl_vsil_curl_priv.h"
 #include "cpl_mem_cache.h"
+#include "cpl_worker_thread_pool.h"
 
 #include "cpl_curl_priv.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <set>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 //! @cond Doxygen_Suppress
 
@@ -94,13 +99,68 @@ struct CachedDirList
 {
     bool            bGotFileList = false;
     unsigned int    nGenerationAuthParameters = 0;
+    time_t          nExpireTimestampLocal = 0; /* 0 for no expiration */
     CPLStringList   oFileList{}; /* only file name without path */
 };
 
+// State of the parent directory listings triggered by Stat() misses.
+struct StatListingState
+{
+    int             nMisses = 0;
+    time_t          nSkipUntil = 0;
+};
+
+class VSICurlSlabPool;
+
+// Reference counted buffer of fixed capacity (the download chunk size),
+// holding one region of a remote file. Its memory comes from a
+// VSICurlSlabPool and goes back to it with the last reference.
+class VSICurlSlab
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSICurlSlab)
+
+    VSICurlSlabPool* m_poPool = nullptr;
+    char*            m_pabyData = nullptr;
+    size_t           m_nCapacity = 0;
+    size_t           m_nSize = 0;
+
+  public:
+    VSICurlSlab( VSICurlSlabPool* poPool, char* pabyData, size_t nCapacity ):
+        m_poPool(poPool), m_pabyData(pabyData), m_nCapacity(nCapacity) {}
+    ~VSICurlSlab();
+
+    const char* data() const { return m_pabyData; }
+    char*       data() { return m_pabyData; }
+    size_t      size() const { return m_nSize; }
+    size_t      capacity() const { return m_nCapacity; }
+    void        resize( size_t nSize ) { m_nSize = nSize; }
+};
+
+class VSICurlSlabPool
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSICurlSlabPool)
+
+    std::mutex          m_oMutex{};
+    size_t              m_nSlabSize = 0;
+    std::vector<char*>  m_apabyFree{};
+
+  public:
+    VSICurlSlabPool() = default;
+    ~VSICurlSlabPool();
+
+    std::shared_ptr<VSICurlSlab> Acquire( size_t nCapacity );
+    void                         Release( char* pabyData, size_t nCapacity );
+};
+
 struct WriteFuncStruct
 {
     char*           pBuffer = nullptr;
     size_t          nSize = 0;
+    // If set, the body is written in slabs of nSlabSize bytes taken from
+    // this pool, instead of pBuffer.
+    VSICurlSlabPool* poSlabPool = nullptr;
+    size_t          nSlabSize = 0;
+    std::vector<std::shared_ptr<VSICurlSlab>> apoSlabs{};
     bool            bIsHTTP = false;
     bool            bIsInHeader = false;
     bool            bMultiRange = false;
@@ -181,22 +241,65 @@ class VSICurlFilesystemHandler : public VSIFilesystemHandler
     };
 
     using RegionCacheType =
-        lru11::Cache<FilenameOffsetPair, std::shared_ptr<std::string>,
+        lru11::Cache<FilenameOffsetPair, std::shared_ptr<VSICurlSlab>,
             lru11::NullLock,
             std::unordered_map<
                 FilenameOffsetPair,
                 typename std::list<lru11::KeyValuePair<FilenameOffsetPair,
-                    std::shared_ptr<std::string>>>::iterator,
+                    std::shared_ptr<VSICurlSlab>>>::iterator,
                     FilenameOffsetPairHasher>>;
 
-    std::unique_ptr<RegionCacheType> m_poRegionCacheDoNotUseDirectly{}; // do not access directly. Use GetRegionCache();
-    RegionCacheType* GetRegionCache();
+    // The region cache is split into shards, each one with its own lock,
+    // so that concurrent readers of different regions do not contend.
+    // The byte budget (CPL_VSIL_CURL_CACHE_SIZE) is global and counts the
+    // capacity of the slabs: when it is exceeded, shards are visited in
+    // turn to evict their oldest region.
+    struct RegionCacheShard
+    {
+        std::mutex                       oMutex{};
+        std::unique_ptr<RegionCacheType> poCache{};
+        size_t                           nBytes = 0;
+        GUIntBig                         nHits = 0;
+        GUIntBig                         nMisses = 0;
+    };
+
+    // Must be declared before the region cache, which holds slabs from it.
+    VSICurlSlabPool     m_oSlabPool{};
+
+    std::vector<std::unique_ptr<RegionCacheShard>> m_apoRegionCacheShardsDoNotUseDirectly{}; // do not access directly. Use GetRegionCacheShard();
+    std::once_flag      m_oRegionCacheInitFlag{};
+    std::atomic<size_t> m_nRegionCacheBytes{0};
+    size_t              m_nRegionCacheMaxBytes = 0;
+    std::atomic<size_t> m_nRegionCacheEvictCursor{0};
+
+    RegionCacheShard&   GetRegionCacheShard( const FilenameOffsetPair& oKey );
+    void                InsertRegion( const FilenameOffsetPair& oKey,
+                                      const std::shared_ptr<VSICurlSlab>& value );
+    std::vector<std::unique_ptr<RegionCacheShard>>& GetRegionCacheShards();
+    void                RemoveRegionsIf( const std::function<bool(const FilenameOffsetPair&)>& pfnPredicate );
 
     lru11::Cache<std::string, FileProp>  oCacheFileProp;
 
+    // Time to first byte of the last range GETs, in seconds. Used to
+    // decide when a request should be hedged.
+    std::mutex          m_oFirstByteLatencyMutex{};
+    std::vector<double> m_adfFirstByteLatencies{};
+    size_t              m_nFirstByteLatencyIdx = 0;
+
+    // Smoothed round-trip time (in seconds) and download rate (in bytes/s)
+    // of the last range GETs. Used to size the gaps merged by
+    // ReadMultiRange().
+    std::mutex          m_oTransferStatsMutex{};
+    double              m_dfSmoothedRTT = 0;
+    double              m_dfSmoothedBandwidth = 0;
+
     int                                       nCachedFilesInDirList = 0;
     lru11::Cache<std::string, CachedDirList>  oCacheDirList;
 
+    // Per directory, number of Stat() misses and, if its listing failed or
+    // was too large, time before which it should not be listed again.
+    lru11::Cache<std::string, StatListingState> m_oCacheStatListingState{1024, 0};
+
     char**              ParseHTMLFileList(const char* pszFilename,
                                           int nMaxFiles,
                                           char* pszData,
@@ -271,13 +374,18 @@ public:
     virtual CPLString GetFSPrefix() const { return "/vsicurl/"; }
     virtual bool      AllowCachedDataFor(const char* pszFilename);
 
-    std::shared_ptr<std::string> GetRegion( const char* pszURL,
+    std::shared_ptr<VSICurlSlab> GetRegion( const char* pszURL,
                                    vsi_l_offset nFileOffsetStart );
 
     void                AddRegion( const char* pszURL,
                                    vsi_l_offset nFileOffsetStart,
                                    size_t nSize,
                                    const char *pData );
+    void                AddRegion( const char* pszURL,
+                                   vsi_l_offset nFileOffsetStart,
+                                   const std::shared_ptr<VSICurlSlab>& poSlab );
+
+    VSICurlSlabPool&    GetSlabPool() { return m_oSlabPool; }
 
     bool                GetCachedFileProp( const char* pszURL,
                                            FileProp& oFileProp );
@@ -287,6 +395,11 @@ public:
 
     CURLM              *GetCurlMultiHandleFor( const CPLString& osURL );
 
+    void                AddFirstByteLatency( double dfSeconds );
+    double              GetFirstByteLatencyPercentile( double dfPercentile );
+    void                AddTransferStats( CURL* hCurlHandle );
+    vsi_l_offset        GetMergeGapBudget();
+
     virtual void        ClearCache();
     virtual void        PartialClearCache(const char* pszFilename);
 
@@ -296,6 +409,7 @@ public:
     void                SetCachedDirList( const char* pszURL,
                                           CachedDirList& oCachedDirList );
     bool ExistsInCacheDirList( const CPLString& osDirname, bool *pbIsDir );
+    ExistStatus GetExistenceFromParentListing( const CPLString& osFilename );
 
     virtual CPLString GetURLFromFilename( const CPLString& osFilename );
 };
@@ -332,12 +446,17 @@ class VSICurlHandle : public VSIVirtualHandle
     int                 m_nMaxRetry = 0;
     double              m_dfRetryDelay = 0.0;
 
+    bool                m_bHedgeRequests = false;
+    double              m_dfHedgePercentile = 95.0;
+    double              m_dfHedgeMinDelay = 0.1;
+
     CPLStringList       m_aosHeaders{};
 
-    void                DownloadRegionPostProcess( const vsi_l_offset startOffset,
-                                                   const int nBlocks,
-                                                   const char* pBuffer,
-                                                   size_t nSize );
+    void                DownloadRegionPostProcess(
+                            const vsi_l_offset startOffset,
+                            const int nBlocks,
+                            const std::vector<std::shared_ptr<VSICurlSlab>>&
+                                                                    apoSlabs );
 
   private:
 
@@ -345,7 +464,8 @@ class VSICurlHandle : public VSIVirtualHandle
 
     bool            bEOF = false;
 
-    virtual std::string DownloadRegion(vsi_l_offset startOffset, int nBlocks);
+    virtual std::vector<std::shared_ptr<VSICurlSlab>>
+                        DownloadRegion(vsi_l_offset startOffset, int nBlocks);
 
     bool                m_bUseHead = false;
 
@@ -353,6 +473,42 @@ class VSICurlHandle : public VSIVirtualHandle
                                          const vsi_l_offset* panOffsets,
                                          const size_t* panSizes );
     CPLString    GetRedirectURLIfValid(bool& bHasExpired);
+    CURL*        MultiPerformHedged( CURLM* hCurlMultiHandle,
+                                     CURL* hCurlHandle,
+                                     WriteFuncStruct& sWriteFuncData,
+                                     WriteFuncStruct& sWriteFuncHeaderData,
+                                     char* pszCurlErrBuf );
+
+    // Background prefetching triggered by AdviseRead()
+    struct AdviseReadBatch;
+    std::unique_ptr<CPLWorkerThreadPool> m_poAdviseReadPool{};
+    std::mutex              m_oAdviseReadMutex{};
+    std::condition_variable m_oAdviseReadCV{};
+    std::set<vsi_l_offset>  m_oSetAdviseReadPendingBlocks{};
+    std::atomic<bool>       m_bAdviseReadInterrupted{false};
+
+    static void  AdviseReadJob( void* pData );
+    bool         IsAdvisedBlockPending( vsi_l_offset nBlockOffset );
+    bool         WaitForAdvisedBlock( vsi_l_offset nBlockOffset );
+
+    // Readahead of strided and reverse reads
+    bool                    m_bAdaptiveReadahead = true;
+    vsi_l_offset            m_nLastReadOffset = VSI_L_OFFSET_MAX;
+    size_t                  m_nLastReadSize = 0;
+    GIntBig                 m_nReadStride = 0;
+    int                     m_nReadaheadWindow = 1;
+    int                     m_nReadaheadHits = 0;
+    std::set<vsi_l_offset>  m_oSetPredictedBlocks{};
+
+    void         UpdateAccessPattern( vsi_l_offset nOffset, size_t nSize );
+    void         CheckPredictedBlock( vsi_l_offset nBlockOffset );
+
+    // Parallel download of large reads
+    size_t       m_nParallelReadThreshold = 0;
+    int          m_nParallelReadConnections = 0;
+
+    bool         ReadParallel( void* pBuffer, vsi_l_offset nOffset,
+                               size_t nSize );
 
   protected:
     virtual struct curl_slist* GetCurlHeaders( const CPLString& /*osVerb*/,
@@ -379,6 +535,8 @@ class VSICurlHandle : public VSIVirtualHandle
     int ReadMultiRange( int nRanges, void ** ppData,
                         const vsi_l_offset* panOffsets,
                         const size_t* panSizes ) override;
+    void AdviseRead( int nRanges, const vsi_l_offset* panOffsets,
+                     const size_t* panSizes ) override;
     size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
     int Eof() override;
     int Flush() override;
@@ -422,9 +580,6 @@ class IVSIS3LikeFSHandler: public VSICurlFilesystemHandler
                         int nMaxFiles,
                         bool* pbGotFileList ) override;
 
-    virtual IVSIS3LikeHandleHelper* CreateHandleHelper(
-            const char* pszURI, bool bAllowNoObject) = 0;
-
     virtual int      CopyObject( const char *oldpath, const char *newpath,
                                  CSLConstList papszMetadata );
 
@@ -440,6 +595,9 @@ class IVSIS3LikeFSHandler: public VSICurlFilesystemHandler
 
     virtual int      DeleteObject( const char *pszFilename );
 
+    virtual IVSIS3LikeHandleHelper* CreateHandleHelper(
+            const char* pszURI, bool bAllowNoObject) = 0;
+
     virtual void UpdateMapFromHandle(IVSIS3LikeHandleHelper*) {}
     virtual void UpdateHandleFromMap( IVSIS3LikeHandleHelper * ) {}
 
@@ -456,6 +614,7 @@ class IVSIS3LikeFSHandler: public VSICurlFilesystemHandler
 
     // Multipart upload
     virtual bool SupportsParallelMultipartUpload() const { return false; }
+    virtual bool SupportsUploadPartCopy() const { return false; }
 
     virtual CPLString InitiateMultipartUpload(
                                 const std::string& osFilename,
@@ -472,6 +631,16 @@ class IVSIS3LikeFSHandler: public VSICurlFilesystemHandler
                          IVSIS3LikeHandleHelper *poS3HandleHelper,
                          int nMaxRetry,
                          double dfRetryDelay);
+    virtual CPLString UploadPartCopy(const CPLString& osSource,
+                         const CPLString& osFilename,
+                         int nPartNumber,
+                         const std::string& osUploadID,
+                         vsi_l_offset nStartOffset,
+                         vsi_l_offset nSize,
+                         IVSIS3LikeHandleHelper *poS3HandleHelper,
+                         int nMaxRetry,
+                         double dfRetryDelay);
+    CPLStringList GetCopySourceOptions(const char* pszSource);
     virtual bool CompleteMultipart(const CPLString& osFilename,
                            const CPLString& osUploadID,
                            const std::vector<CPLString>& aosEtags,
@@ -552,6 +721,28 @@ class VSIS3WriteHandle final : public VSIVirtualHandle
     double              m_dfRetryDelay = 0.0;
     WriteFuncStruct     m_sWriteFuncHeaderData{};
 
+    // Parallel multipart upload
+    struct UploadJob
+    {
+        VSIS3WriteHandle   *poParent = nullptr;
+        GByte              *pabyBuffer = nullptr;
+        size_t              nSize = 0;
+        int                 nPartNumber = 0;
+    };
+
+    int                 m_nUploadThreads = 1;
+    int                 m_nAllocatedBuffers = 0;
+    std::unique_ptr<CPLWorkerThreadPool> m_poUploadPool{};
+    std::vector<GByte*> m_apabyFreeBuffers{};
+    int                 m_nPendingUploads = 0;
+    bool                m_bUploadError = false;
+    std::mutex          m_oUploadMutex{};
+    std::condition_variable m_oUploadCV{};
+
+    static void         UploadPartJob( void* pData );
+    bool                SubmitUploadPart();
+    bool                WaitPendingUploads();
+
     bool                UploadPart();
     bool                DoSinglePartPUT();
 
@@ -793,7 +984,8 @@ void VSICURLInitWriteFuncStruct( WriteFuncStruct   *psStruct,
 size_t VSICurlHandleWriteFunc( void *buffer, size_t count,
                                       size_t nmemb, void *req );
 void MultiPerform(CURLM* hCurlMultiHandle,
-                         CURL* hEasyHandle = nullptr);
+                         CURL* hEasyHandle = nullptr,
+                         bool bCallbacksInCallingThread = false);
 void VSICURLResetHeaderAndWriterFunctions(CURL* hCurlHandle);
 
 int VSICurlParseUnixPermissions(const char* pszPermissions);
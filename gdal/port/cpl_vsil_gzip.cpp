@@ -98,15 +98,19 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "cpl_error.h"
+#include "cpl_md5.h"
 #include "cpl_minizip_ioapi.h"
 #include "cpl_minizip_unzip.h"
 #include "cpl_multiproc.h"
@@ -226,6 +230,8 @@ class VSIGZipHandle final : public VSIVirtualHandle
     void              UnsetCanSaveInfo() { m_bCanSaveInfo = false; }
 };
 
+struct VSIGZipIndex;
+
 class VSIGZipFilesystemHandler final : public VSIFilesystemHandler
 {
     CPL_DISALLOW_COPY_ASSIGN(VSIGZipFilesystemHandler)
@@ -233,6 +239,9 @@ class VSIGZipFilesystemHandler final : public VSIFilesystemHandler
     CPLMutex* hMutex = nullptr;
     VSIGZipHandle* poHandleLastGZipFile = nullptr;
     bool           m_bInSaveInfo = false;
+    std::shared_ptr<VSIGZipIndex> m_poLastIndex{};
+
+    std::shared_ptr<VSIGZipIndex> GetIndex( const char* pszBaseFilename );
 
 public:
     VSIGZipFilesystemHandler() = default;
@@ -1182,6 +1191,742 @@ int VSIGZipHandle::Close()
     return 0;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                           VSIGZipIndex                               */
+/* ==================================================================== */
+/************************************************************************/
+
+// An index of access points into a gzip stream, following the approach of
+// zlib's examples/zran.c: at deflate block boundaries spaced by at least
+// nSpan bytes of uncompressed data, we record the position in the compressed
+// stream (to the bit), and the last 32 KB of uncompressed data before it,
+// which is the dictionary needed to resume inflating from there.
+// Each span between two access points can then be decompressed
+// independently of the others.
+
+constexpr int GZIP_WINDOW_SIZE = 32768;
+constexpr char GZIP_INDEX_SIGNATURE[] = "GDALGZIX";
+constexpr GUInt32 GZIP_INDEX_VERSION = 1;
+
+struct VSIGZipAccessPoint
+{
+    vsi_l_offset nCompressedOffset = 0;
+    vsi_l_offset nUncompressedOffset = 0;
+    int          nBits = 0;
+    std::string  osWindow{};  // zlib compressed dictionary
+};
+
+struct VSIGZipIndex
+{
+    CPLString    osBaseFilename{};
+    vsi_l_offset nCompressedSize = 0;
+    vsi_l_offset nUncompressedSize = 0;
+    GIntBig      nMTime = 0;
+    std::vector<VSIGZipAccessPoint> aoPoints{};
+
+    static std::shared_ptr<VSIGZipIndex> Build( const char* pszBaseFilename,
+                                                vsi_l_offset nSpan );
+    static std::shared_ptr<VSIGZipIndex> Load( const char* pszIndexFilename,
+                                               const char* pszBaseFilename,
+                                               const VSIStatBufL& sStat );
+    bool Save( const char* pszIndexFilename ) const;
+
+    size_t FindSpan( vsi_l_offset nOffset ) const;
+    vsi_l_offset GetSpanEnd( size_t nSpan ) const;
+    bool InflateSpan( VSILFILE* fp, size_t nSpan, std::string& osOut ) const;
+};
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+std::shared_ptr<VSIGZipIndex> VSIGZipIndex::Build( const char* pszBaseFilename,
+                                                   vsi_l_offset nSpan )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(pszBaseFilename, &sStat) != 0 )
+        return nullptr;
+    VSILFILE* fp = VSIFOpenL(pszBaseFilename, "rb");
+    if( fp == nullptr )
+        return nullptr;
+
+    std::vector<GByte> abyIn(Z_BUFSIZE);
+    std::vector<GByte> abyWindow(GZIP_WINDOW_SIZE);
+    std::vector<GByte> abyDict(GZIP_WINDOW_SIZE);
+    std::vector<GByte> abyCompressedDict(compressBound(GZIP_WINDOW_SIZE));
+
+    z_stream sStream;
+    memset(&sStream, 0, sizeof(sStream));
+    // 15 + 32: automatic detection of the gzip header
+    if( inflateInit2(&sStream, 15 + 32) != Z_OK )
+    {
+        CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+        return nullptr;
+    }
+
+    CPLDebug("GZIP", "Building index of %s", pszBaseFilename);
+
+    auto poIndex = std::make_shared<VSIGZipIndex>();
+    poIndex->osBaseFilename = pszBaseFilename;
+    poIndex->nCompressedSize = sStat.st_size;
+    poIndex->nMTime = static_cast<GIntBig>(sStat.st_mtime);
+
+    vsi_l_offset nTotalIn = 0;
+    vsi_l_offset nTotalOut = 0;
+    vsi_l_offset nLast = 0;
+    int nRet = Z_OK;
+    bool bOK = true;
+    while( true )
+    {
+        if( sStream.avail_in == 0 )
+        {
+            const size_t nRead =
+                VSIFReadL(abyIn.data(), 1, abyIn.size(), fp);
+            if( nRead == 0 )
+            {
+                if( nRet != Z_STREAM_END )
+                {
+                    CPLError(CE_Failure, CPLE_FileIO,
+                             "%s: premature end of gzip stream",
+                             pszBaseFilename);
+                    bOK = false;
+                }
+                break;
+            }
+            sStream.next_in = abyIn.data();
+            sStream.avail_in = static_cast<uInt>(nRead);
+        }
+        if( nRet == Z_STREAM_END )
+        {
+            // Another gzip member may follow, as in the output of bgzip or
+            // of the concatenation of .gz files. Ignore trailing garbage.
+            if( sStream.next_in[0] != gz_magic[0] )
+                break;
+            inflateReset(&sStream);
+        }
+        if( sStream.avail_out == 0 )
+        {
+            sStream.next_out = abyWindow.data();
+            sStream.avail_out = GZIP_WINDOW_SIZE;
+        }
+
+        nTotalIn += sStream.avail_in;
+        nTotalOut += sStream.avail_out;
+        nRet = inflate(&sStream, Z_BLOCK);
+        nTotalIn -= sStream.avail_in;
+        nTotalOut -= sStream.avail_out;
+        if( nRet != Z_OK && nRet != Z_STREAM_END )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "%s: inflate() failed with error %d",
+                     pszBaseFilename, nRet);
+            bOK = false;
+            break;
+        }
+
+        // Add an access point at the end of the header or at the end of a
+        // deflate block that is not the last one of the member.
+        if( (sStream.data_type & 128) != 0 &&
+            (sStream.data_type & 64) == 0 &&
+            (nTotalOut == 0 || nTotalOut - nLast > nSpan) )
+        {
+            VSIGZipAccessPoint oPoint;
+            oPoint.nCompressedOffset = nTotalIn;
+            oPoint.nUncompressedOffset = nTotalOut;
+            oPoint.nBits = sStream.data_type & 7;
+            if( nTotalOut > 0 )
+            {
+                // Reorder the circular window so that the most recent
+                // data is at the end.
+                const size_t nLeft = sStream.avail_out;
+                memcpy(abyDict.data(),
+                       abyWindow.data() + GZIP_WINDOW_SIZE - nLeft, nLeft);
+                memcpy(abyDict.data() + nLeft,
+                       abyWindow.data(), GZIP_WINDOW_SIZE - nLeft);
+                const size_t nDictSize = static_cast<size_t>(std::min(
+                    nTotalOut, static_cast<vsi_l_offset>(GZIP_WINDOW_SIZE)));
+                uLongf nCompressedDictSize =
+                    static_cast<uLongf>(abyCompressedDict.size());
+                if( compress2(abyCompressedDict.data(), &nCompressedDictSize,
+                              abyDict.data() + GZIP_WINDOW_SIZE - nDictSize,
+                              static_cast<uLong>(nDictSize),
+                              Z_BEST_SPEED) != Z_OK )
+                {
+                    bOK = false;
+                    break;
+                }
+                oPoint.osWindow.assign(
+                    reinterpret_cast<const char*>(abyCompressedDict.data()),
+                    nCompressedDictSize);
+            }
+            poIndex->aoPoints.emplace_back(std::move(oPoint));
+            nLast = nTotalOut;
+        }
+    }
+
+    inflateEnd(&sStream);
+    CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+
+    if( !bOK || poIndex->aoPoints.empty() )
+        return nullptr;
+
+    poIndex->nUncompressedSize = nTotalOut;
+    CPLDebug("GZIP", "Index of %s has %d access points",
+             pszBaseFilename, static_cast<int>(poIndex->aoPoints.size()));
+    return poIndex;
+}
+
+/************************************************************************/
+/*                                Save()                                */
+/************************************************************************/
+
+bool VSIGZipIndex::Save( const char* pszIndexFilename ) const
+{
+    VSILFILE* fp = VSIFOpenL(pszIndexFilename, "wb");
+    if( fp == nullptr )
+        return false;
+
+    const auto WriteUInt32 = [fp](GUInt32 nVal)
+    {
+        CPL_LSBPTR32(&nVal);
+        return VSIFWriteL(&nVal, sizeof(nVal), 1, fp) == 1;
+    };
+    const auto WriteUInt64 = [fp](GUIntBig nVal)
+    {
+        CPL_LSBPTR64(&nVal);
+        return VSIFWriteL(&nVal, sizeof(nVal), 1, fp) == 1;
+    };
+
+    bool bOK =
+        VSIFWriteL(GZIP_INDEX_SIGNATURE, strlen(GZIP_INDEX_SIGNATURE), 1,
+                   fp) == 1 &&
+        WriteUInt32(GZIP_INDEX_VERSION) &&
+        WriteUInt64(nCompressedSize) &&
+        WriteUInt64(static_cast<GUIntBig>(nMTime)) &&
+        WriteUInt64(nUncompressedSize) &&
+        WriteUInt32(static_cast<GUInt32>(aoPoints.size()));
+    for( const auto& oPoint: aoPoints )
+    {
+        if( !bOK )
+            break;
+        const GByte nBits = static_cast<GByte>(oPoint.nBits);
+        bOK = WriteUInt64(oPoint.nCompressedOffset) &&
+              WriteUInt64(oPoint.nUncompressedOffset) &&
+              VSIFWriteL(&nBits, 1, 1, fp) == 1 &&
+              WriteUInt32(static_cast<GUInt32>(oPoint.osWindow.size())) &&
+              (oPoint.osWindow.empty() ||
+               VSIFWriteL(oPoint.osWindow.data(), oPoint.osWindow.size(), 1,
+                          fp) == 1);
+    }
+    if( VSIFCloseL(fp) != 0 )
+        bOK = false;
+    if( !bOK )
+        VSIUnlink(pszIndexFilename);
+    return bOK;
+}
+
+/************************************************************************/
+/*                                Load()                                */
+/************************************************************************/
+
+std::shared_ptr<VSIGZipIndex> VSIGZipIndex::Load( const char* pszIndexFilename,
+                                                  const char* pszBaseFilename,
+                                                  const VSIStatBufL& sStat )
+{
+    VSILFILE* fp = VSIFOpenL(pszIndexFilename, "rb");
+    if( fp == nullptr )
+        return nullptr;
+
+    const auto ReadUInt32 = [fp](GUInt32& nVal)
+    {
+        if( VSIFReadL(&nVal, sizeof(nVal), 1, fp) != 1 )
+            return false;
+        CPL_LSBPTR32(&nVal);
+        return true;
+    };
+    const auto ReadUInt64 = [fp](GUIntBig& nVal)
+    {
+        if( VSIFReadL(&nVal, sizeof(nVal), 1, fp) != 1 )
+            return false;
+        CPL_LSBPTR64(&nVal);
+        return true;
+    };
+
+    auto poIndex = std::make_shared<VSIGZipIndex>();
+    poIndex->osBaseFilename = pszBaseFilename;
+
+    char szSignature[sizeof(GZIP_INDEX_SIGNATURE)] = {};
+    GUInt32 nVersion = 0;
+    GUIntBig nCompressedSize = 0;
+    GUIntBig nMTime = 0;
+    GUIntBig nUncompressedSize = 0;
+    GUInt32 nPoints = 0;
+    bool bOK =
+        VSIFReadL(szSignature, strlen(GZIP_INDEX_SIGNATURE), 1, fp) == 1 &&
+        strcmp(szSignature, GZIP_INDEX_SIGNATURE) == 0 &&
+        ReadUInt32(nVersion) && nVersion == GZIP_INDEX_VERSION &&
+        ReadUInt64(nCompressedSize) &&
+        ReadUInt64(nMTime) &&
+        ReadUInt64(nUncompressedSize) &&
+        ReadUInt32(nPoints) && nPoints > 0 &&
+        // Is the index still valid for the current content of the file ?
+        nCompressedSize == static_cast<GUIntBig>(sStat.st_size) &&
+        static_cast<GIntBig>(nMTime) == static_cast<GIntBig>(sStat.st_mtime);
+    if( bOK )
+    {
+        poIndex->nCompressedSize = nCompressedSize;
+        poIndex->nMTime = static_cast<GIntBig>(nMTime);
+        poIndex->nUncompressedSize = nUncompressedSize;
+        // Do not trust nPoints for the reservation
+        poIndex->aoPoints.reserve(std::min(nPoints, 100000U));
+    }
+    for( GUInt32 i = 0; bOK && i < nPoints; i++ )
+    {
+        VSIGZipAccessPoint oPoint;
+        GUIntBig nCompressedOffset = 0;
+        GUIntBig nUncompressedOffset = 0;
+        GByte nBits = 0;
+        GUInt32 nWindowSize = 0;
+        bOK = ReadUInt64(nCompressedOffset) &&
+              ReadUInt64(nUncompressedOffset) &&
+              VSIFReadL(&nBits, 1, 1, fp) == 1 && nBits < 8 &&
+              ReadUInt32(nWindowSize) &&
+              nWindowSize <= compressBound(GZIP_WINDOW_SIZE) &&
+              nCompressedOffset <= nCompressedSize &&
+              nUncompressedOffset <= nUncompressedSize &&
+              (poIndex->aoPoints.empty() ||
+               nUncompressedOffset >
+                    poIndex->aoPoints.back().nUncompressedOffset);
+        if( bOK && nWindowSize > 0 )
+        {
+            oPoint.osWindow.resize(nWindowSize);
+            bOK = VSIFReadL(&oPoint.osWindow[0], nWindowSize, 1, fp) == 1;
+        }
+        if( bOK )
+        {
+            oPoint.nCompressedOffset = nCompressedOffset;
+            oPoint.nUncompressedOffset = nUncompressedOffset;
+            oPoint.nBits = nBits;
+            poIndex->aoPoints.emplace_back(std::move(oPoint));
+        }
+    }
+    CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+
+    if( !bOK )
+    {
+        CPLDebug("GZIP", "Ignoring invalid or outdated index %s",
+                 pszIndexFilename);
+        return nullptr;
+    }
+    return poIndex;
+}
+
+/************************************************************************/
+/*                              FindSpan()                              */
+/************************************************************************/
+
+size_t VSIGZipIndex::FindSpan( vsi_l_offset nOffset ) const
+{
+    const auto oIter = std::upper_bound(
+        aoPoints.begin(), aoPoints.end(), nOffset,
+        [](vsi_l_offset nVal, const VSIGZipAccessPoint& oPoint)
+        { return nVal < oPoint.nUncompressedOffset; });
+    if( oIter == aoPoints.begin() )
+        return 0;
+    return static_cast<size_t>(oIter - aoPoints.begin()) - 1;
+}
+
+/************************************************************************/
+/*                             GetSpanEnd()                             */
+/************************************************************************/
+
+vsi_l_offset VSIGZipIndex::GetSpanEnd( size_t nSpan ) const
+{
+    return nSpan + 1 < aoPoints.size() ?
+        aoPoints[nSpan + 1].nUncompressedOffset : nUncompressedSize;
+}
+
+/************************************************************************/
+/*                            InflateSpan()                             */
+/************************************************************************/
+
+bool VSIGZipIndex::InflateSpan( VSILFILE* fp, size_t nSpan,
+                                std::string& osOut ) const
+{
+    const VSIGZipAccessPoint& oPoint = aoPoints[nSpan];
+    const vsi_l_offset nSpanSize =
+        GetSpanEnd(nSpan) - oPoint.nUncompressedOffset;
+    if( nSpanSize > UINT_MAX )
+        return false;
+    try
+    {
+        osOut.resize(static_cast<size_t>(nSpanSize));
+    }
+    catch( const std::bad_alloc& )
+    {
+        return false;
+    }
+    if( nSpanSize == 0 )
+        return true;
+
+    z_stream sStream;
+    memset(&sStream, 0, sizeof(sStream));
+    // Access points are always within a raw deflate stream
+    if( inflateInit2(&sStream, -MAX_WBITS) != Z_OK )
+        return false;
+
+    std::vector<GByte> abyIn(Z_BUFSIZE);
+    bool bOK = VSIFSeekL(fp, oPoint.nCompressedOffset -
+                                (oPoint.nBits ? 1 : 0), SEEK_SET) == 0;
+    if( bOK && oPoint.nBits )
+    {
+        GByte nByte = 0;
+        bOK = VSIFReadL(&nByte, 1, 1, fp) == 1 &&
+              inflatePrime(&sStream, oPoint.nBits,
+                           nByte >> (8 - oPoint.nBits)) == Z_OK;
+    }
+    if( bOK && !oPoint.osWindow.empty() )
+    {
+        std::vector<GByte> abyDict(GZIP_WINDOW_SIZE);
+        uLongf nDictSize = GZIP_WINDOW_SIZE;
+        bOK = uncompress(abyDict.data(), &nDictSize,
+                         reinterpret_cast<const Bytef*>(oPoint.osWindow.data()),
+                         static_cast<uLong>(oPoint.osWindow.size())) == Z_OK &&
+              inflateSetDictionary(&sStream, abyDict.data(),
+                                   static_cast<uInt>(nDictSize)) == Z_OK;
+    }
+
+    sStream.next_out = reinterpret_cast<Bytef*>(&osOut[0]);
+    sStream.avail_out = static_cast<uInt>(nSpanSize);
+    bool bRawDeflate = true;
+    size_t nToSkip = 0;
+    while( bOK && sStream.avail_out > 0 )
+    {
+        if( sStream.avail_in == 0 )
+        {
+            const size_t nRead =
+                VSIFReadL(abyIn.data(), 1, abyIn.size(), fp);
+            if( nRead == 0 )
+            {
+                bOK = false;
+                break;
+            }
+            sStream.next_in = abyIn.data();
+            sStream.avail_in = static_cast<uInt>(nRead);
+        }
+        if( nToSkip > 0 )
+        {
+            const size_t nSkipped = std::min(nToSkip,
+                static_cast<size_t>(sStream.avail_in));
+            sStream.next_in += nSkipped;
+            sStream.avail_in -= static_cast<uInt>(nSkipped);
+            nToSkip -= nSkipped;
+            continue;
+        }
+
+        const int nRet = inflate(&sStream, Z_NO_FLUSH);
+        if( nRet == Z_STREAM_END )
+        {
+            // The span goes across the end of a gzip member. In raw mode,
+            // skip the CRC32 and ISIZE trailer of the member we started in,
+            // and let zlib process the header (and trailer) of the next ones.
+            if( bRawDeflate )
+            {
+                nToSkip = 8;
+                bRawDeflate = false;
+                bOK = inflateReset2(&sStream, 15 + 16) == Z_OK;
+            }
+            else
+            {
+                bOK = inflateReset(&sStream) == Z_OK;
+            }
+        }
+        else if( nRet != Z_OK )
+        {
+            bOK = false;
+        }
+    }
+    inflateEnd(&sStream);
+    return bOK;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       VSIGZipReadHandleMT                            */
+/* ==================================================================== */
+/************************************************************************/
+
+// Read-side counterpart of VSIGZipWriteHandleMT: given an index of access
+// points, the spans following the current position are decompressed in
+// parallel by a pool of worker threads.
+
+class VSIGZipReadHandleMT final : public VSIVirtualHandle
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIGZipReadHandleMT)
+
+    std::shared_ptr<VSIGZipIndex> poIndex_{};
+    int                nThreads_ = 0;
+    std::unique_ptr<CPLWorkerThreadPool> poPool_{};
+    vsi_l_offset       nCurOffset_ = 0;
+    bool               bEOF_ = false;
+    bool               bHasErrored_ = false;
+    size_t             nLastScheduledSpan_ = std::numeric_limits<size_t>::max();
+
+    struct Job
+    {
+        VSIGZipReadHandleMT *pParent_ = nullptr;
+        size_t             nSpan_ = 0;
+        bool               bFinished_ = false;
+        bool               bOK_ = false;
+        std::string        sUncompressedData_{};
+    };
+    std::mutex         sMutex_{};
+    std::condition_variable sCond_{};
+    std::map<size_t, std::shared_ptr<Job>> oMapJobs_{};
+
+    static void InflateJob(void* inData);
+    bool ScheduleJobs(size_t nSpan);
+
+  public:
+    VSIGZipReadHandleMT( const std::shared_ptr<VSIGZipIndex>& poIndex,
+                         int nThreads );
+    ~VSIGZipReadHandleMT() override;
+
+    int Seek( vsi_l_offset nOffset, int nWhence ) override;
+    vsi_l_offset Tell() override;
+    size_t Read( void *pBuffer, size_t nSize, size_t nMemb ) override;
+    size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
+    int Eof() override;
+    int Flush() override;
+    int Close() override;
+};
+
+/************************************************************************/
+/*                        VSIGZipReadHandleMT()                         */
+/************************************************************************/
+
+VSIGZipReadHandleMT::VSIGZipReadHandleMT(
+                        const std::shared_ptr<VSIGZipIndex>& poIndex,
+                        int nThreads ):
+    poIndex_(poIndex),
+    nThreads_(nThreads)
+{
+}
+
+/************************************************************************/
+/*                       ~VSIGZipReadHandleMT()                         */
+/************************************************************************/
+
+VSIGZipReadHandleMT::~VSIGZipReadHandleMT()
+
+{
+    VSIGZipReadHandleMT::Close();
+}
+
+/************************************************************************/
+/*                               Close()                                */
+/************************************************************************/
+
+int VSIGZipReadHandleMT::Close()
+{
+    // Wait for pending jobs, as they reference our mutex
+    poPool_.reset();
+    oMapJobs_.clear();
+    return 0;
+}
+
+/************************************************************************/
+/*                             InflateJob()                             */
+/************************************************************************/
+
+void VSIGZipReadHandleMT::InflateJob(void* inData)
+{
+    std::shared_ptr<Job>* ppoJob = static_cast<std::shared_ptr<Job>*>(inData);
+    Job* psJob = ppoJob->get();
+    const VSIGZipIndex* poIndex = psJob->pParent_->poIndex_.get();
+
+    bool bOK = false;
+    VSILFILE* fp = VSIFOpenL(poIndex->osBaseFilename, "rb");
+    if( fp )
+    {
+        bOK = poIndex->InflateSpan(fp, psJob->nSpan_,
+                                   psJob->sUncompressedData_);
+        CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(psJob->pParent_->sMutex_);
+        psJob->bOK_ = bOK;
+        psJob->bFinished_ = true;
+        psJob->pParent_->sCond_.notify_all();
+    }
+    delete ppoJob;
+}
+
+/************************************************************************/
+/*                            ScheduleJobs()                            */
+/************************************************************************/
+
+bool VSIGZipReadHandleMT::ScheduleJobs(size_t nSpan)
+{
+    if( nSpan == nLastScheduledSpan_ )
+        return true;
+    nLastScheduledSpan_ = nSpan;
+
+    if( poPool_ == nullptr )
+    {
+        poPool_.reset(new CPLWorkerThreadPool());
+        if( !poPool_->Setup(nThreads_, nullptr, nullptr, false) )
+        {
+            poPool_.reset();
+            return false;
+        }
+    }
+
+    // Keep the previous span (for small backward seeks), the current one,
+    // and nThreads_ spans of read-ahead.
+    const size_t nFirstSpan = nSpan > 0 ? nSpan - 1 : 0;
+    const size_t nLastSpan = std::min(poIndex_->aoPoints.size() - 1,
+                                      nSpan + static_cast<size_t>(nThreads_));
+
+    std::lock_guard<std::mutex> oLock(sMutex_);
+    for( auto oIter = oMapJobs_.begin(); oIter != oMapJobs_.end(); )
+    {
+        // Jobs still in progress keep a reference on themselves.
+        if( oIter->first < nFirstSpan || oIter->first > nLastSpan )
+            oIter = oMapJobs_.erase(oIter);
+        else
+            ++oIter;
+    }
+    for( size_t i = nSpan; i <= nLastSpan; i++ )
+    {
+        if( oMapJobs_.find(i) != oMapJobs_.end() )
+            continue;
+        auto poJob = std::make_shared<Job>();
+        poJob->pParent_ = this;
+        poJob->nSpan_ = i;
+        oMapJobs_[i] = poJob;
+        poPool_->SubmitJob(VSIGZipReadHandleMT::InflateJob,
+                           new std::shared_ptr<Job>(poJob));
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+size_t VSIGZipReadHandleMT::Read( void *pBuffer, size_t nSize, size_t nMemb )
+{
+    if( bHasErrored_ || nSize == 0 || nMemb == 0 )
+        return 0;
+
+    const size_t nToRead = nSize * nMemb;
+    size_t nRead = 0;
+    GByte* pabyDst = static_cast<GByte*>(pBuffer);
+    while( nRead < nToRead )
+    {
+        if( nCurOffset_ >= poIndex_->nUncompressedSize )
+        {
+            bEOF_ = true;
+            break;
+        }
+
+        const size_t nSpan = poIndex_->FindSpan(nCurOffset_);
+        if( !ScheduleJobs(nSpan) )
+        {
+            bHasErrored_ = true;
+            break;
+        }
+
+        std::shared_ptr<Job> poJob;
+        {
+            std::unique_lock<std::mutex> oLock(sMutex_);
+            poJob = oMapJobs_[nSpan];
+            sCond_.wait(oLock, [&poJob] { return poJob->bFinished_; });
+        }
+        if( !poJob->bOK_ )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Decompression of %s failed at offset " CPL_FRMT_GUIB,
+                     poIndex_->osBaseFilename.c_str(),
+                     static_cast<GUIntBig>(
+                         poIndex_->aoPoints[nSpan].nUncompressedOffset));
+            bHasErrored_ = true;
+            break;
+        }
+
+        const size_t nOffsetInSpan = static_cast<size_t>(
+            nCurOffset_ - poIndex_->aoPoints[nSpan].nUncompressedOffset);
+        const size_t nToCopy = std::min(
+            nToRead - nRead,
+            poJob->sUncompressedData_.size() - nOffsetInSpan);
+        memcpy(pabyDst + nRead,
+               poJob->sUncompressedData_.data() + nOffsetInSpan, nToCopy);
+        nRead += nToCopy;
+        nCurOffset_ += nToCopy;
+    }
+
+    return nRead / nSize;
+}
+
+/************************************************************************/
+/*                               Write()                                */
+/************************************************************************/
+
+size_t VSIGZipReadHandleMT::Write( const void * /* pBuffer */,
+                                   size_t /* nSize */,
+                                   size_t /* nMemb */ )
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "VSIFWriteL is not supported on GZip streams");
+    return 0;
+}
+
+/************************************************************************/
+/*                                Eof()                                 */
+/************************************************************************/
+
+int VSIGZipReadHandleMT::Eof()
+{
+    return bEOF_;
+}
+
+/************************************************************************/
+/*                               Flush()                                */
+/************************************************************************/
+
+int VSIGZipReadHandleMT::Flush()
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                                Seek()                                */
+/************************************************************************/
+
+int VSIGZipReadHandleMT::Seek( vsi_l_offset nOffset, int nWhence )
+{
+    if( nWhence == SEEK_SET )
+        nCurOffset_ = nOffset;
+    else if( nWhence == SEEK_CUR )
+        nCurOffset_ += nOffset;
+    else
+        nCurOffset_ = poIndex_->nUncompressedSize + nOffset;
+    bEOF_ = false;
+    return 0;
+}
+
+/************************************************************************/
+/*                                Tell()                                */
+/************************************************************************/
+
+vsi_l_offset VSIGZipReadHandleMT::Tell()
+{
+    return nCurOffset_;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                       VSIGZipWriteHandleMT                           */
@@ -1198,7 +1943,10 @@ class VSIGZipWriteHandleMT final : public VSIVirtualHandle
     int                nDeflateType_ = CPL_DEFLATE_TYPE_GZIP;
     bool               bAutoCloseBaseHandle_ = false;
     int                nThreads_ = 0;
-    std::unique_ptr<CPLWorkerThreadPool> poPool_{};
+    std::unique_ptr<CPLWorkerThreadPool> poOwnedPool_{};
+    CPLWorkerThreadPool* poPool_ = nullptr;
+    bool               bComputeCRC_ = false;
+    GUInt32*           pnCRCOut_ = nullptr;
     std::list<std::string*> aposBuffers_{};
     std::string*       pCurBuffer_ = nullptr;
     std::mutex         sMutex_{};
@@ -1235,7 +1983,9 @@ class VSIGZipWriteHandleMT final : public VSIVirtualHandle
     VSIGZipWriteHandleMT( VSIVirtualHandle* poBaseHandle,
                         int nThreads,
                         int nDeflateType,
-                        bool bAutoCloseBaseHandleIn );
+                        bool bAutoCloseBaseHandleIn,
+                        CPLWorkerThreadPool* poPool = nullptr,
+                        GUInt32* pnCRCOut = nullptr );
 
     ~VSIGZipWriteHandleMT() override;
 
@@ -1255,11 +2005,16 @@ class VSIGZipWriteHandleMT final : public VSIVirtualHandle
 VSIGZipWriteHandleMT::VSIGZipWriteHandleMT(  VSIVirtualHandle* poBaseHandle,
                         int nThreads,
                         int nDeflateType,
-                        bool bAutoCloseBaseHandleIn ):
+                        bool bAutoCloseBaseHandleIn,
+                        CPLWorkerThreadPool* poPool,
+                        GUInt32* pnCRCOut ):
     poBaseHandle_(poBaseHandle),
     nDeflateType_(nDeflateType),
     bAutoCloseBaseHandle_(bAutoCloseBaseHandleIn),
-    nThreads_(nThreads)
+    nThreads_(nThreads),
+    poPool_(poPool),
+    bComputeCRC_(nDeflateType == CPL_DEFLATE_TYPE_GZIP || pnCRCOut != nullptr),
+    pnCRCOut_(pnCRCOut)
 {
     const char* pszChunkSize = CPLGetConfigOption
         ("CPL_VSIL_DEFLATE_CHUNK_SIZE", "1024K");
@@ -1353,7 +2108,7 @@ int VSIGZipWriteHandleMT::Close()
     else
     {
         CPLAssert(apoFinishedJobs_.empty());
-        if( nDeflateType_ == CPL_DEFLATE_TYPE_GZIP )
+        if( bComputeCRC_ )
         {
             if( poPool_ )
             {
@@ -1362,6 +2117,8 @@ int VSIGZipWriteHandleMT::Close()
             ProcessCompletedJobs();
         }
         CPLAssert(apoCRCFinishedJobs_.empty());
+        if( pnCRCOut_ )
+            *pnCRCOut_ = static_cast<GUInt32>(nCRC_);
     }
 
     if( nDeflateType_ == CPL_DEFLATE_TYPE_GZIP )
@@ -1538,7 +2295,7 @@ bool VSIGZipWriteHandleMT::ProcessCompletedJobs()
     while( do_it_again )
     {
         do_it_again = false;
-        if( nDeflateType_ == CPL_DEFLATE_TYPE_GZIP )
+        if( bComputeCRC_ )
         {
             for( auto iter = apoFinishedJobs_.begin();
                     iter != apoFinishedJobs_.end(); ++iter )
@@ -1580,7 +2337,7 @@ bool VSIGZipWriteHandleMT::ProcessCompletedJobs()
                 sMutex_.lock();
                 nSeqNumberExpected_ ++;
 
-                if( nDeflateType_ != CPL_DEFLATE_TYPE_GZIP )
+                if( !bComputeCRC_ )
                 {
                     aposBuffers_.push_back(psJob->pBuffer_);
                     psJob->pBuffer_ = nullptr;
@@ -1598,7 +2355,7 @@ bool VSIGZipWriteHandleMT::ProcessCompletedJobs()
             }
         }
 
-        if( nDeflateType_ == CPL_DEFLATE_TYPE_GZIP )
+        if( bComputeCRC_ )
         {
             for( auto iter = apoCRCFinishedJobs_.begin();
                     iter != apoCRCFinishedJobs_.end(); ++iter )
@@ -1696,13 +2453,14 @@ size_t VSIGZipWriteHandleMT::Write( const void * const pBuffer,
         {
             if( poPool_ == nullptr )
             {
-                poPool_.reset(new CPLWorkerThreadPool());
-                if( !poPool_->Setup(nThreads_, nullptr, nullptr, false) )
+                poOwnedPool_.reset(new CPLWorkerThreadPool());
+                if( !poOwnedPool_->Setup(nThreads_, nullptr, nullptr, false) )
                 {
                     bHasErrored_ = true;
-                    poPool_.reset();
+                    poOwnedPool_.reset();
                     return 0;
                 }
+                poPool_ = poOwnedPool_.get();
             }
 
             auto psJob = GetJobObject();
@@ -1855,6 +2613,23 @@ VSIGZipWriteHandle::VSIGZipWriteHandle( VSIVirtualHandle *poBaseHandle,
     }
 }
 
+/************************************************************************/
+/*                        VSIGZipGetNumThreads()                        */
+/************************************************************************/
+
+static int VSIGZipGetNumThreads()
+{
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszThreads == nullptr )
+        return 1;
+    int nThreads = 0;
+    if( EQUAL(pszThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszThreads);
+    return std::max(1, std::min(128, nThreads));
+}
+
 /************************************************************************/
 /*                       VSICreateGZipWritable()                        */
 /************************************************************************/
@@ -1863,29 +2638,43 @@ VSIVirtualHandle* VSICreateGZipWritable( VSIVirtualHandle* poBaseHandle,
                                          int nDeflateTypeIn,
                                          int bAutoCloseBaseHandle )
 {
-    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
-    if( pszThreads )
+    const int nThreads = VSIGZipGetNumThreads();
+    if( nThreads > 1 )
     {
-        int nThreads = 0;
-        if( EQUAL(pszThreads, "ALL_CPUS") )
-            nThreads = CPLGetNumCPUs();
-        else
-            nThreads = atoi(pszThreads);
-        nThreads = std::max(1, std::min(128, nThreads));
-        if( nThreads > 1 )
-        {
-            // coverity[tainted_data]
-            return new VSIGZipWriteHandleMT( poBaseHandle,
-                                                nThreads,
-                                                nDeflateTypeIn,
-                                                CPL_TO_BOOL(bAutoCloseBaseHandle) );
-        }
+        // coverity[tainted_data]
+        return new VSIGZipWriteHandleMT( poBaseHandle,
+                                            nThreads,
+                                            nDeflateTypeIn,
+                                            CPL_TO_BOOL(bAutoCloseBaseHandle) );
     }
     return new VSIGZipWriteHandle( poBaseHandle,
                                    nDeflateTypeIn,
                                    CPL_TO_BOOL(bAutoCloseBaseHandle) );
 }
 
+/************************************************************************/
+/*                      VSICreateGZipWritableMT()                       */
+/************************************************************************/
+
+// Variant used by the ZIP writer: the worker threads of poPool (if not null)
+// are reused from one member to the next, and the CRC32 of the uncompressed
+// data is computed by the workers and stored in *pnCRC32 on Close().
+
+VSIVirtualHandle* VSICreateGZipWritableMT( VSIVirtualHandle* poBaseHandle,
+                                           int nDeflateTypeIn,
+                                           bool bAutoCloseBaseHandle,
+                                           int nThreads,
+                                           CPLWorkerThreadPool* poPool,
+                                           GUInt32* pnCRC32 )
+{
+    return new VSIGZipWriteHandleMT( poBaseHandle,
+                                     nThreads,
+                                     nDeflateTypeIn,
+                                     bAutoCloseBaseHandle,
+                                     poPool,
+                                     pnCRC32 );
+}
+
 /************************************************************************/
 /*                        ~VSIGZipWriteHandle()                         */
 /************************************************************************/
@@ -2183,8 +2972,17 @@ VSIVirtualHandle* VSIGZipFilesystemHandler::Open( const char *pszFilename,
 
 /* -------------------------------------------------------------------- */
 /*      Otherwise we are in the read access case.                       */
+/*      If there is an index of access points, decompress in parallel.  */
 /* -------------------------------------------------------------------- */
 
+    const int nThreads = VSIGZipGetNumThreads();
+    if( nThreads > 1 )
+    {
+        auto poIndex = GetIndex(pszFilename + strlen("/vsigzip/"));
+        if( poIndex )
+            return new VSIGZipReadHandleMT(poIndex, nThreads);
+    }
+
     VSIGZipHandle* poGZIPHandle = OpenGZipReadOnly(pszFilename, pszAccess);
     if( poGZIPHandle )
         // Wrap the VSIGZipHandle inside a buffered reader that will
@@ -2195,6 +2993,83 @@ VSIVirtualHandle* VSIGZipFilesystemHandler::Open( const char *pszFilename,
     return nullptr;
 }
 
+/************************************************************************/
+/*                              GetIndex()                              */
+/************************************************************************/
+
+std::shared_ptr<VSIGZipIndex>
+VSIGZipFilesystemHandler::GetIndex( const char* pszBaseFilename )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(pszBaseFilename, &sStat) != 0 )
+        return nullptr;
+
+    {
+        CPLMutexHolder oHolder(&hMutex);
+        if( m_poLastIndex != nullptr &&
+            m_poLastIndex->osBaseFilename == pszBaseFilename &&
+            m_poLastIndex->nCompressedSize ==
+                static_cast<vsi_l_offset>(sStat.st_size) &&
+            m_poLastIndex->nMTime == static_cast<GIntBig>(sStat.st_mtime) )
+        {
+            return m_poLastIndex;
+        }
+    }
+
+    // The index is stored as a side-car file when the location is writable,
+    // and in /vsimem/ otherwise (for the lifetime of the process).
+    const CPLString osSideCarFilename(CPLString(pszBaseFilename) + ".gzidx");
+    const CPLString osMemFilename(
+        CPLSPrintf("/vsimem/gzip_index/%s.gzidx",
+                   CPLMD5String(pszBaseFilename)));
+
+    auto poIndex = VSIGZipIndex::Load(osSideCarFilename, pszBaseFilename,
+                                      sStat);
+    if( poIndex == nullptr )
+        poIndex = VSIGZipIndex::Load(osMemFilename, pszBaseFilename, sStat);
+    if( poIndex == nullptr &&
+        CPLTestBool(CPLGetConfigOption("CPL_VSIL_GZIP_CREATE_INDEX", "NO")) )
+    {
+        const char* pszSpan =
+            CPLGetConfigOption("CPL_VSIL_GZIP_INDEX_SPAN", "8M");
+        vsi_l_offset nSpan = static_cast<vsi_l_offset>(
+            CPLScanUIntBig(pszSpan, static_cast<int>(strlen(pszSpan))));
+        if( strchr(pszSpan, 'K') )
+            nSpan *= 1024;
+        else if( strchr(pszSpan, 'M') )
+            nSpan *= 1024 * 1024;
+        nSpan = std::max(static_cast<vsi_l_offset>(1024 * 1024),
+                         std::min(static_cast<vsi_l_offset>(1024 * 1024 * 1024),
+                                  nSpan));
+
+        poIndex = VSIGZipIndex::Build(pszBaseFilename, nSpan);
+        if( poIndex )
+        {
+            const bool bCanWriteSideCar =
+                (!STARTS_WITH_CI(pszBaseFilename, "/vsi") ||
+                 STARTS_WITH_CI(pszBaseFilename, "/vsimem/")) &&
+                CPLTestBool(CPLGetConfigOption(
+                    "CPL_VSIL_GZIP_WRITE_PROPERTIES", "YES"));
+            bool bSaved = false;
+            if( bCanWriteSideCar )
+            {
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                bSaved = poIndex->Save(osSideCarFilename);
+                CPLPopErrorHandler();
+            }
+            if( !bSaved )
+                poIndex->Save(osMemFilename);
+        }
+    }
+
+    if( poIndex )
+    {
+        CPLMutexHolder oHolder(&hMutex);
+        m_poLastIndex = poIndex;
+    }
+    return poIndex;
+}
+
 /************************************************************************/
 /*                          OpenGZipReadOnly()                          */
 /************************************************************************/
@@ -2284,6 +3159,14 @@ int VSIGZipFilesystemHandler::Stat( const char *pszFilename,
         }
     }
 
+    if( m_poLastIndex != nullptr &&
+        m_poLastIndex->osBaseFilename == pszFilename + strlen("/vsigzip/") )
+    {
+        pStatBuf->st_mode = S_IFREG;
+        pStatBuf->st_size = m_poLastIndex->nUncompressedSize;
+        return 0;
+    }
+
     // Begin by doing a stat on the real file.
     int ret = VSIStatExL(pszFilename+strlen("/vsigzip/"), pStatBuf, nFlags);
 
@@ -2420,10 +3303,19 @@ const char* VSIGZipFilesystemHandler::GetOptions()
     return
     "<Options>"
     "  <Option name='GDAL_NUM_THREADS' type='string' "
-        "description='Number of threads for compression. Either a integer or ALL_CPUS'/>"
+        "description='Number of threads for compression, or decompression "
+        "when an index is available. Either a integer or ALL_CPUS'/>"
     "  <Option name='CPL_VSIL_DEFLATE_CHUNK_SIZE' type='string' "
         "description='Chunk of uncompressed data for parallelization. "
         "Use K(ilobytes) or M(egabytes) suffix' default='1M'/>"
+    "  <Option name='CPL_VSIL_GZIP_CREATE_INDEX' type='boolean' "
+        "description='Whether to build an index of access points when "
+        "opening a file in read mode with GDAL_NUM_THREADS > 1. "
+        "It is saved as a .gzidx side-car file, or in /vsimem/ when this "
+        "is not possible' default='NO'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX_SPAN' type='string' "
+        "description='Spacing of access points in uncompressed data. "
+        "Use K(ilobytes) or M(egabytes) suffix' default='8M'/>"
     "</Options>";
 }
 
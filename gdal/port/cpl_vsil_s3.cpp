@@ -39,6 +39,7 @@
 #include <errno.h>
 
 #include <algorithm>
+#include <deque>
 #include <functional>
 #include <set>
 #include <map>
@@ -67,6 +68,53 @@ constexpr int knMAX_PART_NUMBER = 10000; // Limitation from S3
 
 namespace cpl {
 
+struct VSIDIRS3;
+
+/************************************************************************/
+/*                       VSIDIRS3ParallelListing                        */
+/************************************************************************/
+
+// Recursive listing where each directory is listed with a "/" delimiter by
+// its own requests, issued from a pool of threads. Directories are listed
+// depth first, and entries are queued as pages arrive, up to a limit beyond
+// which the listing threads wait for NextDirEntry() to consume them.
+struct VSIDIRS3ParallelListing
+{
+    struct Task
+    {
+        CPLString osSubDir{}; // relative to the listed directory
+        int       nDepth = 0;
+        CPLString osMarker{};
+    };
+
+    IVSIS3LikeFSHandler* poS3FS = nullptr;
+    CPLString osBucket{};
+    CPLString osObjectKey{};
+    int nRecurseDepth = 0;
+    bool bCacheEntries = true;
+    int nThreads = 0;
+
+    std::unique_ptr<CPLWorkerThreadPool> poPool{};
+    std::mutex oMutex{};
+    std::condition_variable oCV{};
+    std::vector<Task> aoTasks{}; // used as a stack
+    std::deque<std::unique_ptr<VSIDIREntry>> aoEntries{};
+    std::unique_ptr<VSIDIREntry> poCurEntry{};
+    int nRunningWorkers = 0;
+    bool bError = false;
+    bool bStop = false;
+
+    VSIDIRS3ParallelListing() = default;
+    ~VSIDIRS3ParallelListing();
+
+    VSIDIRS3ParallelListing(const VSIDIRS3ParallelListing&) = delete;
+    VSIDIRS3ParallelListing& operator=(const VSIDIRS3ParallelListing&) = delete;
+
+    bool AddPage( const Task& oTask, VSIDIRS3& oDir );
+    const VSIDIREntry* NextDirEntry();
+    static void ListJob( void* pData );
+};
+
 /************************************************************************/
 /*                             VSIDIRS3                                 */
 /************************************************************************/
@@ -86,6 +134,7 @@ struct VSIDIRS3: public VSIDIR
     IVSIS3LikeHandleHelper* poS3HandleHelper = nullptr;
     int nMaxFiles = 0;
     bool bCacheEntries = true;
+    std::unique_ptr<VSIDIRS3ParallelListing> poParallelListing{};
 
     explicit VSIDIRS3(IVSIS3LikeFSHandler *poFSIn): poFS(poFSIn), poS3FS(poFSIn) {}
     explicit VSIDIRS3(VSICurlFilesystemHandler *poFSIn): poFS(poFSIn) {}
@@ -482,6 +531,9 @@ bool VSIDIRS3::IssueListDir()
 
 const VSIDIREntry* VSIDIRS3::NextDirEntry()
 {
+    if( poParallelListing )
+        return poParallelListing->NextDirEntry();
+
     while( true )
     {
         if( nPos < static_cast<int>(aoEntries.size()) )
@@ -501,6 +553,183 @@ const VSIDIREntry* VSIDIRS3::NextDirEntry()
     }
 }
 
+/************************************************************************/
+/*                     ~VSIDIRS3ParallelListing()                       */
+/************************************************************************/
+
+VSIDIRS3ParallelListing::~VSIDIRS3ParallelListing()
+{
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bStop = true;
+    }
+    oCV.notify_all();
+    if( poPool )
+        poPool->WaitCompletion();
+}
+
+/************************************************************************/
+/*                              AddPage()                               */
+/************************************************************************/
+
+// Queues the entries listed by oDir for oTask, and schedules the listing
+// of its subdirectories and of its next page.
+bool VSIDIRS3ParallelListing::AddPage( const Task& oTask, VSIDIRS3& oDir )
+{
+    constexpr size_t knMAX_QUEUED_ENTRIES = 10 * 1000;
+
+    std::vector<Task> aoNewTasks;
+    int nNewWorkers = 0;
+    {
+        std::unique_lock<std::mutex> oLock(oMutex);
+        while( aoEntries.size() >= knMAX_QUEUED_ENTRIES && !bStop )
+            oCV.wait(oLock);
+        if( bStop )
+            return false;
+
+        for( auto& entry: oDir.aoEntries )
+        {
+            CPLString osName(entry->pszName);
+            if( !oTask.osSubDir.empty() )
+            {
+                osName = oTask.osSubDir + "/" + osName;
+                CPLFree(entry->pszName);
+                entry->pszName = CPLStrdup(osName);
+            }
+            if( entry->nMode == S_IFDIR &&
+                (nRecurseDepth < 0 || oTask.nDepth < nRecurseDepth) )
+            {
+                // A trailing slash disambiguates a directory from a file
+                // of the same name.
+                if( osName.back() == '/' )
+                    osName.resize(osName.size() - 1);
+                Task oSubTask;
+                oSubTask.osSubDir = osName;
+                oSubTask.nDepth = oTask.nDepth + 1;
+                aoNewTasks.emplace_back(std::move(oSubTask));
+            }
+            aoEntries.emplace_back(std::move(entry));
+        }
+        oDir.aoEntries.clear();
+
+        // Push in reverse order so that subdirectories are listed in
+        // lexicographic order, and the next page of this directory first.
+        aoTasks.insert(aoTasks.end(), aoNewTasks.rbegin(), aoNewTasks.rend());
+        if( !oDir.osNextMarker.empty() )
+        {
+            Task oNextPage(oTask);
+            oNextPage.osMarker = oDir.osNextMarker;
+            aoTasks.emplace_back(std::move(oNextPage));
+        }
+
+        while( nRunningWorkers + nNewWorkers < nThreads &&
+               static_cast<size_t>(nRunningWorkers + nNewWorkers) <
+                                                        aoTasks.size() )
+        {
+            nNewWorkers ++;
+        }
+        nRunningWorkers += nNewWorkers;
+    }
+    oCV.notify_all();
+
+    if( nNewWorkers > 0 && !poPool )
+    {
+        auto poNewPool = std::unique_ptr<CPLWorkerThreadPool>(
+                                                new CPLWorkerThreadPool());
+        if( poNewPool->Setup(nThreads, nullptr, nullptr, false) )
+            poPool = std::move(poNewPool);
+    }
+    for( int i = 0; i < nNewWorkers; i++ )
+    {
+        if( !poPool || !poPool->SubmitJob(ListJob, this) )
+        {
+            {
+                std::lock_guard<std::mutex> oLock(oMutex);
+                nRunningWorkers -= nNewWorkers - i;
+                bError = true;
+            }
+            oCV.notify_all();
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                              ListJob()                               */
+/************************************************************************/
+
+// Lists pending directories until there are no more of them.
+void VSIDIRS3ParallelListing::ListJob( void* pData )
+{
+    VSIDIRS3ParallelListing* poThis =
+        static_cast<VSIDIRS3ParallelListing*>(pData);
+
+    NetworkStatisticsFileSystem oContextFS(poThis->poS3FS->GetFSPrefix());
+    NetworkStatisticsAction oContextAction("OpenDir");
+
+    VSIDIRS3 oDir(poThis->poS3FS);
+    oDir.poS3HandleHelper =
+        poThis->poS3FS->CreateHandleHelper(poThis->osBucket, true);
+    oDir.osBucket = poThis->osBucket;
+    oDir.bCacheEntries = poThis->bCacheEntries;
+    bool bOK = oDir.poS3HandleHelper != nullptr;
+    if( bOK )
+        poThis->poS3FS->UpdateHandleFromMap(oDir.poS3HandleHelper);
+
+    while( bOK )
+    {
+        Task oTask;
+        {
+            std::lock_guard<std::mutex> oLock(poThis->oMutex);
+            if( poThis->bStop || poThis->bError || poThis->aoTasks.empty() )
+                break;
+            oTask = std::move(poThis->aoTasks.back());
+            poThis->aoTasks.pop_back();
+        }
+
+        oDir.osObjectKey = poThis->osObjectKey;
+        if( !oTask.osSubDir.empty() )
+        {
+            if( !oDir.osObjectKey.empty() )
+                oDir.osObjectKey += '/';
+            oDir.osObjectKey += oTask.osSubDir;
+        }
+        oDir.osNextMarker = oTask.osMarker;
+        bOK = oDir.IssueListDir() && poThis->AddPage(oTask, oDir);
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(poThis->oMutex);
+        if( !bOK )
+            poThis->bError = true;
+        poThis->nRunningWorkers --;
+    }
+    poThis->oCV.notify_all();
+}
+
+/************************************************************************/
+/*                           NextDirEntry()                             */
+/************************************************************************/
+
+const VSIDIREntry* VSIDIRS3ParallelListing::NextDirEntry()
+{
+    {
+        std::unique_lock<std::mutex> oLock(oMutex);
+        while( aoEntries.empty() && !bError &&
+               !(aoTasks.empty() && nRunningWorkers == 0) )
+        {
+            oCV.wait(oLock);
+        }
+        if( aoEntries.empty() )
+            return nullptr;
+        poCurEntry = std::move(aoEntries.front());
+        aoEntries.pop_front();
+    }
+    oCV.notify_all();
+    return poCurEntry.get();
+}
+
 /************************************************************************/
 /*                          AnalyseS3FileList()                         */
 /************************************************************************/
@@ -578,6 +807,7 @@ class VSIS3FSHandler final : public IVSIS3LikeFSHandler
                             CSLConstList papszOptions ) override;
 
     bool SupportsParallelMultipartUpload() const override { return true; }
+    bool SupportsUploadPartCopy() const override { return true; }
 };
 
 /************************************************************************/
@@ -659,6 +889,21 @@ VSIS3WriteHandle::VSIS3WriteHandle( IVSIS3LikeFSHandler* poFS,
                     "Cannot allocate working buffer for %s",
                      m_poFS->GetFSPrefix().c_str());
         }
+        m_nAllocatedBuffers = 1;
+
+        // Number of parts that may be uploaded concurrently. Each in-flight
+        // part owns one buffer of m_nBufferSize bytes, so the memory used is
+        // bounded by (m_nUploadThreads + 1) * m_nBufferSize.
+        if( m_poFS->SupportsParallelMultipartUpload() )
+        {
+            const char* pszThreads =
+                CPLGetConfigOption("VSIS3_UPLOAD_NUM_THREADS", "1");
+            if( EQUAL(pszThreads, "ALL_CPUS") )
+                m_nUploadThreads = CPLGetNumCPUs();
+            else
+                m_nUploadThreads = atoi(pszThreads);
+            m_nUploadThreads = std::max(1, std::min(128, m_nUploadThreads));
+        }
     }
 }
 
@@ -669,8 +914,11 @@ VSIS3WriteHandle::VSIS3WriteHandle( IVSIS3LikeFSHandler* poFS,
 VSIS3WriteHandle::~VSIS3WriteHandle()
 {
     VSIS3WriteHandle::Close();
+    m_poUploadPool.reset();
     delete m_poS3HandleHelper;
     CPLFree(m_pabyBuffer);
+    for( GByte* pabyBuffer: m_apabyFreeBuffers )
+        CPLFree(pabyBuffer);
     if( m_hCurlMulti )
     {
         if( m_hCurl )
@@ -856,6 +1104,9 @@ bool VSIS3WriteHandle::UploadPart()
             m_osFilename.c_str());
         return false;
     }
+    if( m_nUploadThreads > 1 )
+        return SubmitUploadPart();
+
     const CPLString osEtag =
         m_poFS->UploadPart(m_osFilename, m_nPartNumber, m_osUploadID,
                            static_cast<vsi_l_offset>(m_nBufferSize) * (m_nPartNumber-1),
@@ -870,6 +1121,146 @@ bool VSIS3WriteHandle::UploadPart()
     return !osEtag.empty();
 }
 
+/************************************************************************/
+/*                          UploadPartJob()                             */
+/************************************************************************/
+
+void VSIS3WriteHandle::UploadPartJob( void* pData )
+{
+    UploadJob* psJob = static_cast<UploadJob*>(pData);
+    VSIS3WriteHandle* poThis = psJob->poParent;
+
+    bool bSkip;
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oUploadMutex);
+        bSkip = poThis->m_bUploadError;
+    }
+
+    CPLString osEtag;
+    if( !bSkip )
+    {
+        // UploadPart() modifies the query parameters of the helper, so
+        // each job needs its own one.
+        IVSIS3LikeHandleHelper* poS3HandleHelper =
+            poThis->m_poFS->CreateHandleHelper(
+                poThis->m_osFilename.c_str() +
+                    poThis->m_poFS->GetFSPrefix().size(), false);
+        if( poS3HandleHelper )
+        {
+            poThis->m_poFS->UpdateHandleFromMap(poS3HandleHelper);
+            osEtag = poThis->m_poFS->UploadPart(
+                poThis->m_osFilename, psJob->nPartNumber, poThis->m_osUploadID,
+                static_cast<vsi_l_offset>(poThis->m_nBufferSize) *
+                    (psJob->nPartNumber - 1),
+                psJob->pabyBuffer, psJob->nSize,
+                poS3HandleHelper,
+                poThis->m_nMaxRetry, poThis->m_dfRetryDelay);
+            delete poS3HandleHelper;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oUploadMutex);
+        if( osEtag.empty() )
+        {
+            poThis->m_bUploadError = true;
+        }
+        else
+        {
+            const size_t nIdx = static_cast<size_t>(psJob->nPartNumber - 1);
+            if( poThis->m_aosEtags.size() <= nIdx )
+                poThis->m_aosEtags.resize(nIdx + 1);
+            poThis->m_aosEtags[nIdx] = osEtag;
+        }
+        poThis->m_apabyFreeBuffers.push_back(psJob->pabyBuffer);
+        poThis->m_nPendingUploads--;
+    }
+    poThis->m_oUploadCV.notify_one();
+    delete psJob;
+}
+
+/************************************************************************/
+/*                         SubmitUploadPart()                           */
+/************************************************************************/
+
+// Hands over m_pabyBuffer to a worker thread and acquires a new buffer,
+// waiting if all of them are currently being uploaded.
+bool VSIS3WriteHandle::SubmitUploadPart()
+{
+    if( !m_poUploadPool )
+    {
+        auto poPool = std::unique_ptr<CPLWorkerThreadPool>(
+                                                new CPLWorkerThreadPool());
+        if( !poPool->Setup(m_nUploadThreads, nullptr, nullptr, false) )
+            return false;
+        m_poUploadPool = std::move(poPool);
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(m_oUploadMutex);
+        if( m_bUploadError )
+            return false;
+        m_nPendingUploads++;
+    }
+
+    UploadJob* psJob = new UploadJob();
+    psJob->poParent = this;
+    psJob->pabyBuffer = m_pabyBuffer;
+    psJob->nSize = m_nBufferOff;
+    psJob->nPartNumber = m_nPartNumber;
+    if( !m_poUploadPool->SubmitJob(UploadPartJob, psJob) )
+    {
+        delete psJob;
+        std::lock_guard<std::mutex> oLock(m_oUploadMutex);
+        m_nPendingUploads--;
+        return false;
+    }
+    m_pabyBuffer = nullptr;
+    m_nBufferOff = 0;
+
+    std::unique_lock<std::mutex> oLock(m_oUploadMutex);
+    while( m_apabyFreeBuffers.empty() &&
+           m_nAllocatedBuffers > m_nUploadThreads &&
+           !m_bUploadError )
+    {
+        m_oUploadCV.wait(oLock);
+    }
+    if( m_bUploadError )
+        return false;
+    if( !m_apabyFreeBuffers.empty() )
+    {
+        m_pabyBuffer = m_apabyFreeBuffers.back();
+        m_apabyFreeBuffers.pop_back();
+    }
+    else
+    {
+        m_pabyBuffer = static_cast<GByte *>(VSIMalloc(m_nBufferSize));
+        if( m_pabyBuffer == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                    "Cannot allocate working buffer for %s",
+                     m_poFS->GetFSPrefix().c_str());
+            return false;
+        }
+        m_nAllocatedBuffers++;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                        WaitPendingUploads()                          */
+/************************************************************************/
+
+bool VSIS3WriteHandle::WaitPendingUploads()
+{
+    if( !m_poUploadPool )
+        return true;
+    m_poUploadPool->WaitCompletion();
+    std::lock_guard<std::mutex> oLock(m_oUploadMutex);
+    CPLAssert( m_nPendingUploads == 0 );
+    return !m_bUploadError;
+}
+
 CPLString IVSIS3LikeFSHandler::UploadPart(const CPLString& osFilename,
                                           int nPartNumber,
                                           const std::string& osUploadID,
@@ -986,6 +1377,213 @@ CPLString IVSIS3LikeFSHandler::UploadPart(const CPLString& osFilename,
     return osEtag;
 }
 
+/************************************************************************/
+/*                        GetCopySourceOptions()                        */
+/************************************************************************/
+
+// Return, as options for InitiateMultipartUpload(), the headers of
+// pszSource that CopyObject would have preserved: content headers, user
+// metadata, storage class and tags.
+CPLStringList IVSIS3LikeFSHandler::GetCopySourceOptions(const char* pszSource)
+{
+    CPLStringList aosOptions;
+    const CPLStringList aosHeaders(
+        GetFileMetadata(pszSource, "HEADERS", nullptr));
+    if( aosHeaders.empty() )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "Cannot read the headers of %s. Its metadata will not be "
+                 "copied", pszSource);
+        return aosOptions;
+    }
+
+    int nTagCount = 0;
+    for( int i = 0; i < aosHeaders.size(); ++i )
+    {
+        char* pszKey = nullptr;
+        const char* pszValue = CPLParseNameValue(aosHeaders[i], &pszKey);
+        if( pszKey && pszValue )
+        {
+            if( EQUAL(pszKey, "Content-Type") ||
+                EQUAL(pszKey, "Content-Encoding") ||
+                EQUAL(pszKey, "Content-Disposition") ||
+                EQUAL(pszKey, "Content-Language") ||
+                EQUAL(pszKey, "Cache-Control") ||
+                EQUAL(pszKey, "Expires") ||
+                EQUAL(pszKey, "x-amz-storage-class") ||
+                EQUAL(pszKey, "x-amz-website-redirect-location") ||
+                STARTS_WITH_CI(pszKey, "x-amz-meta-") )
+            {
+                aosOptions.SetNameValue(pszKey, pszValue);
+            }
+            else if( EQUAL(pszKey, "x-amz-tagging-count") )
+            {
+                nTagCount = atoi(pszValue);
+            }
+        }
+        CPLFree(pszKey);
+    }
+
+    if( nTagCount > 0 )
+    {
+        const CPLStringList aosTags(
+            GetFileMetadata(pszSource, "TAGS", nullptr));
+        CPLString osTagging;
+        for( int i = 0; i < aosTags.size(); ++i )
+        {
+            char* pszKey = nullptr;
+            const char* pszValue = CPLParseNameValue(aosTags[i], &pszKey);
+            if( pszKey && pszValue )
+            {
+                if( !osTagging.empty() )
+                    osTagging += '&';
+                osTagging += CPLAWSURLEncode(pszKey);
+                osTagging += '=';
+                osTagging += CPLAWSURLEncode(pszValue);
+            }
+            CPLFree(pszKey);
+        }
+        if( !osTagging.empty() )
+            aosOptions.SetNameValue("x-amz-tagging", osTagging);
+    }
+
+    return aosOptions;
+}
+
+/************************************************************************/
+/*                          UploadPartCopy()                            */
+/************************************************************************/
+
+CPLString IVSIS3LikeFSHandler::UploadPartCopy(const CPLString& osSource,
+                                              const CPLString& osFilename,
+                                              int nPartNumber,
+                                              const std::string& osUploadID,
+                                              vsi_l_offset nStartOffset,
+                                              vsi_l_offset nSize,
+                                              IVSIS3LikeHandleHelper *poS3HandleHelper,
+                                              int nMaxRetry,
+                                              double dfRetryDelay)
+{
+    NetworkStatisticsFileSystem oContextFS(GetFSPrefix());
+    NetworkStatisticsFile oContextFile(osFilename);
+    NetworkStatisticsAction oContextAction("UploadPartCopy");
+
+    std::string osSourceHeader(poS3HandleHelper->GetCopySourceHeader());
+    if( osSourceHeader.empty() || nSize == 0 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Part copy not supported by this file system");
+        return CPLString();
+    }
+    // x-amz-copy-source-range / x-oss-copy-source-range
+    const std::string osRangeHeader(CPLSPrintf("%s-range: bytes="
+                                                CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                                                osSourceHeader.c_str(),
+                                                static_cast<GUIntBig>(nStartOffset),
+                                                static_cast<GUIntBig>(nStartOffset + nSize - 1)));
+    osSourceHeader += ": /";
+    if( STARTS_WITH(osSource, "/vsis3/") )
+        osSourceHeader += CPLAWSURLEncode(osSource.c_str() + GetFSPrefix().size(), false);
+    else
+        osSourceHeader += (osSource.c_str() + GetFSPrefix().size());
+
+    bool bRetry;
+    int nRetryCount = 0;
+    CPLString osEtag;
+
+    do
+    {
+        bRetry = false;
+
+        CURL* hCurlHandle = curl_easy_init();
+        poS3HandleHelper->AddQueryParameter("partNumber",
+                                            CPLSPrintf("%d", nPartNumber));
+        poS3HandleHelper->AddQueryParameter("uploadId", osUploadID);
+        curl_easy_setopt(hCurlHandle, CURLOPT_CUSTOMREQUEST, "PUT");
+
+        struct curl_slist* headers = static_cast<struct curl_slist*>(
+            CPLHTTPSetOptions(hCurlHandle,
+                            poS3HandleHelper->GetURL().c_str(),
+                            nullptr));
+        headers = curl_slist_append(headers, osSourceHeader.c_str());
+        headers = curl_slist_append(headers, osRangeHeader.c_str());
+        headers = curl_slist_append(headers, "Content-Length: 0");
+        headers = VSICurlMergeHeaders(headers,
+                        poS3HandleHelper->GetCurlHeaders("PUT", headers));
+
+        CurlRequestHelper requestHelper;
+        const long response_code =
+            requestHelper.perform(hCurlHandle, headers, this, poS3HandleHelper);
+
+        NetworkStatisticsLogger::LogPUT(0);
+
+        // The ETag of the new part is returned in a CopyPartResult document.
+        // Note that S3 may return a 200 status with an Error document in the
+        // body if the copy fails after the response has started.
+        CPLXMLNode* psNode = nullptr;
+        if( response_code == 200 && requestHelper.sWriteFuncData.pBuffer != nullptr )
+        {
+            psNode = CPLParseXMLString(requestHelper.sWriteFuncData.pBuffer);
+            if( psNode )
+            {
+                osEtag = CPLGetXMLValue(psNode, "=CopyPartResult.ETag", "");
+                CPLDestroyXMLNode(psNode);
+            }
+        }
+
+        if( osEtag.empty() )
+        {
+            // Look if we should attempt a retry
+            const double dfNewRetryDelay = CPLHTTPGetNewRetryDelay(
+                static_cast<int>(response_code == 200 ? 500 : response_code),
+                dfRetryDelay,
+                requestHelper.sWriteFuncHeaderData.pBuffer, requestHelper.szCurlErrBuf);
+            if( dfNewRetryDelay > 0 &&
+                nRetryCount < nMaxRetry )
+            {
+                CPLError(CE_Warning, CPLE_AppDefined,
+                            "HTTP error code: %d - %s. "
+                            "Retrying again in %.1f secs",
+                            static_cast<int>(response_code),
+                            poS3HandleHelper->GetURL().c_str(),
+                            dfRetryDelay);
+                CPLSleep(dfRetryDelay);
+                dfRetryDelay = dfNewRetryDelay;
+                nRetryCount++;
+                bRetry = true;
+            }
+            else if( requestHelper.sWriteFuncData.pBuffer != nullptr &&
+                     poS3HandleHelper->CanRestartOnError(requestHelper.sWriteFuncData.pBuffer,
+                                                         requestHelper.sWriteFuncHeaderData.pBuffer,
+                                                         false) )
+            {
+                UpdateMapFromHandle(poS3HandleHelper);
+                bRetry = true;
+            }
+            else
+            {
+                CPLDebug(GetDebugKey(), "%s",
+                        requestHelper.sWriteFuncData.pBuffer ?
+                        requestHelper.sWriteFuncData.pBuffer : "(null)");
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "UploadPartCopy(%d) of %s to %s (uploadId = %s) failed",
+                         nPartNumber, osSource.c_str(), osFilename.c_str(),
+                         osUploadID.c_str());
+            }
+        }
+        else
+        {
+            CPLDebug(GetDebugKey(), "Etag for part %d is %s",
+                     nPartNumber, osEtag.c_str());
+        }
+
+        curl_easy_cleanup(hCurlHandle);
+    }
+    while( bRetry );
+
+    return osEtag;
+}
+
 /************************************************************************/
 /*                      ReadCallBackBufferChunked()                     */
 /************************************************************************/
@@ -1688,6 +2286,8 @@ int VSIS3WriteHandle::Close()
         }
         else
         {
+            if( !WaitPendingUploads() )
+                m_bError = true;
             if( m_bError )
             {
                 if( !m_poFS->AbortMultipart(m_osFilename, m_osUploadID,
@@ -1695,7 +2295,8 @@ int VSIS3WriteHandle::Close()
                                             m_nMaxRetry, m_dfRetryDelay) )
                     nRet = -1;
             }
-            else if( m_nBufferOff > 0 && !UploadPart() )
+            else if( m_nBufferOff > 0 &&
+                     (!UploadPart() || !WaitPendingUploads()) )
                 nRet = -1;
             else if( m_poFS->CompleteMultipart(
                                      m_osFilename, m_osUploadID,
@@ -1848,7 +2449,11 @@ const char* VSIS3FSHandler::GetOptions()
     "  <Option name='VSIS3_CHUNK_SIZE' type='int' "
         "description='Size in MB for chunks of files that are uploaded. The"
         "default value of 50 MB allows for files up to 500 GB each' "
-        "default='50' min='5' max='1000'/>" +
+        "default='50' min='5' max='1000'/>"
+    "  <Option name='VSIS3_UPLOAD_NUM_THREADS' type='string' "
+        "description='Number of threads used to upload chunks in parallel. "
+        "Integer value or ALL_CPUS. Each thread uses a buffer of "
+        "VSIS3_CHUNK_SIZE' default='1'/>" +
         VSICurlFilesystemHandler::GetOptionsStatic() +
         "</Options>");
     return osOptions.c_str();
@@ -2614,26 +3219,11 @@ int IVSIS3LikeFSHandler::Stat( const char *pszFilename, VSIStatBufL *pStatBuf,
         osFilenameWithoutSlash.resize(osFilenameWithoutSlash.size()-1);
 
     // If there's directory content for the directory where this file belongs to,
-    // use it to detect if the object does not exist
-    CachedDirList cachedDirList;
-    const CPLString osDirname(CPLGetDirname(osFilenameWithoutSlash));
-    if( STARTS_WITH_CI(osDirname, GetFSPrefix()) &&
-        GetCachedDirList(osDirname, cachedDirList) && cachedDirList.bGotFileList )
+    // use it to detect if the object does not exist. Repeated misses in
+    // the same directory list it.
+    if( GetExistenceFromParentListing(osFilenameWithoutSlash) == EXIST_NO )
     {
-        const CPLString osFilenameOnly(CPLGetFilename(osFilenameWithoutSlash));
-        bool bFound = false;
-        for( int i = 0; i < cachedDirList.oFileList.size(); i++ )
-        {
-            if( cachedDirList.oFileList[i] == osFilenameOnly )
-            {
-                bFound = true;
-                break;
-            }
-        }
-        if( !bFound )
-        {
-            return -1;
-        }
+        return -1;
     }
 
     if( VSICurlFilesystemHandler::Stat(osFilename, pStatBuf, nFlags) == 0 )
@@ -3100,7 +3690,15 @@ VSIDIR* IVSIS3LikeFSHandler::OpenDir( const char *pszPath,
                                       int nRecurseDepth,
                                       const char* const *papszOptions)
 {
-    if( nRecurseDepth > 0)
+    const int nThreads =
+        atoi(CSLFetchNameValueDef(papszOptions, "NUM_THREADS", "1"));
+    const int nMaxFiles =
+        atoi(CSLFetchNameValueDef(papszOptions, "MAXFILES", "0"));
+    // With several threads, each directory is listed separately, so that
+    // different directories can be listed concurrently.
+    const bool bParallel = nRecurseDepth != 0 && nThreads > 1 &&
+                           nMaxFiles <= 0;
+    if( nRecurseDepth > 0 && !bParallel )
     {
         return VSIFilesystemHandler::OpenDir(pszPath, nRecurseDepth, papszOptions);
     }
@@ -3127,6 +3725,11 @@ VSIDIR* IVSIS3LikeFSHandler::OpenDir( const char *pszPath,
         osObjectKey = osDirnameWithoutPrefix.substr(nSlashPos+1);
     }
 
+    if( nRecurseDepth > 0 && osBucket.empty() )
+    {
+        return VSIFilesystemHandler::OpenDir(pszPath, nRecurseDepth, papszOptions);
+    }
+
     IVSIS3LikeHandleHelper* poS3HandleHelper =
         CreateHandleHelper(osBucket, true);
     if( poS3HandleHelper == nullptr )
@@ -3135,13 +3738,14 @@ VSIDIR* IVSIS3LikeFSHandler::OpenDir( const char *pszPath,
     }
     UpdateHandleFromMap(poS3HandleHelper);
 
+    const bool bParallelListing = bParallel && !osBucket.empty();
     VSIDIRS3* dir = new VSIDIRS3(this);
-    dir->nRecurseDepth = nRecurseDepth;
+    dir->nRecurseDepth = bParallelListing ? 0 : nRecurseDepth;
     dir->poFS = this;
     dir->poS3HandleHelper = poS3HandleHelper;
     dir->osBucket = osBucket;
     dir->osObjectKey = osObjectKey;
-    dir->nMaxFiles = atoi(CSLFetchNameValueDef(papszOptions, "MAXFILES", "0"));
+    dir->nMaxFiles = nMaxFiles;
     dir->bCacheEntries = CPLTestBool(
         CSLFetchNameValueDef(papszOptions, "CACHE_ENTRIES", "TRUE"));
     if( !dir->IssueListDir() )
@@ -3150,6 +3754,24 @@ VSIDIR* IVSIS3LikeFSHandler::OpenDir( const char *pszPath,
         return nullptr;
     }
 
+    if( bParallelListing )
+    {
+        auto poListing = std::unique_ptr<VSIDIRS3ParallelListing>(
+                                            new VSIDIRS3ParallelListing());
+        poListing->poS3FS = this;
+        poListing->osBucket = osBucket;
+        poListing->osObjectKey = osObjectKey;
+        poListing->nRecurseDepth = nRecurseDepth;
+        poListing->bCacheEntries = dir->bCacheEntries;
+        poListing->nThreads = nThreads;
+        if( !poListing->AddPage(VSIDIRS3ParallelListing::Task(), *dir) )
+        {
+            delete dir;
+            return nullptr;
+        }
+        dir->poParallelListing = std::move(poListing);
+    }
+
     return dir;
 }
 
@@ -3577,14 +4199,27 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
         bUploadFromLocalToNetwork && poTargetFSHandler != nullptr &&
         poTargetFSHandler->SupportsParallelMultipartUpload();
     const bool bSimulateThreading = CPLTestBool(CPLGetConfigOption("VSIS3_SIMULATE_THREADING", "NO"));
-    const int nMinSizeChunk = bSupportsParallelMultipartUpload && !bSimulateThreading ? 8 * 1024 * 1024 : 1; // 5242880 defined by S3 API as the minimum, but 8 MB used by default by the Python s3transfer library
     const int nMinThreads = bSimulateThreading ? 0 : 1;
+    // Copy between two objects of the same bucket-like file system: large
+    // objects are split into parts that are copied server-side in parallel
+    // with UploadPartCopy, which also lifts the 5 GB limit of CopyObject.
+    const bool bServerSideCopy =
+        STARTS_WITH(pszSource, GetFSPrefix()) && bTargetIsThisFS &&
+        nRequestedThreads > nMinThreads &&
+        SupportsUploadPartCopy();
+    const int nMinSizeChunk =
+        (bSupportsParallelMultipartUpload || bServerSideCopy) && !bSimulateThreading ? 8 * 1024 * 1024 : 1; // 5242880 defined by S3 API as the minimum, but 8 MB used by default by the Python s3transfer library
     const size_t nMaxChunkSize =
         pszChunkSize && nRequestedThreads > nMinThreads &&
-        (bDownloadFromNetworkToLocal || bSupportsParallelMultipartUpload) ?
+        (bDownloadFromNetworkToLocal || bSupportsParallelMultipartUpload ||
+         bServerSideCopy) ?
             static_cast<size_t>(std::min(1024 * 1024 * 1024,
                                 std::max(nMinSizeChunk,
-                                            atoi(pszChunkSize)))): 0;
+                                            atoi(pszChunkSize)))):
+        bServerSideCopy ? 100 * 1024 * 1024 : 0;
+    // Server-side parts do not transit through memory, so more of them
+    // can be afforded
+    const vsi_l_offset nMaxChunkCount = bServerSideCopy ? knMAX_PART_NUMBER : 1000;
 
     uint64_t nTotalSize = 0;
     std::vector<size_t> anIndexToCopy; // points to aoChunksToCopy
@@ -3720,7 +4355,7 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                 // Split file in possibly multiple chunks
                 const vsi_l_offset nChunksLarge = nMaxChunkSize == 0 ? 1 :
                         (entry->nSize + nMaxChunkSize - 1) / nMaxChunkSize;
-                if( nChunksLarge > 1000 ) // must also be below knMAX_PART_NUMBER for upload
+                if( nChunksLarge > nMaxChunkCount ) // must also be below knMAX_PART_NUMBER for upload
                 {
                     CPLError(CE_Failure, CPLE_AppDefined,
                              "Too small CHUNK_SIZE w.r.t file size");
@@ -3826,19 +4461,25 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                         // for parallelized writing
                         VSIUnlink(osSubTarget);
                     }
-                    else if( bSupportsParallelMultipartUpload )
+                    else if( bSupportsParallelMultipartUpload || bServerSideCopy )
                     {
                         auto poS3HandleHelper = std::unique_ptr<IVSIS3LikeHandleHelper>(
                             CreateHandleHelper(osSubTarget.c_str() + GetFSPrefix().size(), false));
                         if( poS3HandleHelper == nullptr )
                             return false;
                         UpdateHandleFromMap(poS3HandleHelper.get());
+                        // Unlike CopyObject, a multipart copy does not
+                        // carry over the metadata of the source object.
+                        const CPLStringList aosOptions(
+                            bServerSideCopy ?
+                                GetCopySourceOptions(osSubSource) :
+                                CPLStringList());
                         const auto osUploadID =
                             InitiateMultipartUpload(osSubTarget,
                                                     poS3HandleHelper.get(),
                                                     nMaxRetry,
                                                     dfRetryDelay,
-                                                    nullptr);
+                                                    aosOptions.List());
                         if( osUploadID.empty() )
                         {
                             return false;
@@ -3979,7 +4620,7 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
         // Split file in possibly multiple chunks
         const vsi_l_offset nChunksLarge = nMaxChunkSize == 0 ? 1 :
                 (sSource.st_size + nMaxChunkSize - 1) / nMaxChunkSize;
-        if( nChunksLarge > 1000 ) // must also be below knMAX_PART_NUMBER for upload
+        if( nChunksLarge > nMaxChunkCount ) // must also be below knMAX_PART_NUMBER for upload
         {
             CPLError(CE_Failure, CPLE_AppDefined,
                         "Too small CHUNK_SIZE w.r.t file size");
@@ -4009,19 +4650,23 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                         // for parallelized writing
                         VSIUnlink(osTarget);
                     }
-                    else if( bSupportsParallelMultipartUpload )
+                    else if( bSupportsParallelMultipartUpload || bServerSideCopy )
                     {
                         auto poS3HandleHelper = std::unique_ptr<IVSIS3LikeHandleHelper>(
                             CreateHandleHelper(osTarget.c_str() + GetFSPrefix().size(), false));
                         if( poS3HandleHelper == nullptr )
                             return false;
                         UpdateHandleFromMap(poS3HandleHelper.get());
+                        const CPLStringList aosOptions(
+                            bServerSideCopy ?
+                                GetCopySourceOptions(osSourceWithoutSlash) :
+                                CPLStringList());
                         const auto osUploadID =
                             InitiateMultipartUpload(osTarget,
                                                     poS3HandleHelper.get(),
                                                     nMaxRetry,
                                                     dfRetryDelay,
-                                                    nullptr);
+                                                    aosOptions.List());
                         if( osUploadID.empty() )
                         {
                             return false;
@@ -4068,6 +4713,7 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
         const std::vector<size_t>& anIndexToCopy;
         std::map<CPLString, MultiPartDef>& oMapMultiPartDefs;
         volatile int iCurIdx = 0;
+        volatile int nRunningThreads = 0;
         volatile bool ret = true;
         volatile bool stop = false;
         CPLString osSourceDir{};
@@ -4077,6 +4723,7 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
         std::mutex sMutex{};
         uint64_t nTotalCopied = 0;
         bool bSupportsParallelMultipartUpload = false;
+        bool bServerSideCopy = false;
         size_t nMaxChunkSize = 0;
         int nMaxRetry = 0;
         double dfRetryDelay = 0.0;
@@ -4090,6 +4737,7 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                     const CPLString& osSourceIn,
                     const CPLString& osTargetIn,
                     bool bSupportsParallelMultipartUploadIn,
+                    bool bServerSideCopyIn,
                     size_t nMaxChunkSizeIn,
                     int nMaxRetryIn,
                     double dfRetryDelayIn):
@@ -4102,6 +4750,7 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
             osSource(osSourceIn),
             osTarget(osTargetIn),
             bSupportsParallelMultipartUpload(bSupportsParallelMultipartUploadIn),
+            bServerSideCopy(bServerSideCopyIn),
             nMaxChunkSize(nMaxChunkSizeIn),
             nMaxRetry(nMaxRetryIn),
             dfRetryDelay(dfRetryDelayIn)
@@ -4196,6 +4845,38 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                         VSIFCloseL(fpIn);
                     VSIFree(pBuffer);
                 }
+                else if( queue->bServerSideCopy )
+                {
+                    const auto iter = queue->oMapMultiPartDefs.find(osSubTarget);
+                    CPLAssert(iter != queue->oMapMultiPartDefs.end());
+
+                    auto poS3HandleHelper = std::unique_ptr<IVSIS3LikeHandleHelper>(
+                        queue->poFS->CreateHandleHelper(
+                            osSubTarget.c_str() + queue->poFS->GetFSPrefix().size(), false));
+                    if( poS3HandleHelper )
+                    {
+                        queue->poFS->UpdateHandleFromMap(poS3HandleHelper.get());
+                        const int nPartNumber = 1 +
+                            static_cast<int>(chunk.nStartOffset / queue->nMaxChunkSize);
+                        const CPLString osEtag = queue->poFS->UploadPartCopy(
+                            osSubSource, osSubTarget, nPartNumber,
+                            iter->second.osUploadID,
+                            chunk.nStartOffset, chunk.nSize,
+                            poS3HandleHelper.get(),
+                            queue->nMaxRetry,
+                            queue->dfRetryDelay);
+                        if( !osEtag.empty() )
+                        {
+                            std::lock_guard<std::mutex> lock(queue->sMutex);
+                            iter->second.nCountValidETags ++;
+                            iter->second.aosEtags.resize(
+                                std::max(nPartNumber,
+                                            static_cast<int>(iter->second.aosEtags.size())));
+                            iter->second.aosEtags[nPartNumber-1] = osEtag;
+                            bSuccess = true;
+                        }
+                    }
+                }
                 else
                 {
                     bSuccess = CopyChunk(osSubSource, osSubTarget,
@@ -4224,23 +4905,26 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                 }
             }
         }
+        CPLAtomicDec(&(queue->nRunningThreads));
     };
 
     JobQueue sJobQueue(this, aoChunksToCopy, anIndexToCopy,
                         oMapMultiPartDefs,
                         osSourceWithoutSlash, osTargetDir,
                         osSourceWithoutSlash, osTarget,
-                        bSupportsParallelMultipartUpload, nMaxChunkSize,
-                        nMaxRetry, dfRetryDelay);
+                        bSupportsParallelMultipartUpload, bServerSideCopy,
+                        nMaxChunkSize, nMaxRetry, dfRetryDelay);
 
     if( CPLTestBool(CPLGetConfigOption("VSIS3_SYNC_MULTITHREADING", "YES")) )
     {
         std::vector<CPLJoinableThread*> ahThreads;
         for( int i = 0; i < nThreads; i++ )
         {
+            CPLAtomicInc(&(sJobQueue.nRunningThreads));
             auto hThread = CPLCreateJoinableThread(threadFunc, &sJobQueue);
             if( !hThread )
             {
+                CPLAtomicDec(&(sJobQueue.nRunningThreads));
                 sJobQueue.ret = false;
                 sJobQueue.stop = true;
                 break;
@@ -4249,15 +4933,18 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
         }
         if( pProgressFunc )
         {
-            while( !sJobQueue.stop )
+            // Wait for all workers, and not only for the job queue to be
+            // exhausted, so that the last large files are accounted for.
+            while( sJobQueue.nRunningThreads > 0 )
             {
                 CPLSleep(0.1);
                 sJobQueue.sMutex.lock();
                 const auto nTotalCopied = sJobQueue.nTotalCopied;
                 sJobQueue.sMutex.unlock();
                 // coverity[divide_by_zero]
-                if( !pProgressFunc(double(nTotalCopied) / nTotalSize,
-                                "", pProgressData) )
+                if( sJobQueue.ret &&
+                    !pProgressFunc(double(nTotalCopied) / nTotalSize,
+                                   "", pProgressData) )
                 {
                     sJobQueue.ret = false;
                     sJobQueue.stop = true;
@@ -4276,11 +4963,12 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
     else
     {
         // Only for simulation case
+        sJobQueue.nRunningThreads = 1;
         threadFunc(&sJobQueue);
     }
 
     // Finalize multipart uploads
-    if( sJobQueue.ret && bSupportsParallelMultipartUpload)
+    if( sJobQueue.ret && (bSupportsParallelMultipartUpload || bServerSideCopy) )
     {
         std::set<CPLString> oSetKeysToRemove;
         for( const auto& kv: oMapMultiPartDefs )
@@ -37,6 +37,7 @@
 #  include <fcntl.h>
 #endif
 #include <limits>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_multiproc.h"
@@ -67,6 +68,8 @@ class VSISubFileHandle final: public VSIVirtualHandle
     int Seek( vsi_l_offset nOffset, int nWhence ) override;
     vsi_l_offset Tell() override;
     size_t Read( void *pBuffer, size_t nSize, size_t nMemb ) override;
+    void AdviseRead( int nRanges, const vsi_l_offset* panOffsets,
+                     const size_t* panSizes ) override;
     size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
     int Eof() override;
     int Close() override;
@@ -224,6 +227,36 @@ size_t VSISubFileHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
     return nRet;
 }
 
+/************************************************************************/
+/*                             AdviseRead()                             */
+/************************************************************************/
+
+void VSISubFileHandle::AdviseRead( int nRanges,
+                                   const vsi_l_offset* panOffsets,
+                                   const size_t* panSizes )
+{
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    for( int i = 0; i < nRanges; i++ )
+    {
+        size_t nSize = panSizes[i];
+        if( nSubregionSize != 0 )
+        {
+            if( panOffsets[i] >= nSubregionSize )
+                continue;
+            if( panOffsets[i] + nSize > nSubregionSize )
+                nSize = static_cast<size_t>(nSubregionSize - panOffsets[i]);
+        }
+        anOffsets.push_back(nSubregionOffset + panOffsets[i]);
+        anSizes.push_back(nSize);
+    }
+    if( !anOffsets.empty() )
+    {
+        VSIFAdviseReadL( static_cast<int>(anOffsets.size()),
+                         anOffsets.data(), anSizes.data(), fp );
+    }
+}
+
 /************************************************************************/
 /*                               Write()                                */
 /************************************************************************/
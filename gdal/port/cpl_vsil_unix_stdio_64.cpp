@@ -77,8 +77,24 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_PREADV
+#include <sys/uio.h>
+#endif
+
+#if defined(__linux) && defined(HAVE_LINUX_IO_URING_H)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <new>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
@@ -109,6 +125,18 @@ CPL_CVSID("$Id$")
 #ifndef VSI_FTRUNCATE64
 #define VSI_FTRUNCATE64 ftruncate64
 #endif
+#ifndef VSI_FSTAT64
+#define VSI_FSTAT64 fstat64
+#endif
+#ifndef VSI_PREAD64
+#define VSI_PREAD64 pread64
+#endif
+#ifndef VSI_PREADV64
+#define VSI_PREADV64 preadv64
+#endif
+#ifndef VSI_OFF64_T
+#define VSI_OFF64_T off64_t
+#endif
 
 #else /* not UNIX_STDIO_64 */
 
@@ -130,9 +158,67 @@ CPL_CVSID("$Id$")
 #ifndef VSI_FTRUNCATE64
 #define VSI_FTRUNCATE64 ftruncate
 #endif
+#ifndef VSI_FSTAT64
+#define VSI_FSTAT64 fstat
+#endif
+#ifndef VSI_PREAD64
+#define VSI_PREAD64 pread
+#endif
+#ifndef VSI_PREADV64
+#define VSI_PREADV64 preadv
+#endif
+#ifndef VSI_OFF64_T
+#define VSI_OFF64_T off_t
+#endif
 
 #endif /* ndef UNIX_STDIO_64 */
 
+// IORING_OP_READ and IORING_REGISTER_PROBE, on which we rely, appeared
+// together with IO_URING_OP_SUPPORTED in Linux 5.6
+#if defined(HAVE_PREAD) && defined(HAVE_MMAP) && \
+    defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+    defined(__NR_io_uring_register) && defined(IO_URING_OP_SUPPORTED)
+#define VSI_HAVE_IO_URING
+#endif
+
+/************************************************************************/
+/*                          VSIUnixDropBehind                           */
+/************************************************************************/
+
+// Evicts from the page cache the part of a file that has already been
+// consumed, when reading it with the DROP_BEHIND=YES open option, so that
+// streaming large files does not push out more useful cached data.
+
+struct VSIUnixDropBehind
+{
+    bool          bEnabled = false;
+    vsi_l_offset  nStart = 0;
+
+    void Update( CPL_UNUSED int fd, CPL_UNUSED vsi_l_offset nCurOffset,
+                 CPL_UNUSED bool bForce = false )
+    {
+#ifdef HAVE_POSIX_FADVISE
+        if( !bEnabled )
+            return;
+        if( nCurOffset < nStart )
+        {
+            // Backward seek
+            nStart = nCurOffset;
+            return;
+        }
+        constexpr vsi_l_offset knChunkSize = 16 * 1024 * 1024;
+        if( nCurOffset - nStart >= knChunkSize ||
+            (bForce && nCurOffset > nStart) )
+        {
+            posix_fadvise(fd, static_cast<VSI_OFF64_T>(nStart),
+                          static_cast<VSI_OFF64_T>(nCurOffset - nStart),
+                          POSIX_FADV_DONTNEED);
+            nStart = nCurOffset;
+        }
+#endif
+    }
+};
+
 /************************************************************************/
 /* ==================================================================== */
 /*                       VSIUnixStdioFilesystemHandler                  */
@@ -167,6 +253,7 @@ public:
     char **ReadDirEx( const char *pszDirname, int nMaxFiles ) override;
     GIntBig GetDiskFreeSpace( const char* pszDirname ) override;
     int SupportsSparseFiles( const char* pszPath ) override;
+    int HasOptimizedReadMultiRange( const char* pszPath ) override;
 
 #ifdef VSI_COUNT_BYTES_READ
     void             AddToTotal(vsi_l_offset nBytes);
@@ -194,6 +281,7 @@ class VSIUnixStdioHandle final : public VSIVirtualHandle
     // file and thus a call to our Seek(0, SEEK_SET) before a read will be a
     // no-op.
     bool          bModeAppendReadWrite = false;
+    VSIUnixDropBehind m_oDropBehind{};
 #ifdef VSI_COUNT_BYTES_READ
     vsi_l_offset  nTotalBytesRead = 0;
     VSIUnixStdioFilesystemHandler *poFS = nullptr;
@@ -203,6 +291,8 @@ class VSIUnixStdioHandle final : public VSIVirtualHandle
                         FILE* fpIn, bool bReadOnlyIn,
                         bool bModeAppendReadWriteIn );
 
+    void EnableDropBehind() { m_oDropBehind.bEnabled = bReadOnly; }
+
     int Seek( vsi_l_offset nOffsetIn, int nWhence ) override;
     vsi_l_offset Tell() override;
     size_t Read( void *pBuffer, size_t nSize, size_t nMemb ) override;
@@ -215,6 +305,20 @@ class VSIUnixStdioHandle final : public VSIVirtualHandle
         return reinterpret_cast<void *>(static_cast<size_t>(fileno(fp))); }
     VSIRangeStatus GetRangeStatus( vsi_l_offset nOffset,
                                    vsi_l_offset nLength ) override;
+#ifdef HAVE_PREAD
+    // pread() does not use nor update the FILE* position, which is safe
+    // as long as there are no pending buffered writes.
+    bool HasPRead() const override { return bReadOnly; }
+    size_t PRead( void* pBuffer, size_t nSize,
+                  vsi_l_offset nOffset ) const override;
+#endif
+#ifdef VSI_HAVE_IO_URING
+    int ReadMultiRange( int nRanges, void ** ppData,
+                        const vsi_l_offset* panOffsets,
+                        const size_t* panSizes ) override;
+    void AdviseRead( int nRanges, const vsi_l_offset* panOffsets,
+                     const size_t* panSizes ) override;
+#endif
 };
 
 /************************************************************************/
@@ -250,6 +354,8 @@ int VSIUnixStdioHandle::Close()
     poFS->AddToTotal(nTotalBytesRead);
 #endif
 
+    m_oDropBehind.Update(fileno(fp), m_nOffset, true);
+
     return fclose( fp );
 }
 
@@ -436,6 +542,8 @@ size_t VSIUnixStdioHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
         bAtEOF = CPL_TO_BOOL(feof(fp));
     }
 
+    m_oDropBehind.Update(fileno(fp), m_nOffset);
+
     return nResult;
 }
 
@@ -521,15 +629,19 @@ int VSIUnixStdioHandle::Truncate( vsi_l_offset nNewSize )
 #include <errno.h>
 #endif
 
-VSIRangeStatus VSIUnixStdioHandle::GetRangeStatus( vsi_l_offset
+static VSIRangeStatus VSIUnixGetRangeStatus( int
 #ifdef FS_IOC_FIEMAP
-                                                                nOffset
+                                                    fd
 #endif
-                                                     , vsi_l_offset
+                                             , vsi_l_offset
 #ifdef FS_IOC_FIEMAP
-                                                                nLength
+                                                    nOffset
 #endif
-                                                    )
+                                             , vsi_l_offset
+#ifdef FS_IOC_FIEMAP
+                                                    nLength
+#endif
+                                            )
 {
 #ifdef FS_IOC_FIEMAP
     // fiemap IOCTL documented at
@@ -539,7 +651,6 @@ VSIRangeStatus VSIUnixStdioHandle::GetRangeStatus( vsi_l_offset
     // As we are interested in only one extent, we allocate the base size of
     // fiemap + one fiemap_extent.
     GByte abyBuffer[sizeof(struct fiemap) + sizeof(struct fiemap_extent)];
-    int fd = fileno(fp);
     struct fiemap *psExtentMap = reinterpret_cast<struct fiemap *>(&abyBuffer);
     memset(psExtentMap,
            0,
@@ -582,6 +693,780 @@ VSIRangeStatus VSIUnixStdioHandle::GetRangeStatus( vsi_l_offset
 #endif
 }
 
+VSIRangeStatus VSIUnixStdioHandle::GetRangeStatus( vsi_l_offset nOffset,
+                                                   vsi_l_offset nLength )
+{
+    return VSIUnixGetRangeStatus(fileno(fp), nOffset, nLength);
+}
+
+#ifdef HAVE_PREAD
+
+/************************************************************************/
+/*                          VSIUnixPReadAll()                           */
+/************************************************************************/
+
+// Loops over pread() until nSize bytes are read, end of file is reached
+// or an error (other than EINTR) occurs.
+static size_t VSIUnixPReadAll( int fd, void* pBuffer, size_t nSize,
+                               vsi_l_offset nOffset )
+{
+    GByte* pabyBuffer = static_cast<GByte*>(pBuffer);
+    size_t nRead = 0;
+    while( nRead < nSize )
+    {
+        const ssize_t nRet = VSI_PREAD64(fd, pabyBuffer + nRead, nSize - nRead,
+                                         static_cast<VSI_OFF64_T>(nOffset + nRead));
+        if( nRet < 0 && errno == EINTR )
+            continue;
+        if( nRet <= 0 )
+            break;
+        nRead += static_cast<size_t>(nRet);
+    }
+    return nRead;
+}
+
+#ifdef VSI_HAVE_IO_URING
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           VSIUnixIOURing                             */
+/* ==================================================================== */
+/************************************************************************/
+
+// Minimal io_uring wrapper using the raw system calls, so as not to depend
+// on liburing. It submits a batch of positional reads (or of read-ahead
+// advices) and waits for their completion in a single io_uring_enter() call.
+// There is one ring per thread, created on first use.
+
+namespace {
+
+class VSIUnixIOURing
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIUnixIOURing)
+
+    int                  m_fd = -1;
+    unsigned             m_nEntries = 0;
+    bool                 m_bBroken = false;
+    void                *m_pSQRing = nullptr;
+    size_t               m_nSQRingSize = 0;
+    void                *m_pCQRing = nullptr;
+    size_t               m_nCQRingSize = 0;
+    struct io_uring_sqe *m_pasSQE = nullptr;
+    size_t               m_nSQESize = 0;
+    unsigned            *m_pnSQHead = nullptr;
+    unsigned            *m_pnSQTail = nullptr;
+    unsigned            *m_pnSQMask = nullptr;
+    unsigned            *m_pnSQArray = nullptr;
+    unsigned            *m_pnCQHead = nullptr;
+    unsigned            *m_pnCQTail = nullptr;
+    unsigned            *m_pnCQMask = nullptr;
+    struct io_uring_cqe *m_pasCQE = nullptr;
+
+    bool Init();
+
+    static std::atomic<bool> gbUnavailable;
+
+  public:
+    VSIUnixIOURing() = default;
+    ~VSIUnixIOURing();
+
+    static VSIUnixIOURing* GetForCurrentThread();
+
+    int Run( int fd, int nRanges, void ** ppData,
+             const vsi_l_offset* panOffsets, const size_t* panSizes );
+};
+
+std::atomic<bool> VSIUnixIOURing::gbUnavailable{false};
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+bool VSIUnixIOURing::Init()
+{
+    constexpr unsigned knEntries = 64;
+    struct io_uring_params sParams;
+    memset(&sParams, 0, sizeof(sParams));
+    m_fd = static_cast<int>(syscall(__NR_io_uring_setup, knEntries, &sParams));
+    if( m_fd < 0 )
+        return false;
+    m_nEntries = sParams.sq_entries;
+
+    m_nSQRingSize = sParams.sq_off.array + sParams.sq_entries * sizeof(unsigned);
+    m_nCQRingSize = sParams.cq_off.cqes +
+                    sParams.cq_entries * sizeof(struct io_uring_cqe);
+    const bool bSingleMMap = (sParams.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if( bSingleMMap )
+    {
+        m_nSQRingSize = std::max(m_nSQRingSize, m_nCQRingSize);
+        m_nCQRingSize = 0;
+    }
+    void* pMap = mmap(nullptr, m_nSQRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if( pMap == MAP_FAILED )
+        return false;
+    m_pSQRing = pMap;
+    if( bSingleMMap )
+    {
+        m_pCQRing = m_pSQRing;
+    }
+    else
+    {
+        pMap = mmap(nullptr, m_nCQRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        if( pMap == MAP_FAILED )
+            return false;
+        m_pCQRing = pMap;
+    }
+    m_nSQESize = sParams.sq_entries * sizeof(struct io_uring_sqe);
+    pMap = mmap(nullptr, m_nSQESize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if( pMap == MAP_FAILED )
+        return false;
+    m_pasSQE = static_cast<struct io_uring_sqe*>(pMap);
+
+    GByte* pabySQ = static_cast<GByte*>(m_pSQRing);
+    m_pnSQHead = reinterpret_cast<unsigned*>(pabySQ + sParams.sq_off.head);
+    m_pnSQTail = reinterpret_cast<unsigned*>(pabySQ + sParams.sq_off.tail);
+    m_pnSQMask = reinterpret_cast<unsigned*>(pabySQ + sParams.sq_off.ring_mask);
+    m_pnSQArray = reinterpret_cast<unsigned*>(pabySQ + sParams.sq_off.array);
+    GByte* pabyCQ = static_cast<GByte*>(m_pCQRing);
+    m_pnCQHead = reinterpret_cast<unsigned*>(pabyCQ + sParams.cq_off.head);
+    m_pnCQTail = reinterpret_cast<unsigned*>(pabyCQ + sParams.cq_off.tail);
+    m_pnCQMask = reinterpret_cast<unsigned*>(pabyCQ + sParams.cq_off.ring_mask);
+    m_pasCQE = reinterpret_cast<struct io_uring_cqe*>(pabyCQ + sParams.cq_off.cqes);
+
+    // Check that the kernel knows the operations we use.
+    constexpr int knProbeOps = 256;
+    std::vector<GByte> abyProbe(sizeof(struct io_uring_probe) +
+                                knProbeOps * sizeof(struct io_uring_probe_op));
+    auto psProbe = reinterpret_cast<struct io_uring_probe*>(abyProbe.data());
+    if( syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE,
+                psProbe, knProbeOps) < 0 )
+        return false;
+    for( const int nOp: { static_cast<int>(IORING_OP_READ),
+                          static_cast<int>(IORING_OP_FADVISE) } )
+    {
+        if( nOp > psProbe->last_op ||
+            (psProbe->ops[nOp].flags & IO_URING_OP_SUPPORTED) == 0 )
+        {
+            errno = ENOTSUP;
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          ~VSIUnixIOURing()                           */
+/************************************************************************/
+
+VSIUnixIOURing::~VSIUnixIOURing()
+{
+    if( m_pasSQE )
+        munmap(m_pasSQE, m_nSQESize);
+    if( m_pCQRing && m_pCQRing != m_pSQRing )
+        munmap(m_pCQRing, m_nCQRingSize);
+    if( m_pSQRing )
+        munmap(m_pSQRing, m_nSQRingSize);
+    if( m_fd >= 0 )
+        close(m_fd);
+}
+
+/************************************************************************/
+/*                        GetForCurrentThread()                         */
+/************************************************************************/
+
+VSIUnixIOURing* VSIUnixIOURing::GetForCurrentThread()
+{
+    static thread_local std::unique_ptr<VSIUnixIOURing> tlsRing;
+
+    if( gbUnavailable )
+        return nullptr;
+    if( tlsRing )
+        return tlsRing->m_bBroken ? nullptr : tlsRing.get();
+    if( !CPLTestBool(CPLGetConfigOption("VSI_LOCAL_IO_URING", "YES")) )
+        return nullptr;
+
+    std::unique_ptr<VSIUnixIOURing> poRing(new(std::nothrow) VSIUnixIOURing());
+    if( poRing == nullptr )
+        return nullptr;
+    if( !poRing->Init() )
+    {
+        // Likely a kernel that is too old, or io_uring being forbidden by
+        // a seccomp policy. Do not try again.
+        CPLDebug("VSI", "io_uring not available (%s). "
+                 "Using pread() for ReadMultiRange()", VSIStrerror(errno));
+        gbUnavailable = true;
+        return nullptr;
+    }
+    tlsRing = std::move(poRing);
+    return tlsRing.get();
+}
+
+/************************************************************************/
+/*                                 Run()                                */
+/************************************************************************/
+
+// Reads the ranges into ppData, or if ppData is nullptr, advises the
+// kernel that they will be needed. Returns 0 in case of success.
+int VSIUnixIOURing::Run( int fd, int nRanges, void ** ppData,
+                         const vsi_l_offset* panOffsets,
+                         const size_t* panSizes )
+{
+    int nRet = 0;
+    std::vector<bool> abDone;
+    for( int iFirst = 0; iFirst < nRanges; )
+    {
+        const unsigned nBatch = std::min(m_nEntries,
+                                         static_cast<unsigned>(nRanges - iFirst));
+
+        // Queue the submission entries.
+        const unsigned nMask = *m_pnSQMask;
+        unsigned nTail = *m_pnSQTail;
+        for( unsigned k = 0; k < nBatch; ++k, ++nTail )
+        {
+            const int i = iFirst + static_cast<int>(k);
+            const unsigned nIdx = nTail & nMask;
+            struct io_uring_sqe* psSQE = &m_pasSQE[nIdx];
+            memset(psSQE, 0, sizeof(*psSQE));
+            psSQE->fd = fd;
+            psSQE->off = panOffsets[i];
+            // Linux never transfers more than 0x7ffff000 bytes at once.
+            // Short reads are completed with pread() below.
+            psSQE->len = static_cast<unsigned>(
+                std::min(panSizes[i], static_cast<size_t>(0x7ffff000)));
+            psSQE->user_data = k;
+            if( ppData )
+            {
+                psSQE->opcode = IORING_OP_READ;
+                psSQE->addr = reinterpret_cast<uintptr_t>(ppData[i]);
+            }
+            else
+            {
+                psSQE->opcode = IORING_OP_FADVISE;
+                psSQE->fadvise_advice = POSIX_FADV_WILLNEED;
+            }
+            m_pnSQArray[nIdx] = nIdx;
+        }
+        __atomic_store_n(m_pnSQTail, nTail, __ATOMIC_RELEASE);
+
+        // Submit them and reap the completions.
+        abDone.assign(nBatch, false);
+        unsigned nToSubmit = nBatch;
+        unsigned nInFlight = 0;
+        const auto ReapCompletions = [&]()
+        {
+            unsigned nHead = *m_pnCQHead;
+            const unsigned nCQTail = __atomic_load_n(m_pnCQTail, __ATOMIC_ACQUIRE);
+            const unsigned nCQMask = *m_pnCQMask;
+            for( ; nHead != nCQTail; ++nHead )
+            {
+                const struct io_uring_cqe* psCQE = &m_pasCQE[nHead & nCQMask];
+                const unsigned k = static_cast<unsigned>(psCQE->user_data);
+                const int i = iFirst + static_cast<int>(k);
+                if( ppData )
+                {
+                    const size_t nDone =
+                        psCQE->res > 0 ? static_cast<size_t>(psCQE->res) : 0;
+                    if( nDone < panSizes[i] &&
+                        VSIUnixPReadAll(fd,
+                                        static_cast<GByte*>(ppData[i]) + nDone,
+                                        panSizes[i] - nDone,
+                                        panOffsets[i] + nDone) !=
+                            panSizes[i] - nDone )
+                    {
+                        nRet = -1;
+                    }
+                }
+                abDone[k] = true;
+                --nInFlight;
+            }
+            __atomic_store_n(m_pnCQHead, nHead, __ATOMIC_RELEASE);
+        };
+        // Wait, without submitting anything, until at most nMaxInFlight
+        // reads are in flight. The kernel may still write into the buffers
+        // of the others, so give up only once they have completed.
+        const auto WaitCompletions = [&]( unsigned nMaxInFlight )
+        {
+            while( nInFlight > nMaxInFlight )
+            {
+                if( syscall(__NR_io_uring_enter, m_fd, 0, 1,
+                            IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                    errno != EINTR )
+                {
+                    CPLSleep(0.001);
+                }
+                ReapCompletions();
+            }
+        };
+
+        int nRetries = 0;
+        while( nToSubmit > 0 || nInFlight > 0 )
+        {
+            const int nSubmitted = static_cast<int>(
+                syscall(__NR_io_uring_enter, m_fd, nToSubmit, 1,
+                        IORING_ENTER_GETEVENTS, nullptr, 0));
+            if( nSubmitted < 0 )
+            {
+                const int nErrno = errno;
+                if( nErrno == EINTR )
+                    continue;
+                // Lack of kernel resources, or too many pending completions:
+                // wait for some of the reads in flight, or a bit, and retry.
+                constexpr int knMaxRetries = 10;
+                const bool bRetryable = nErrno == EAGAIN || nErrno == EBUSY;
+                if( bRetryable && nRetries < knMaxRetries )
+                {
+                    ++nRetries;
+                    if( nInFlight > 0 )
+                        WaitCompletions(nInFlight - 1);
+                    else
+                        CPLSleep(0.001);
+                    continue;
+                }
+                CPLDebug("VSI", "io_uring_enter() failed: %s",
+                         VSIStrerror(nErrno));
+                if( !bRetryable )
+                    m_bBroken = true;
+                // Withdraw the entries that the kernel has not consumed.
+                // Those it has consumed are in flight.
+                const unsigned nSQHead =
+                    __atomic_load_n(m_pnSQHead, __ATOMIC_ACQUIRE);
+                const unsigned nConsumed = nSQHead - (nTail - nToSubmit);
+                if( nConsumed <= nToSubmit )
+                {
+                    nInFlight += nConsumed;
+                    __atomic_store_n(m_pnSQTail, nSQHead, __ATOMIC_RELEASE);
+                    nToSubmit = 0;
+                }
+                else
+                {
+                    m_bBroken = true;
+                }
+                // The remaining ranges are read with pread() below.
+                WaitCompletions(0);
+                break;
+            }
+            nRetries = 0;
+            nToSubmit -= static_cast<unsigned>(nSubmitted);
+            nInFlight += static_cast<unsigned>(nSubmitted);
+            ReapCompletions();
+        }
+
+        // Ranges that could not be submitted.
+        for( unsigned k = 0; k < nBatch; ++k )
+        {
+            if( abDone[k] || ppData == nullptr )
+                continue;
+            const int i = iFirst + static_cast<int>(k);
+            if( VSIUnixPReadAll(fd, ppData[i], panSizes[i], panOffsets[i]) !=
+                    panSizes[i] )
+            {
+                nRet = -1;
+            }
+        }
+
+        iFirst += static_cast<int>(nBatch);
+    }
+    return nRet;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                           ReadMultiRange()                           */
+/************************************************************************/
+
+int VSIUnixStdioHandle::ReadMultiRange( int nRanges, void ** ppData,
+                                        const vsi_l_offset* panOffsets,
+                                        const size_t* panSizes )
+{
+    // Reading directly from the file descriptor is only safe if there
+    // are no pending writes in the stdio buffer.
+    VSIUnixIOURing* poRing =
+        bReadOnly ? VSIUnixIOURing::GetForCurrentThread() : nullptr;
+    if( poRing == nullptr )
+        return VSIVirtualHandle::ReadMultiRange(nRanges, ppData,
+                                                panOffsets, panSizes);
+    return poRing->Run(fileno(fp), nRanges, ppData, panOffsets, panSizes);
+}
+
+/************************************************************************/
+/*                             AdviseRead()                             */
+/************************************************************************/
+
+void VSIUnixStdioHandle::AdviseRead( int nRanges,
+                                     const vsi_l_offset* panOffsets,
+                                     const size_t* panSizes )
+{
+    VSIUnixIOURing* poRing = VSIUnixIOURing::GetForCurrentThread();
+    if( poRing )
+        poRing->Run(fileno(fp), nRanges, nullptr, panOffsets, panSizes);
+}
+
+#endif // VSI_HAVE_IO_URING
+
+/************************************************************************/
+/*                               PRead()                                */
+/************************************************************************/
+
+size_t VSIUnixStdioHandle::PRead( void* pBuffer, size_t nSize,
+                                  vsi_l_offset nOffset ) const
+{
+    return VSIUnixPReadAll(fileno(fp), pBuffer, nSize, nOffset);
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        VSIUnixPReadHandle                            */
+/* ==================================================================== */
+/************************************************************************/
+
+// Read-only handle doing positional reads on a raw file descriptor, and
+// optionally from a memory mapping of the file, bypassing stdio buffering
+// and locking. The handle can be shared between threads that use PRead().
+
+class VSIUnixPReadHandle final : public VSIVirtualHandle
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIUnixPReadHandle)
+
+    int           m_fd = -1;
+    vsi_l_offset  m_nOffset = 0;
+    bool          m_bAtEOF = false;
+    // Mapping of the first m_nMapSize bytes of the file, or nullptr
+    GByte        *m_pabyMap = nullptr;
+    size_t        m_nMapSize = 0;
+    VSIUnixDropBehind m_oDropBehind{};
+
+  public:
+    VSIUnixPReadHandle( int fd, GByte* pabyMap, size_t nMapSize );
+
+    // Pages of the file mapping cannot be evicted while mapped
+    void EnableDropBehind() { m_oDropBehind.bEnabled = m_pabyMap == nullptr; }
+    int GetFD() const { return m_fd; }
+
+    static VSIUnixPReadHandle* Open( const char* pszFilename, bool bMMap );
+
+    int Seek( vsi_l_offset nOffsetIn, int nWhence ) override;
+    vsi_l_offset Tell() override { return m_nOffset; }
+    size_t Read( void *pBuffer, size_t nSize, size_t nMemb ) override;
+    int ReadMultiRange( int nRanges, void ** ppData,
+                        const vsi_l_offset* panOffsets,
+                        const size_t* panSizes ) override;
+#ifdef VSI_HAVE_IO_URING
+    void AdviseRead( int nRanges, const vsi_l_offset* panOffsets,
+                     const size_t* panSizes ) override;
+#endif
+    size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
+    int Eof() override { return m_bAtEOF ? TRUE : FALSE; }
+    int Close() override;
+    void *GetNativeFileDescriptor() override {
+        return reinterpret_cast<void *>(static_cast<size_t>(m_fd)); }
+    VSIRangeStatus GetRangeStatus( vsi_l_offset nOffset,
+                                   vsi_l_offset nLength ) override
+        { return VSIUnixGetRangeStatus(m_fd, nOffset, nLength); }
+    bool HasPRead() const override { return true; }
+    size_t PRead( void* pBuffer, size_t nSize,
+                  vsi_l_offset nOffset ) const override;
+};
+
+/************************************************************************/
+/*                        VSIUnixPReadHandle()                          */
+/************************************************************************/
+
+VSIUnixPReadHandle::VSIUnixPReadHandle( int fd, GByte* pabyMap,
+                                        size_t nMapSize ) :
+    m_fd(fd),
+    m_pabyMap(pabyMap),
+    m_nMapSize(nMapSize)
+{}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+VSIUnixPReadHandle* VSIUnixPReadHandle::Open( const char* pszFilename,
+                                              bool
+#ifdef HAVE_MMAP
+                                                   bMMap
+#endif
+                                            )
+{
+    int nFlags = O_RDONLY;
+#ifdef O_LARGEFILE
+    nFlags |= O_LARGEFILE;
+#endif
+    const int fd = open(pszFilename, nFlags);
+    if( fd < 0 )
+        return nullptr;
+
+    struct VSI_STAT64_T sStat;
+    int nError = 0;
+    if( VSI_FSTAT64(fd, &sStat) != 0 )
+        nError = errno;
+    else if( S_ISDIR(sStat.st_mode) )
+        nError = EISDIR;  // fopen() fails on directories. Do the same.
+    if( nError != 0 )
+    {
+        close(fd);
+        errno = nError;
+        return nullptr;
+    }
+
+    GByte* pabyMap = nullptr;
+    size_t nMapSize = 0;
+#ifdef HAVE_MMAP
+    if( bMMap && S_ISREG(sStat.st_mode) && sStat.st_size > 0 &&
+        static_cast<GUIntBig>(sStat.st_size) <=
+            static_cast<GUIntBig>(std::numeric_limits<size_t>::max()) )
+    {
+        nMapSize = static_cast<size_t>(sStat.st_size);
+        void* pMap = mmap(nullptr, nMapSize, PROT_READ, MAP_SHARED, fd, 0);
+        if( pMap == MAP_FAILED )
+        {
+            CPLDebug("VSI", "mmap() of %s failed: %s. Using pread() instead",
+                     pszFilename, strerror(errno));
+            nMapSize = 0;
+        }
+        else
+        {
+            pabyMap = static_cast<GByte*>(pMap);
+        }
+    }
+#endif
+
+    auto poHandle = new(std::nothrow) VSIUnixPReadHandle(fd, pabyMap, nMapSize);
+    if( poHandle == nullptr )
+    {
+#ifdef HAVE_MMAP
+        if( pabyMap )
+            munmap(pabyMap, nMapSize);
+#endif
+        close(fd);
+    }
+    return poHandle;
+}
+
+/************************************************************************/
+/*                               Close()                                */
+/************************************************************************/
+
+int VSIUnixPReadHandle::Close()
+{
+    VSIDebug1( "VSIUnixPReadHandle::Close(%d)", m_fd );
+
+    m_oDropBehind.Update(m_fd, m_nOffset, true);
+
+#ifdef HAVE_MMAP
+    if( m_pabyMap )
+        munmap(m_pabyMap, m_nMapSize);
+    m_pabyMap = nullptr;
+    m_nMapSize = 0;
+#endif
+    const int nRet = close(m_fd);
+    m_fd = -1;
+    return nRet;
+}
+
+/************************************************************************/
+/*                                Seek()                                */
+/************************************************************************/
+
+int VSIUnixPReadHandle::Seek( vsi_l_offset nOffsetIn, int nWhence )
+{
+    m_bAtEOF = false;
+    if( nWhence == SEEK_SET )
+    {
+        m_nOffset = nOffsetIn;
+    }
+    else if( nWhence == SEEK_CUR )
+    {
+        m_nOffset += nOffsetIn;
+    }
+    else if( nWhence == SEEK_END )
+    {
+        struct VSI_STAT64_T sStat;
+        if( VSI_FSTAT64(m_fd, &sStat) != 0 )
+            return -1;
+        m_nOffset = static_cast<vsi_l_offset>(sStat.st_size) + nOffsetIn;
+    }
+    else
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+/************************************************************************/
+/*                               PRead()                                */
+/************************************************************************/
+
+size_t VSIUnixPReadHandle::PRead( void* pBuffer, size_t nSize,
+                                  vsi_l_offset nOffset ) const
+{
+    size_t nRead = 0;
+    if( nOffset < m_nMapSize )
+    {
+        nRead = std::min(nSize, static_cast<size_t>(m_nMapSize - nOffset));
+        memcpy(pBuffer, m_pabyMap + nOffset, nRead);
+        if( nRead == nSize )
+            return nRead;
+    }
+    // Beyond the mapping, which may happen if the file has grown since
+    // it was opened.
+    return nRead + VSIUnixPReadAll(m_fd, static_cast<GByte*>(pBuffer) + nRead,
+                                   nSize - nRead, nOffset + nRead);
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+size_t VSIUnixPReadHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
+{
+    if( nSize == 0 || nCount == 0 )
+        return 0;
+    if( nCount > std::numeric_limits<size_t>::max() / nSize )
+    {
+        errno = EINVAL;
+        return 0;
+    }
+    const size_t nToRead = nSize * nCount;
+    const size_t nRead = PRead(pBuffer, nToRead, m_nOffset);
+    m_nOffset += nRead;
+    if( nRead < nToRead )
+        m_bAtEOF = true;
+    m_oDropBehind.Update(m_fd, m_nOffset);
+    return nRead / nSize;
+}
+
+/************************************************************************/
+/*                           ReadMultiRange()                           */
+/************************************************************************/
+
+int VSIUnixPReadHandle::ReadMultiRange( int nRanges, void ** ppData,
+                                        const vsi_l_offset* panOffsets,
+                                        const size_t* panSizes )
+{
+#ifdef VSI_HAVE_IO_URING
+    if( m_pabyMap == nullptr )
+    {
+        VSIUnixIOURing* poRing = VSIUnixIOURing::GetForCurrentThread();
+        if( poRing )
+            return poRing->Run(m_fd, nRanges, ppData, panOffsets, panSizes);
+    }
+#endif
+
+#ifdef HAVE_PREADV
+    if( m_pabyMap == nullptr )
+    {
+        // Ranges separated by less than this gap are read with a single
+        // preadv() call, the bytes of the gap going to a scratch buffer.
+        constexpr size_t knMaxGap = 64 * 1024;
+#ifdef IOV_MAX
+        constexpr int knMaxIOV = IOV_MAX;
+#else
+        constexpr int knMaxIOV = 1024;
+#endif
+        std::vector<GByte> abyGap;
+        std::vector<struct iovec> aoIOV;
+        int i = 0;
+        while( i < nRanges )
+        {
+            aoIOV.clear();
+            const vsi_l_offset nStart = panOffsets[i];
+            vsi_l_offset nEnd = nStart;
+            int j = i;
+            for( ; j < nRanges; ++j )
+            {
+                if( j > i )
+                {
+                    if( panOffsets[j] < nEnd ||
+                        panOffsets[j] - nEnd > knMaxGap ||
+                        static_cast<int>(aoIOV.size()) + 2 > knMaxIOV )
+                        break;
+                    const size_t nGap = static_cast<size_t>(panOffsets[j] - nEnd);
+                    if( nGap > 0 )
+                    {
+                        // All gaps share the scratch buffer, which must
+                        // not be reallocated once referenced by aoIOV.
+                        if( abyGap.empty() )
+                            abyGap.resize(knMaxGap);
+                        struct iovec sIOV;
+                        sIOV.iov_base = abyGap.data();
+                        sIOV.iov_len = nGap;
+                        aoIOV.push_back(sIOV);
+                    }
+                }
+                struct iovec sIOV;
+                sIOV.iov_base = ppData[j];
+                sIOV.iov_len = panSizes[j];
+                aoIOV.push_back(sIOV);
+                nEnd = panOffsets[j] + panSizes[j];
+            }
+
+            const size_t nToRead = static_cast<size_t>(nEnd - nStart);
+            ssize_t nRet;
+            do
+            {
+                nRet = VSI_PREADV64(m_fd, aoIOV.data(),
+                                    static_cast<int>(aoIOV.size()),
+                                    static_cast<VSI_OFF64_T>(nStart));
+            } while( nRet < 0 && errno == EINTR );
+            if( nRet < 0 || static_cast<size_t>(nRet) != nToRead )
+            {
+                // Short read: finish range by range
+                for( int k = i; k < j; ++k )
+                {
+                    if( PRead(ppData[k], panSizes[k], panOffsets[k]) != panSizes[k] )
+                        return -1;
+                }
+            }
+            i = j;
+        }
+        return 0;
+    }
+#endif
+
+    for( int i = 0; i < nRanges; ++i )
+    {
+        if( PRead(ppData[i], panSizes[i], panOffsets[i]) != panSizes[i] )
+            return -1;
+    }
+    return 0;
+}
+
+#ifdef VSI_HAVE_IO_URING
+
+/************************************************************************/
+/*                             AdviseRead()                             */
+/************************************************************************/
+
+void VSIUnixPReadHandle::AdviseRead( int nRanges,
+                                     const vsi_l_offset* panOffsets,
+                                     const size_t* panSizes )
+{
+    VSIUnixIOURing* poRing = VSIUnixIOURing::GetForCurrentThread();
+    if( poRing )
+        poRing->Run(m_fd, nRanges, nullptr, panOffsets, panSizes);
+}
+
+#endif
+
+/************************************************************************/
+/*                               Write()                                */
+/************************************************************************/
+
+size_t VSIUnixPReadHandle::Write( const void *, size_t, size_t )
+{
+    errno = EBADF;
+    return 0;
+}
+
+#endif // HAVE_PREAD
+
 /************************************************************************/
 /* ==================================================================== */
 /*                       VSIUnixStdioFilesystemHandler                  */
@@ -606,6 +1491,99 @@ VSIUnixStdioFilesystemHandler::~VSIUnixStdioFilesystemHandler()
 }
 #endif
 
+/************************************************************************/
+/*                       VSIUnixApplyAccessHints()                      */
+/************************************************************************/
+
+// Translates the ACCESS_PATTERN, NOREUSE and WILLNEED open options into
+// posix_fadvise() calls, and returns whether DROP_BEHIND is requested.
+static bool VSIUnixApplyAccessHints( CPL_UNUSED int fd,
+                                     CPL_UNUSED const char* pszFilename,
+                                     CSLConstList papszOptions )
+{
+    if( papszOptions == nullptr )
+        return false;
+
+#ifdef HAVE_POSIX_FADVISE
+    const char* pszAccessPattern =
+        CSLFetchNameValue(papszOptions, "ACCESS_PATTERN");
+    if( pszAccessPattern )
+    {
+        int nAdvice = POSIX_FADV_NORMAL;
+        if( EQUAL(pszAccessPattern, "SEQUENTIAL") )
+            nAdvice = POSIX_FADV_SEQUENTIAL;
+        else if( EQUAL(pszAccessPattern, "RANDOM") )
+            nAdvice = POSIX_FADV_RANDOM;
+        else if( !EQUAL(pszAccessPattern, "NORMAL") )
+        {
+            CPLError(CE_Warning, CPLE_NotSupported,
+                     "Unsupported value for ACCESS_PATTERN: %s",
+                     pszAccessPattern);
+        }
+        if( nAdvice != POSIX_FADV_NORMAL )
+            posix_fadvise(fd, 0, 0, nAdvice);
+    }
+
+#ifdef POSIX_FADV_NOREUSE
+    if( CPLFetchBool(papszOptions, "NOREUSE", false) )
+        posix_fadvise(fd, 0, 0, POSIX_FADV_NOREUSE);
+#endif
+
+    // WILLNEED=offset:size[,offset:size]*, a size of 0 meaning until
+    // the end of file
+    const char* pszWillNeed = CSLFetchNameValue(papszOptions, "WILLNEED");
+    if( pszWillNeed )
+    {
+        const CPLStringList aosRanges(CSLTokenizeString2(pszWillNeed, ",", 0));
+        for( int i = 0; i < aosRanges.size(); ++i )
+        {
+            const CPLStringList aosRange(
+                CSLTokenizeString2(aosRanges[i], ":", 0));
+            // CPLScanUIntBig() would silently turn garbage into 0, and a
+            // 0 size into a read-ahead of the whole file.
+            const auto IsNumber = [](const char* pszVal)
+            {
+                if( *pszVal == '\0' )
+                    return false;
+                for( ; *pszVal; ++pszVal )
+                {
+                    if( *pszVal < '0' || *pszVal > '9' )
+                        return false;
+                }
+                return true;
+            };
+            if( aosRange.size() != 2 ||
+                !IsNumber(aosRange[0]) || !IsNumber(aosRange[1]) )
+            {
+                CPLError(CE_Warning, CPLE_IllegalArg,
+                         "Invalid range in WILLNEED: %s", aosRanges[i]);
+                continue;
+            }
+            posix_fadvise(fd,
+                static_cast<VSI_OFF64_T>(CPLScanUIntBig(aosRange[0],
+                        static_cast<int>(strlen(aosRange[0])))),
+                static_cast<VSI_OFF64_T>(CPLScanUIntBig(aosRange[1],
+                        static_cast<int>(strlen(aosRange[1])))),
+                POSIX_FADV_WILLNEED);
+        }
+    }
+#else
+    static bool bMessageEmitted = false;
+    if( !bMessageEmitted &&
+        (CSLFetchNameValue(papszOptions, "ACCESS_PATTERN") ||
+         CSLFetchNameValue(papszOptions, "NOREUSE") ||
+         CSLFetchNameValue(papszOptions, "WILLNEED") ||
+         CSLFetchNameValue(papszOptions, "DROP_BEHIND")) )
+    {
+        CPLDebug("VSI", "Access hints for %s ignored: posix_fadvise() "
+                 "not available", pszFilename);
+        bMessageEmitted = true;
+    }
+#endif
+
+    return CPLFetchBool(papszOptions, "DROP_BEHIND", false);
+}
+
 /************************************************************************/
 /*                                Open()                                */
 /************************************************************************/
@@ -614,9 +1592,67 @@ VSIVirtualHandle *
 VSIUnixStdioFilesystemHandler::Open( const char *pszFilename,
                                      const char *pszAccess,
                                      bool bSetError,
-                                     CSLConstList /* papszOptions */ )
+                                     CSLConstList papszOptions )
 
 {
+    const bool bReadOnly =
+        strcmp(pszAccess, "rb") == 0 || strcmp(pszAccess, "r") == 0;
+
+/* -------------------------------------------------------------------- */
+/*      Read-only files may be accessed with pread() or mmap() instead  */
+/*      of stdio.                                                       */
+/* -------------------------------------------------------------------- */
+    const char* pszIOMethod = bReadOnly ?
+        CSLFetchNameValueDef(papszOptions, "IO_METHOD",
+                             CPLGetConfigOption("VSI_LOCAL_IO_METHOD",
+                                                "STDIO")) : "STDIO";
+    if( EQUAL(pszIOMethod, "PREAD") || EQUAL(pszIOMethod, "MMAP") )
+    {
+#ifdef HAVE_PREAD
+        VSIUnixPReadHandle* poHandle =
+            VSIUnixPReadHandle::Open(pszFilename, EQUAL(pszIOMethod, "MMAP"));
+        const int nError = errno;
+
+        VSIDebug3( "VSIUnixStdioFilesystemHandler::Open(\"%s\",\"%s\") = %p",
+                   pszFilename, pszAccess, poHandle );
+
+        if( poHandle == nullptr )
+        {
+            if( bSetError )
+            {
+                VSIError(VSIE_FileError, "%s: %s", pszFilename, strerror(nError));
+            }
+            errno = nError;
+            return nullptr;
+        }
+
+        if( VSIUnixApplyAccessHints(poHandle->GetFD(), pszFilename,
+                                    papszOptions) )
+        {
+            poHandle->EnableDropBehind();
+        }
+
+        if( CPLTestBool( CPLGetConfigOption( "VSI_CACHE", "FALSE" ) ) )
+        {
+            return VSICreateCachedFile( poHandle );
+        }
+        return poHandle;
+#else
+        static bool bMessageEmitted = false;
+        if( !bMessageEmitted )
+        {
+            CPLDebug("VSI", "IO_METHOD=%s not supported on this platform. "
+                     "Using STDIO", pszIOMethod);
+            bMessageEmitted = true;
+        }
+#endif
+    }
+    else if( !EQUAL(pszIOMethod, "STDIO") )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "Unsupported value for IO_METHOD: %s", pszIOMethod);
+    }
+
     FILE *fp = VSI_FOPEN64( pszFilename, pszAccess );
     const int nError = errno;
 
@@ -633,8 +1669,6 @@ VSIUnixStdioFilesystemHandler::Open( const char *pszFilename,
         return nullptr;
     }
 
-    const bool bReadOnly =
-        strcmp(pszAccess, "rb") == 0 || strcmp(pszAccess, "r") == 0;
     const bool bModeAppendReadWrite =
         strcmp(pszAccess, "a+b") == 0 || strcmp(pszAccess, "a+") == 0;
     VSIUnixStdioHandle *poHandle =
@@ -646,6 +1680,9 @@ VSIUnixStdioFilesystemHandler::Open( const char *pszFilename,
         return nullptr;
     }
 
+    if( VSIUnixApplyAccessHints(fileno(fp), pszFilename, papszOptions) )
+        poHandle->EnableDropBehind();
+
     errno = nError;
 
 /* -------------------------------------------------------------------- */
@@ -863,6 +1900,20 @@ int VSIUnixStdioFilesystemHandler::SupportsSparseFiles( const char*
 #endif
 }
 
+/************************************************************************/
+/*                     HasOptimizedReadMultiRange()                     */
+/************************************************************************/
+
+int VSIUnixStdioFilesystemHandler::HasOptimizedReadMultiRange(
+                                                const char* /* pszPath */ )
+{
+#ifdef VSI_HAVE_IO_URING
+    return VSIUnixIOURing::GetForCurrentThread() != nullptr;
+#else
+    return FALSE;
+#endif
+}
+
 #ifdef VSI_COUNT_BYTES_READ
 /************************************************************************/
 /*                            AddToTotal()                              */
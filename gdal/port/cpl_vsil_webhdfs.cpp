@@ -116,7 +116,8 @@ class VSIWebHDFSHandle final : public VSICurlHandle
     CPLString       m_osUsernameParam{};
     CPLString       m_osDelegationParam{};
 
-   std::string      DownloadRegion(vsi_l_offset startOffset, int nBlocks) override;
+   std::vector<std::shared_ptr<VSICurlSlab>>
+                    DownloadRegion(vsi_l_offset startOffset, int nBlocks) override;
 
   public:
     VSIWebHDFSHandle( VSIWebHDFSFSHandler* poFS,
@@ -1035,15 +1036,16 @@ vsi_l_offset VSIWebHDFSHandle::GetFileSize( bool bSetError )
 /*                          DownloadRegion()                            */
 /************************************************************************/
 
-std::string VSIWebHDFSHandle::DownloadRegion( const vsi_l_offset startOffset,
-                                              const int nBlocks )
+std::vector<std::shared_ptr<VSICurlSlab>>
+VSIWebHDFSHandle::DownloadRegion( const vsi_l_offset startOffset,
+                                  const int nBlocks )
 {
     if( bInterrupted && bStopOnInterruptUntilUninstall )
-        return std::string();
+        return {};
 
     poFS->GetCachedFileProp(m_pszURL, oFileProp);
     if( oFileProp.eExists == EXIST_NO )
-        return std::string();
+        return {};
 
     NetworkStatisticsFileSystem oContextFS(poFS->GetFSPrefix());
     NetworkStatisticsFile oContextFile(m_osFilename);
@@ -1066,6 +1068,8 @@ retry:
     VSICURLInitWriteFuncStruct(&sWriteFuncData,
                                reinterpret_cast<VSILFILE *>(this),
                                pfnReadCbk, pReadCbkUserData);
+    sWriteFuncData.poSlabPool = &poFS->GetSlabPool();
+    sWriteFuncData.nSlabSize = VSICURLGetDownloadChunkSize();
     curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &sWriteFuncData);
     curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
                      VSICurlHandleWriteFunc);
@@ -1111,7 +1115,7 @@ retry:
         CPLFree(sWriteFuncData.pBuffer);
         curl_easy_cleanup(hCurlHandle);
 
-        return std::string();
+        return {};
     }
 
     long response_code = 0;
@@ -1180,23 +1184,17 @@ retry:
         }
         CPLFree(sWriteFuncData.pBuffer);
         curl_easy_cleanup(hCurlHandle);
-        return std::string();
+        return {};
     }
 
     oFileProp.eExists = EXIST_YES;
     poFS->SetCachedFileProp(m_pszURL, oFileProp);
 
-    DownloadRegionPostProcess(startOffset, nBlocks,
-                              sWriteFuncData.pBuffer,
-                              sWriteFuncData.nSize);
+    DownloadRegionPostProcess(startOffset, nBlocks, sWriteFuncData.apoSlabs);
 
-    std::string osRet;
-    osRet.assign(sWriteFuncData.pBuffer, sWriteFuncData.nSize);
-
-    CPLFree(sWriteFuncData.pBuffer);
     curl_easy_cleanup(hCurlHandle);
 
-    return osRet;
+    return std::move(sWriteFuncData.apoSlabs);
 }
 
 
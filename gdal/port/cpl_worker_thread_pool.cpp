@@ -29,8 +29,10 @@
 #include "cpl_port.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <new>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -39,11 +41,9 @@
 
 CPL_CVSID("$Id$")
 
-struct CPLWorkerThreadJob
-{
-    CPLThreadFunc  pfnFunc;
-    void          *pData;
-};
+// Worker thread running the current job, if any. Used so that jobs
+// submitted from a job are queued on the thread that submitted them.
+static thread_local CPLWorkerThread* tlsCurrentWorkerThread = nullptr;
 
 /************************************************************************/
 /*                         CPLWorkerThreadPool()                        */
@@ -83,8 +83,6 @@ CPLWorkerThreadPool::~CPLWorkerThreadPool()
         }
         CPLJoinThread(wt->hThread);
     }
-
-    CPLListDestroy(psWaitingWorkerThreadsList);
 }
 
 /************************************************************************/
@@ -99,88 +97,110 @@ void CPLWorkerThreadPool::WorkerThreadFunction(void* user_data)
     if( psWT->pfnInitFunc )
         psWT->pfnInitFunc( psWT->pInitData );
 
-    while( true )
-    {
-        CPLWorkerThreadJob* psJob = poTP->GetNextJob(psWT);
-        if( psJob == nullptr )
-            break;
+    tlsCurrentWorkerThread = psWT;
 
-        if( psJob->pfnFunc )
+    CPLWorkerThreadJob sJob;
+    while( poTP->GetNextJob(psWT, sJob) )
+    {
+        if( sJob.pfnFunc )
         {
-            psJob->pfnFunc(psJob->pData);
+            sJob.pfnFunc(sJob.pData);
         }
-        CPLFree(psJob);
 #if DEBUG_VERBOSE
         CPLDebug("JOB", "%p finished a job", psWT);
 #endif
         poTP->DeclareJobFinished();
     }
+
+    tlsCurrentWorkerThread = nullptr;
 }
 
 /************************************************************************/
-/*                             SubmitJob()                              */
+/*                         GetQueueForNewJob()                          */
 /************************************************************************/
 
-/** Queue a new job.
- *
- * @param pfnFunc Function to run for the job.
- * @param pData User data to pass to the job function.
- * @return true in case of success.
- */
-bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+// Jobs submitted by a worker thread of this pool go to its own queue, so
+// that it runs them itself unless an idle thread steals them. Other jobs
+// are spread over the queues in a round-robin way.
+CPLWorkerThread* CPLWorkerThreadPool::GetQueueForNewJob()
 {
-    CPLAssert( !aWT.empty() );
-
-    CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob *>(
-        VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
-    if( psJob == nullptr )
-        return false;
-    psJob->pfnFunc = pfnFunc;
-    psJob->pData = pData;
+    CPLWorkerThread* psCurWT = tlsCurrentWorkerThread;
+    if( psCurWT != nullptr && psCurWT->poTP == this )
+        return psCurWT;
 
-    CPLList* psItem =
-        static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-    if( psItem == nullptr )
-    {
-        VSIFree(psJob);
-        return false;
-    }
-    psItem->pData = psJob;
+    const auto papoThreads = m_papoThreads.load();
+    return (*papoThreads)[m_nNextQueue++ % papoThreads->size()];
+}
 
-    std::unique_lock<std::mutex> oGuard(m_mutex);
+/************************************************************************/
+/*                    WakeUpWaitingWorkerThreads()                      */
+/************************************************************************/
 
-    psItem->psNext = psJobQueue;
-    psJobQueue = psItem;
-    nPendingJobs++;
+void CPLWorkerThreadPool::WakeUpWaitingWorkerThreads(size_t nMaxThreads)
+{
+    // Called after incrementing nQueuedJobs. Pairs with the increment of
+    // nWaitingWorkerThreads in GetNextJob(), which checks nQueuedJobs
+    // afterwards: either the worker finds the new jobs, or we see it as
+    // waiting.
+    if( nWaitingWorkerThreads.load() == 0 )
+        return;
 
-    if( psWaitingWorkerThreadsList )
+    std::unique_lock<std::mutex> oGuard(m_mutex);
+    for( size_t i = 0; i < nMaxThreads && !apoWaitingWorkerThreads.empty();
+         i++ )
     {
-        CPLWorkerThread* psWorkerThread =
-            static_cast<CPLWorkerThread *>(psWaitingWorkerThreadsList->pData);
+        CPLWorkerThread* psWorkerThread = apoWaitingWorkerThreads.back();
+        apoWaitingWorkerThreads.pop_back();
+        nWaitingWorkerThreads--;
 
         CPLAssert( psWorkerThread->bMarkedAsWaiting );
         psWorkerThread->bMarkedAsWaiting = false;
 
-        CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-        CPLList* psToFree = psWaitingWorkerThreadsList;
-        psWaitingWorkerThreadsList = psNext;
-        nWaitingWorkerThreads--;
-
-        // CPLAssert(
-        //   CPLListCount(psWaitingWorkerThreadsList) == nWaitingWorkerThreads);
-
 #if DEBUG_VERBOSE
         CPLDebug("JOB", "Waking up %p", psWorkerThread);
 #endif
 
-        {
-            std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
-            oGuard.unlock();
-            psWorkerThread->m_cv.notify_one();
-        }
+        std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
+        psWorkerThread->m_cv.notify_one();
+    }
+}
+
+/************************************************************************/
+/*                             SubmitJob()                              */
+/************************************************************************/
 
-        CPLFree(psToFree);
+/** Queue a new job.
+ *
+ * @param pfnFunc Function to run for the job.
+ * @param pData User data to pass to the job function.
+ * @return true in case of success.
+ */
+bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+{
+    CPLAssert( !aWT.empty() );
+
+    CPLWorkerThreadJob sJob;
+    sJob.pfnFunc = pfnFunc;
+    sJob.pData = pData;
+
+    CPLWorkerThread* psWT = GetQueueForNewJob();
+    nPendingJobs++;
+    try
+    {
+        std::lock_guard<std::mutex> oGuard(psWT->m_queueMutex);
+        psWT->m_queue.push_back(sJob);
+        psWT->m_nQueueSize++;
     }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot queue job");
+        DeclareJobFinished();
+        return false;
+    }
+    nQueuedJobs++;
+
+    WakeUpWaitingWorkerThreads(1);
+    WakeUpHelpingWorkerThreads();
 
     return true;
 }
@@ -200,88 +220,49 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
 {
     CPLAssert( !aWT.empty() );
 
-    std::unique_lock<std::mutex> oGuard(m_mutex);
+    if( apData.empty() )
+        return true;
 
-    CPLList* psJobQueueInit = psJobQueue;
-    bool bRet = true;
+    // Split the jobs in contiguous batches, one per queue.
+    const auto papoThreads = m_papoThreads.load();
+    CPLWorkerThread* psCurWT = tlsCurrentWorkerThread;
+    const size_t nQueues =
+        (psCurWT != nullptr && psCurWT->poTP == this) ? 1 :
+            std::min(apData.size(), papoThreads->size());
+    const size_t nBatchSize = (apData.size() + nQueues - 1) / nQueues;
 
-    for(size_t i=0;i<apData.size();i++)
+    nPendingJobs += static_cast<int>(apData.size());
+    size_t iJob = 0;
+    try
     {
-        CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob*>(
-            VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
-        if( psJob == nullptr )
+        for( size_t iQueue = 0; iQueue < nQueues; iQueue++ )
         {
-            bRet = false;
-            break;
-        }
-        psJob->pfnFunc = pfnFunc;
-        psJob->pData = apData[i];
-
-        CPLList* psItem =
-            static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-        if( psItem == nullptr )
-        {
-            VSIFree(psJob);
-            bRet = false;
-            break;
+            CPLWorkerThread* psWT = GetQueueForNewJob();
+            std::lock_guard<std::mutex> oGuard(psWT->m_queueMutex);
+            const size_t nEnd = std::min(apData.size(), iJob + nBatchSize);
+            for( ; iJob < nEnd; iJob++ )
+            {
+                CPLWorkerThreadJob sJob;
+                sJob.pfnFunc = pfnFunc;
+                sJob.pData = apData[iJob];
+                psWT->m_queue.push_back(sJob);
+                psWT->m_nQueueSize++;
+                nQueuedJobs++;
+            }
         }
-        psItem->pData = psJob;
-
-        psItem->psNext = psJobQueue;
-        psJobQueue = psItem;
-        nPendingJobs++;
     }
-
-    if( !bRet )
+    catch( const std::bad_alloc& )
     {
-        for( CPLList* psIter = psJobQueue; psIter != psJobQueueInit; )
-        {
-            CPLList* psNext = psIter->psNext;
-            VSIFree(psIter->pData);
-            VSIFree(psIter);
-            nPendingJobs--;
-            psIter = psNext;
-        }
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot queue jobs");
+        // Jobs already queued will still be run.
+        nPendingJobs -= static_cast<int>(apData.size() - iJob);
+        WakeUpWaitingWorkerThreads(iJob);
+        WakeUpHelpingWorkerThreads();
         return false;
     }
 
-    for(size_t i=0;i<apData.size();i++)
-    {
-        if( psWaitingWorkerThreadsList && psJobQueue )
-        {
-            CPLWorkerThread* psWorkerThread;
-
-            psWorkerThread = static_cast<CPLWorkerThread*>(psWaitingWorkerThreadsList->pData);
-
-            CPLAssert( psWorkerThread->bMarkedAsWaiting );
-            psWorkerThread->bMarkedAsWaiting = false;
-
-            CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-            CPLList* psToFree = psWaitingWorkerThreadsList;
-            psWaitingWorkerThreadsList = psNext;
-            nWaitingWorkerThreads--;
-
-            // CPLAssert(
-            //    CPLListCount(psWaitingWorkerThreadsList) ==
-            //    nWaitingWorkerThreads);
-
-#if DEBUG_VERBOSE
-            CPLDebug("JOB", "Waking up %p", psWorkerThread);
-#endif
-            {
-                std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
-                oGuard.unlock();
-                psWorkerThread->m_cv.notify_one();
-            }
-
-            CPLFree(psToFree);
-            oGuard.lock();
-        }
-        else
-        {
-            break;
-        }
-    }
+    WakeUpWaitingWorkerThreads(apData.size());
+    WakeUpHelpingWorkerThreads();
 
     return true;
 }
@@ -291,6 +272,9 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
 /************************************************************************/
 
 /** Wait for completion of part or whole jobs.
+ *
+ * When called from a job running in this pool, the calling thread runs
+ * pending jobs while it waits. The calling job itself counts as pending.
  *
  * @param nMaxRemainingJobs Maximum number of pendings jobs that are allowed
  *                          in the queue after this method has completed. Might be
@@ -300,10 +284,51 @@ void CPLWorkerThreadPool::WaitCompletion(int nMaxRemainingJobs)
 {
     if( nMaxRemainingJobs < 0 )
         nMaxRemainingJobs = 0;
-    std::unique_lock<std::mutex> oGuard(m_mutex);
-    while( nPendingJobs > nMaxRemainingJobs )
+    WaitUntil([this, nMaxRemainingJobs]()
+              { return nPendingJobs <= nMaxRemainingJobs; });
+}
+
+/************************************************************************/
+/*                              WaitUntil()                             */
+/************************************************************************/
+
+// Wait until IsDone() returns true. IsDone() must only become true as the
+// result of a job of this pool, or of code running in one, so that we are
+// woken up by DeclareJobFinished().
+// A worker thread of this pool does not block while there are queued jobs:
+// it runs them instead, so that a job can wait for jobs it submitted
+// without deadlocking the pool, even if all threads do the same.
+void CPLWorkerThreadPool::WaitUntil(const std::function<bool()>& IsDone)
+{
+    CPLWorkerThread* psWT = tlsCurrentWorkerThread;
+    if( psWT != nullptr && psWT->poTP != this )
+        psWT = nullptr;
+
+    while( !IsDone() )
     {
-        m_cv.wait(oGuard);
+        CPLWorkerThreadJob sJob;
+        if( psWT != nullptr && TryGetJob(psWT, sJob) )
+        {
+#if DEBUG_VERBOSE
+            CPLDebug("JOB", "%p runs a job while waiting", psWT);
+#endif
+            if( sJob.pfnFunc )
+                sJob.pfnFunc(sJob.pData);
+            DeclareJobFinished();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> oGuard(m_mutex);
+        nWaitingForJobsCompletion++;
+        if( psWT != nullptr )
+            nHelpingWorkerThreads++;
+        // Pairs with WakeUpJobWaiters() and WakeUpHelpingWorkerThreads():
+        // a job finished or queued after this check will notify us.
+        if( !IsDone() && (psWT == nullptr || nQueuedJobs.load() == 0) )
+            m_cv.wait(oGuard);
+        if( psWT != nullptr )
+            nHelpingWorkerThreads--;
+        nWaitingForJobsCompletion--;
     }
 }
 
@@ -316,19 +341,13 @@ void CPLWorkerThreadPool::WaitCompletion(int nMaxRemainingJobs)
 void CPLWorkerThreadPool::WaitEvent()
 {
     std::unique_lock<std::mutex> oGuard(m_mutex);
-    while( true )
+    nWaitingForJobsCompletion++;
+    const int nPendingJobsBefore = nPendingJobs;
+    while( nPendingJobsBefore > 0 && nPendingJobs >= nPendingJobsBefore )
     {
-        const int nPendingJobsBefore = nPendingJobs;
-        if( nPendingJobsBefore == 0 )
-        {
-            break;
-        }
         m_cv.wait(oGuard);
-        if( nPendingJobs < nPendingJobsBefore )
-        {
-            break;
-        }
     }
+    nWaitingForJobsCompletion--;
 }
 
 /************************************************************************/
@@ -385,6 +404,21 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
         aWT.emplace_back(std::move(wt));
     }
 
+    {
+        // Publish the new list of queues. Concurrent submitters may still
+        // use the previous one, which is why it is not freed.
+        std::unique_ptr<std::vector<CPLWorkerThread*>> papoThreads(
+            new std::vector<CPLWorkerThread*>());
+        for( auto& wt: aWT )
+            papoThreads->push_back(wt.get());
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        if( !papoThreads->empty() )
+        {
+            m_papoThreads = papoThreads.get();
+            m_apoThreadSnapshots.emplace_back(std::move(papoThreads));
+        }
+    }
+
     if( bWaitallStarted )
     {
         // Wait all threads to be started
@@ -407,66 +441,154 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
 
 void CPLWorkerThreadPool::DeclareJobFinished()
 {
-    std::lock_guard<std::mutex> oGuard(m_mutex);
     nPendingJobs --;
-    m_cv.notify_one();
+    WakeUpJobWaiters();
 }
 
 /************************************************************************/
-/*                             GetNextJob()                             */
+/*                          WakeUpJobWaiters()                          */
 /************************************************************************/
 
-CPLWorkerThreadJob *
-CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
+void CPLWorkerThreadPool::WakeUpJobWaiters()
 {
-    while(true)
+    // Pairs with the increment of nWaitingForJobsCompletion, done before
+    // checking the wait condition, in WaitUntil() and WaitEvent().
+    if( nWaitingForJobsCompletion.load() > 0 )
     {
-        std::unique_lock<std::mutex> oGuard(m_mutex);
-        if( eState == CPLWTS_STOP )
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        m_cv.notify_all();
+    }
+}
+
+/************************************************************************/
+/*                    WakeUpHelpingWorkerThreads()                      */
+/************************************************************************/
+
+void CPLWorkerThreadPool::WakeUpHelpingWorkerThreads()
+{
+    // Called after incrementing nQueuedJobs. Pairs with the increment of
+    // nHelpingWorkerThreads in WaitUntil(), which checks nQueuedJobs
+    // afterwards.
+    if( nHelpingWorkerThreads.load() > 0 )
+    {
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        m_cv.notify_all();
+    }
+}
+
+/************************************************************************/
+/*                             TryGetJob()                              */
+/************************************************************************/
+
+bool CPLWorkerThreadPool::TryGetJob( CPLWorkerThread* psWorkerThread,
+                                     CPLWorkerThreadJob& sJob )
+{
+    if( nQueuedJobs.load() == 0 )
+        return false;
+
+    const auto PopJob = [this, &sJob](CPLWorkerThread* psWT)
+    {
+        // Cheap check to skip empty queues without locking them
+        if( psWT->m_nQueueSize.load(std::memory_order_relaxed) == 0 )
+            return false;
+        std::lock_guard<std::mutex> oGuard(psWT->m_queueMutex);
+        if( psWT->m_queue.empty() )
+            return false;
+        sJob = psWT->m_queue.front();
+        psWT->m_queue.pop_front();
+        psWT->m_nQueueSize--;
+        nQueuedJobs--;
+        return true;
+    };
+
+    if( PopJob(psWorkerThread) )
+        return true;
+
+    // Steal from the other threads, starting with our successor so that
+    // idle threads do not all compete for the same queue.
+    const auto papoThreads = m_papoThreads.load();
+    if( papoThreads == nullptr )
+        return false;
+    const size_t nThreads = papoThreads->size();
+    size_t iStart = 0;
+    while( iStart < nThreads && (*papoThreads)[iStart] != psWorkerThread )
+        iStart++;
+    for( size_t i = 1; i <= nThreads; i++ )
+    {
+        CPLWorkerThread* psVictim = (*papoThreads)[(iStart + i) % nThreads];
+        if( psVictim != psWorkerThread && PopJob(psVictim) )
         {
-            return nullptr;
+#if DEBUG_VERBOSE
+            CPLDebug("JOB", "%p stole a job from %p",
+                     psWorkerThread, psVictim);
+#endif
+            return true;
         }
-        CPLList* psTopJobIter = psJobQueue;
-        if( psTopJobIter )
-        {
-            psJobQueue = psTopJobIter->psNext;
+    }
+    return false;
+}
 
+/************************************************************************/
+/*                             GetNextJob()                             */
+/************************************************************************/
+
+bool CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread,
+                                      CPLWorkerThreadJob& sJob )
+{
+    if( TryGetJob(psWorkerThread, sJob) )
+    {
 #if DEBUG_VERBOSE
-            CPLDebug("JOB", "%p got a job", psWorkerThread);
+        CPLDebug("JOB", "%p got a job", psWorkerThread);
 #endif
-            CPLWorkerThreadJob* psJob =
-                static_cast<CPLWorkerThreadJob*>(psTopJobIter->pData);
-            CPLFree(psTopJobIter);
-            return psJob;
+        return true;
+    }
+
+    while(true)
+    {
+        std::unique_lock<std::mutex> oGuard(m_mutex);
+        if( eState == CPLWTS_STOP )
+        {
+            return false;
         }
 
         if( !psWorkerThread->bMarkedAsWaiting )
         {
-            psWorkerThread->bMarkedAsWaiting = true;
-            nWaitingWorkerThreads++;
-
-            CPLList* psItem =
-                static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-            if( psItem == nullptr )
+            try
+            {
+                apoWaitingWorkerThreads.push_back(psWorkerThread);
+            }
+            catch( const std::bad_alloc& )
             {
                 eState = CPLWTS_ERROR;
-                m_cv.notify_one();
+                m_cv.notify_all();
 
-                return nullptr;
+                return false;
             }
+            psWorkerThread->bMarkedAsWaiting = true;
+            nWaitingWorkerThreads++;
+        }
 
-            psItem->pData = psWorkerThread;
-            psItem->psNext = psWaitingWorkerThreadsList;
-            psWaitingWorkerThreadsList = psItem;
+        m_cv.notify_all();
 
+        // Check again now that we are seen as waiting, as a job may have
+        // been queued in between. This also handles being woken up.
+        if( TryGetJob(psWorkerThread, sJob) )
+        {
+            if( psWorkerThread->bMarkedAsWaiting )
+            {
+                psWorkerThread->bMarkedAsWaiting = false;
+                apoWaitingWorkerThreads.erase(
+                    std::find(apoWaitingWorkerThreads.begin(),
+                              apoWaitingWorkerThreads.end(),
+                              psWorkerThread));
+                nWaitingWorkerThreads--;
+            }
 #if DEBUG_VERBOSE
-            CPLAssert(CPLListCount(psWaitingWorkerThreadsList) ==
-                      nWaitingWorkerThreads);
+            CPLDebug("JOB", "%p got a job", psWorkerThread);
 #endif
+            return true;
         }
 
-        m_cv.notify_one();
-
 #if DEBUG_VERBOSE
         CPLDebug("JOB", "%p sleeping", psWorkerThread);
 #endif
@@ -522,6 +644,22 @@ struct JobQueueJob
     void* pData = nullptr;
 };
 
+/************************************************************************/
+/*                          CPLJobQueueTask                             */
+/************************************************************************/
+
+struct CPLJobQueueTask
+{
+    CPLJobQueue* poQueue = nullptr;
+    CPLThreadFunc pfnFunc = nullptr;
+    void* pData = nullptr;
+
+    // Members below are protected by the mutex of the job queue
+    int nRemainingDependencies = 0;
+    bool bFinished = false;
+    std::vector<CPLJobTaskHandle> ahContinuations{};
+};
+
 /************************************************************************/
 /*                          JobQueueFunction()                          */
 /************************************************************************/
@@ -534,15 +672,66 @@ void CPLJobQueue::JobQueueFunction(void* pData)
     delete poJob;
 }
 
+/************************************************************************/
+/*                            TaskFunction()                            */
+/************************************************************************/
+
+void CPLJobQueue::TaskFunction(void* pData)
+{
+    std::unique_ptr<CPLJobTaskHandle> phTask(
+        static_cast<CPLJobTaskHandle*>(pData));
+    CPLJobQueueTask* psTask = phTask->get();
+    psTask->pfnFunc(psTask->pData);
+    psTask->poQueue->DeclareTaskFinished(*phTask);
+}
+
 /************************************************************************/
 /*                          DeclareJobFinished()                        */
 /************************************************************************/
 
 void CPLJobQueue::DeclareJobFinished()
 {
-    std::lock_guard<std::mutex> oGuard(m_mutex);
-    m_nPendingJobs --;
-    m_cv.notify_one();
+    // The queue may be destroyed as soon as the mutex is released.
+    CPLWorkerThreadPool* poPool = m_poPool;
+    {
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        m_nPendingJobs --;
+    }
+    // Waiters are normally woken up when the pool job running this
+    // function finishes, but this might not be run from a pool job.
+    poPool->WakeUpJobWaiters();
+}
+
+/************************************************************************/
+/*                         DeclareTaskFinished()                        */
+/************************************************************************/
+
+void CPLJobQueue::DeclareTaskFinished(const CPLJobTaskHandle& hTask)
+{
+    std::vector<CPLJobTaskHandle> ahReadyTasks;
+    {
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        hTask->bFinished = true;
+        for( const auto& hContinuation: hTask->ahContinuations )
+        {
+            if( --hContinuation->nRemainingDependencies == 0 )
+                ahReadyTasks.push_back(hContinuation);
+        }
+        hTask->ahContinuations.clear();
+    }
+
+    // Continuations are queued before the task is declared finished, so
+    // that WaitCompletion() cannot see the queue as momentarily empty.
+    for( const auto& hReadyTask: ahReadyTasks )
+    {
+        if( !SubmitReadyTask(hReadyTask) )
+        {
+            // Running it here is better than never running it.
+            TaskFunction(new CPLJobTaskHandle(hReadyTask));
+        }
+    }
+
+    DeclareJobFinished();
 }
 
 /************************************************************************/
@@ -569,15 +758,115 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
     if( !bRet )
     {
         delete poJob;
+        DeclareJobFinished();
     }
     return bRet;
 }
 
+/************************************************************************/
+/*                          SubmitReadyTask()                           */
+/************************************************************************/
+
+bool CPLJobQueue::SubmitReadyTask(const CPLJobTaskHandle& hTask)
+{
+    CPLJobTaskHandle* phTask = new CPLJobTaskHandle(hTask);
+    if( !m_poPool->SubmitJob(TaskFunction, phTask) )
+    {
+        delete phTask;
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             SubmitTask()                             */
+/************************************************************************/
+
+/** Queue a new task, that will be run once all its dependencies are
+ * finished.
+ *
+ * Contrary to SubmitJob(), the returned handle can be passed as a
+ * dependency of other tasks, or waited for with WaitTask(). This allows
+ * expressing pipelines, such as a download task followed by a
+ * decompression task, on the threads of a single pool. A task can submit
+ * other tasks and wait for them: the waiting thread runs pending jobs in
+ * the meantime.
+ *
+ * The task counts as a pending job of the queue as soon as this method
+ * returns, even if it is not runnable yet.
+ *
+ * @param pfnFunc Function to run for the task.
+ * @param pData User data to pass to the task function.
+ * @param ahDependencies Tasks of this queue that must be finished before
+ *                       this task starts. Null handles are ignored.
+ * @return a task handle, or null in case of error.
+ * @since GDAL 3.4
+ */
+CPLJobTaskHandle CPLJobQueue::SubmitTask(
+                        CPLThreadFunc pfnFunc, void* pData,
+                        const std::vector<CPLJobTaskHandle>& ahDependencies)
+{
+    CPLJobTaskHandle hTask;
+    int nRemainingDependencies = 0;
+    try
+    {
+        hTask = std::make_shared<CPLJobQueueTask>();
+        hTask->poQueue = this;
+        hTask->pfnFunc = pfnFunc;
+        hTask->pData = pData;
+
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        for( const auto& hDependency: ahDependencies )
+        {
+            if( hDependency == nullptr || hDependency->bFinished )
+                continue;
+            CPLAssert( hDependency->poQueue == this );
+            hDependency->ahContinuations.push_back(hTask);
+            hTask->nRemainingDependencies++;
+        }
+        nRemainingDependencies = hTask->nRemainingDependencies;
+        m_nPendingJobs ++;
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot queue task");
+        if( hTask )
+        {
+            std::lock_guard<std::mutex> oGuard(m_mutex);
+            for( const auto& hDependency: ahDependencies )
+            {
+                if( hDependency == nullptr )
+                    continue;
+                auto& ahContinuations = hDependency->ahContinuations;
+                ahContinuations.erase(
+                    std::remove(ahContinuations.begin(),
+                                ahContinuations.end(), hTask),
+                    ahContinuations.end());
+            }
+        }
+        return nullptr;
+    }
+
+    // If all dependencies were already finished, the task is runnable now.
+    // Otherwise, the last dependency to finish will queue it.
+    if( nRemainingDependencies == 0 && !SubmitReadyTask(hTask) )
+    {
+        DeclareJobFinished();
+        return nullptr;
+    }
+
+    return hTask;
+}
+
 /************************************************************************/
 /*                            WaitCompletion()                          */
 /************************************************************************/
 
 /** Wait for completion of part or whole jobs.
+ *
+ * When called from a job running in the pool of this queue, the calling
+ * thread runs pending jobs while it waits. If that job belongs to this
+ * queue, it counts as pending itself.
  *
  * @param nMaxRemainingJobs Maximum number of pendings jobs that are allowed
  *                          in the queue after this method has completed. Might be
@@ -585,9 +874,42 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
  */
 void CPLJobQueue::WaitCompletion(int nMaxRemainingJobs)
 {
-    std::unique_lock<std::mutex> oGuard(m_mutex);
-    while( m_nPendingJobs > nMaxRemainingJobs )
+    m_poPool->WaitUntil([this, nMaxRemainingJobs]()
     {
-        m_cv.wait(oGuard);
-    }
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        return m_nPendingJobs <= nMaxRemainingJobs;
+    });
+}
+
+/************************************************************************/
+/*                           IsTaskFinished()                           */
+/************************************************************************/
+
+/** Return whether a task submitted with SubmitTask() is finished.
+ *
+ * @param hTask Task handle.
+ * @since GDAL 3.4
+ */
+bool CPLJobQueue::IsTaskFinished(const CPLJobTaskHandle& hTask)
+{
+    std::lock_guard<std::mutex> oGuard(m_mutex);
+    return hTask->bFinished;
+}
+
+/************************************************************************/
+/*                              WaitTask()                              */
+/************************************************************************/
+
+/** Wait for completion of a task submitted with SubmitTask().
+ *
+ * When called from a job running in the pool of this queue, the calling
+ * thread runs pending jobs while it waits, so a task may wait for tasks
+ * that it submitted. It must not wait for a task that depends on it.
+ *
+ * @param hTask Task handle.
+ * @since GDAL 3.4
+ */
+void CPLJobQueue::WaitTask(const CPLJobTaskHandle& hTask)
+{
+    m_poPool->WaitUntil([this, &hTask]() { return IsTaskFinished(hTask); });
 }
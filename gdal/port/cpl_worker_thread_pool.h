@@ -31,9 +31,11 @@
 #define CPL_WORKER_THREAD_POOL_H_INCLUDED_
 
 #include "cpl_multiproc.h"
-#include "cpl_list.h"
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -46,9 +48,14 @@
  */
 
 #ifndef DOXYGEN_SKIP
-struct CPLWorkerThreadJob;
 class CPLWorkerThreadPool;
 
+struct CPLWorkerThreadJob
+{
+    CPLThreadFunc  pfnFunc = nullptr;
+    void          *pData = nullptr;
+};
+
 struct CPLWorkerThread
 {
     CPL_DISALLOW_COPY_ASSIGN(CPLWorkerThread)
@@ -62,6 +69,11 @@ struct CPLWorkerThread
 
     std::mutex              m_mutex{};
     std::condition_variable m_cv{};
+
+    // Jobs queued on this thread. Idle threads steal from it.
+    std::mutex              m_queueMutex{};
+    std::deque<CPLWorkerThreadJob> m_queue{};
+    std::atomic<int>        m_nQueueSize{0};
 };
 
 typedef enum
@@ -83,16 +95,38 @@ class CPL_DLL CPLWorkerThreadPool
         std::mutex              m_mutex{};
         std::condition_variable m_cv{};
         volatile CPLWorkerThreadState eState = CPLWTS_OK;
-        CPLList* psJobQueue = nullptr;
-        volatile int nPendingJobs = 0;
+        std::atomic<int>        nPendingJobs{0};
+        std::atomic<int>        nQueuedJobs{0};
+        std::atomic<int>        nWaitingForJobsCompletion{0};
+
+        // Snapshots of the list of threads, readable without locking while
+        // Setup() adds threads. Older snapshots are kept until destruction.
+        std::vector<std::unique_ptr<std::vector<CPLWorkerThread*>>>
+                                m_apoThreadSnapshots{};
+        std::atomic<const std::vector<CPLWorkerThread*>*>
+                                m_papoThreads{nullptr};
+        std::atomic<unsigned>   m_nNextQueue{0};
+
+        std::vector<CPLWorkerThread*> apoWaitingWorkerThreads{};
+        std::atomic<int>        nWaitingWorkerThreads{0};
 
-        CPLList* psWaitingWorkerThreadsList = nullptr;
-        int nWaitingWorkerThreads = 0;
+        // Worker threads running jobs while they wait, see WaitUntil()
+        std::atomic<int>        nHelpingWorkerThreads{0};
 
         static void WorkerThreadFunction(void* user_data);
 
         void DeclareJobFinished();
-        CPLWorkerThreadJob* GetNextJob(CPLWorkerThread* psWorkerThread);
+        bool GetNextJob(CPLWorkerThread* psWorkerThread,
+                        CPLWorkerThreadJob& sJob);
+        bool TryGetJob(CPLWorkerThread* psWorkerThread,
+                       CPLWorkerThreadJob& sJob);
+        CPLWorkerThread* GetQueueForNewJob();
+        void WakeUpWaitingWorkerThreads(size_t nMaxThreads);
+        void WakeUpJobWaiters();
+        void WakeUpHelpingWorkerThreads();
+
+        friend class CPLJobQueue;
+        void WaitUntil(const std::function<bool()>& IsDone);
 
     public:
         CPLWorkerThreadPool();
@@ -118,17 +152,28 @@ class CPL_DLL CPLWorkerThreadPool
         int GetThreadCount() const { return static_cast<int>(aWT.size()); }
 };
 
+#ifndef DOXYGEN_SKIP
+struct CPLJobQueueTask;
+#endif
+
+/** Handle to a task submitted with CPLJobQueue::SubmitTask()
+ * @since GDAL 3.4
+ */
+typedef std::shared_ptr<CPLJobQueueTask> CPLJobTaskHandle;
+
 /** Job queue */
 class CPL_DLL CPLJobQueue
 {
         CPL_DISALLOW_COPY_ASSIGN(CPLJobQueue)
         CPLWorkerThreadPool* m_poPool = nullptr;
         std::mutex m_mutex{};
-        std::condition_variable m_cv{};
         int m_nPendingJobs = 0;
 
         static void JobQueueFunction(void*);
+        static void TaskFunction(void*);
         void DeclareJobFinished();
+        bool SubmitReadyTask(const CPLJobTaskHandle& hTask);
+        void DeclareTaskFinished(const CPLJobTaskHandle& hTask);
 
 //! @cond Doxygen_Suppress
 protected:
@@ -144,6 +189,13 @@ public:
 
         bool SubmitJob(CPLThreadFunc pfnFunc, void* pData);
         void WaitCompletion(int nMaxRemainingJobs = 0);
+
+        CPLJobTaskHandle SubmitTask(
+            CPLThreadFunc pfnFunc, void* pData,
+            const std::vector<CPLJobTaskHandle>& ahDependencies =
+                std::vector<CPLJobTaskHandle>());
+        bool IsTaskFinished(const CPLJobTaskHandle& hTask);
+        void WaitTask(const CPLJobTaskHandle& hTask);
 };
 
 #endif // CPL_WORKER_THREAD_POOL_H_INCLUDED_